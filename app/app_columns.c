@@ -0,0 +1,225 @@
+/*
+File:   app_columns.c
+Date:   10\16\2026
+Description:
+	** Holds the HistoryColumns, a struct-of-arrays copy of the few HistoryItem fields the
+	** history list filters and sorts on (verb, status, latency, size and host), and the
+	** HistoryView that's built from them. Filtering a million items is a scan over a
+	** couple of small arrays rather than a walk over every (large) HistoryItem, and
+	** sorting is a radix sort of the matching indices by a single u64 column
+*/
+
+void InitHistoryColumns(Arena* arena, HistoryColumns* columns)
+{
+	NotNull(arena);
+	NotNull(columns);
+	ClearPointer(columns);
+	columns->arena = arena;
+	InitVarArray(Str8, &columns->hosts, arena);
+	InitHistoryLookup(arena, &columns->hostLookup);
+}
+
+// Forgets every row and host but keeps the arrays, for when history gets cleared
+void ClearHistoryColumns(HistoryColumns* columns)
+{
+	NotNull(columns);
+	columns->count = 0;
+	VarArrayLoop(&columns->hosts, hIndex)
+	{
+		VarArrayLoopGet(Str8, host, &columns->hosts, hIndex);
+		FreeStr8(columns->arena, host);
+	}
+	VarArrayClear(&columns->hosts);
+	FreeHistoryLookup(&columns->hostLookup);
+}
+
+void* GrowHistoryColumn(Arena* arena, void* column, uxx elementSize, uxx count, uxx oldCapacity, uxx newCapacity)
+{
+	void* result = AllocMem(arena, elementSize * newCapacity);
+	NotNull(result);
+	if (count > 0) { MyMemCopy(result, column, elementSize * count); }
+	if (column != nullptr) { FreeMem(arena, column, elementSize * oldCapacity); }
+	return result;
+}
+
+void GrowHistoryColumns(HistoryColumns* columns, uxx minCapacity)
+{
+	if (columns->capacity >= minCapacity) { return; }
+	uxx newCapacity = (columns->capacity > 0) ? columns->capacity : HISTORY_LOOKUP_MIN_CAPACITY;
+	while (newCapacity < minCapacity) { newCapacity *= 2; }
+	columns->verbs = (u8*)GrowHistoryColumn(columns->arena, columns->verbs, sizeof(u8), columns->count, columns->capacity, newCapacity);
+	columns->statusCodes = (u16*)GrowHistoryColumn(columns->arena, columns->statusCodes, sizeof(u16), columns->count, columns->capacity, newCapacity);
+	columns->flags = (u8*)GrowHistoryColumn(columns->arena, columns->flags, sizeof(u8), columns->count, columns->capacity, newCapacity);
+	columns->latenciesUs = (u64*)GrowHistoryColumn(columns->arena, columns->latenciesUs, sizeof(u64), columns->count, columns->capacity, newCapacity);
+	columns->sizes = (u64*)GrowHistoryColumn(columns->arena, columns->sizes, sizeof(u64), columns->count, columns->capacity, newCapacity);
+	columns->hostIndices = (u32*)GrowHistoryColumn(columns->arena, columns->hostIndices, sizeof(u32), columns->count, columns->capacity, newCapacity);
+	columns->listRows = (u32*)GrowHistoryColumn(columns->arena, columns->listRows, sizeof(u32), columns->count, columns->capacity, newCapacity);
+	columns->capacity = newCapacity;
+}
+
+// Copies everything but the host, which can't change, out of the item. Called again when the item finishes
+void SetHistoryColumnsRow(HistoryColumns* columns, uxx historyIndex, const HistoryItem* item)
+{
+	NotNull(columns);
+	NotNull(item);
+	Assert(historyIndex < columns->count);
+	columns->verbs[historyIndex] = (u8)item->verb;
+	columns->statusCodes[historyIndex] = item->responseStatusCode;
+	columns->flags[historyIndex] = (item->finished ? HISTORY_COLUMN_FLAG_FINISHED : 0) | (item->failed ? HISTORY_COLUMN_FLAG_FAILED : 0);
+	columns->latenciesUs[historyIndex] = GetHistoryItemLatencyUs(item);
+	columns->sizes[historyIndex] = item->responseLength;
+}
+
+// Has to be called for every item added to app->history, in order. host is GetUrlHost of the item's url
+// (at startup, GetLoadedHistoryItemHost, which doesn't need the url)
+void AddHistoryColumnsRow(HistoryColumns* columns, uxx historyIndex, const HistoryItem* item, Str8 host)
+{
+	NotNull(columns);
+	Assert(historyIndex == columns->count);
+	GrowHistoryColumns(columns, columns->count + 1);
+	columns->count++;
+	columns->hostIndices[historyIndex] = InternHistoryHost(&columns->hosts, &columns->hostLookup, host, columns->arena);
+	columns->listRows[historyIndex] = HISTORY_COLUMN_NOT_LISTED;
+	SetHistoryColumnsRow(columns, historyIndex, item);
+}
+
+// 1xx and anything nonstandard only show up when the status filter is All
+HistoryStatusFilter GetHistoryStatusClass(u8 flags, u16 statusCode)
+{
+	if (!IsFlagSet(flags, HISTORY_COLUMN_FLAG_FINISHED)) { return HistoryStatusFilter_InProgress; }
+	if (IsFlagSet(flags, HISTORY_COLUMN_FLAG_FAILED)) { return HistoryStatusFilter_Failed; }
+	if (statusCode >= 200 && statusCode < 300) { return HistoryStatusFilter_2xx; }
+	if (statusCode >= 300 && statusCode < 400) { return HistoryStatusFilter_3xx; }
+	if (statusCode >= 400 && statusCode < 500) { return HistoryStatusFilter_4xx; }
+	if (statusCode >= 500 && statusCode < 600) { return HistoryStatusFilter_5xx; }
+	return HistoryStatusFilter_All;
+}
+
+void InitHistoryView(Arena* arena, HistoryView* view)
+{
+	NotNull(arena);
+	NotNull(view);
+	ClearPointer(view);
+	view->arena = arena;
+	view->verbFilter = HttpVerb_None;
+	InitVarArray(u32, &view->rows, arena);
+}
+
+// Takes a copy of the host filter, lowercased
+void SetHistoryViewHostFilter(HistoryView* view, Str8 hostFilter)
+{
+	NotNull(view);
+	FreeStr8(view->arena, &view->hostFilter);
+	view->hostFilter = AllocStr8(view->arena, hostFilter);
+	for (uxx cIndex = 0; cIndex < view->hostFilter.length; cIndex++) { view->hostFilter.chars[cIndex] = (char)ToHistorySearchChar((u8)view->hostFilter.chars[cIndex]); }
+	view->settingsChanged = true;
+}
+
+// Stable LSD radix sort of indices by keys (ascending), a byte at a time. Passes where every key has the same byte are
+// skipped, so latencies and sizes (which rarely use the top bytes) only take a few. Returns whichever buffer ended up sorted
+u32* RadixSortHistoryRows(Arena* arena, uxx count, u64* keys, u32* indices)
+{
+	u64* tempKeys = AllocArray(u64, arena, count);
+	u32* tempIndices = AllocArray(u32, arena, count);
+	NotNull(tempKeys);
+	NotNull(tempIndices);
+	uxx bucketStarts[256];
+	for (u32 shift = 0; shift < 64; shift += 8)
+	{
+		MyMemSet(&bucketStarts[0], 0x00, sizeof(bucketStarts));
+		for (uxx kIndex = 0; kIndex < count; kIndex++) { bucketStarts[(keys[kIndex] >> shift) & 0xFF]++; }
+		if (bucketStarts[(keys[0] >> shift) & 0xFF] == count) { continue; }
+		
+		uxx offset = 0;
+		for (uxx bIndex = 0; bIndex < ArrayCount(bucketStarts); bIndex++)
+		{
+			uxx bucketSize = bucketStarts[bIndex];
+			bucketStarts[bIndex] = offset;
+			offset += bucketSize;
+		}
+		for (uxx kIndex = 0; kIndex < count; kIndex++)
+		{
+			uxx destIndex = bucketStarts[(keys[kIndex] >> shift) & 0xFF]++;
+			tempKeys[destIndex] = keys[kIndex];
+			tempIndices[destIndex] = indices[kIndex];
+		}
+		u64* swapKeys = keys; keys = tempKeys; tempKeys = swapKeys;
+		u32* swapIndices = indices; indices = tempIndices; tempIndices = swapIndices;
+	}
+	return indices;
+}
+
+// Rebuilds rows (and listRows) from the columns. search->results has to be up to date, it's used as the starting set
+// when there's a query. Largest keys come first when sorting, with ties (and the Newest sort) listed newest first
+void BuildHistoryView(HistoryView* view, HistoryColumns* columns, const HistorySearch* search)
+{
+	NotNull(view);
+	NotNull(columns);
+	NotNull(search);
+	bool searchActive = (search->query.length > 0);
+	view->isActive = (searchActive || view->statusFilter != HistoryStatusFilter_All || view->verbFilter != HttpVerb_None ||
+		view->hostFilter.length > 0 || view->sort != HistorySort_Newest);
+	VarArrayClear(&view->rows);
+	if (!view->isActive) { return; }
+	TracyCZoneN(Zone_Func, "BuildHistoryView", true);
+	ScratchBegin(scratch);
+	
+	//NOTE: There are far fewer hosts than rows, so the substring check happens once per host
+	bool* hostMatches = nullptr;
+	if (view->hostFilter.length > 0)
+	{
+		hostMatches = AllocArray(bool, scratch, columns->hosts.length + 1);
+		NotNull(hostMatches);
+		VarArrayLoop(&columns->hosts, hIndex)
+		{
+			VarArrayLoopGet(Str8, host, &columns->hosts, hIndex);
+			hostMatches[hIndex] = HistoryTextContains(*host, view->hostFilter);
+		}
+	}
+	
+	uxx numCandidates = searchActive ? search->results.length : columns->count;
+	u32* matches = AllocArray(u32, scratch, numCandidates + 1);
+	NotNull(matches);
+	uxx numMatches = 0;
+	for (uxx cIndex = 0; cIndex < numCandidates; cIndex++)
+	{
+		uxx historyIndex = searchActive ? *VarArrayGet(uxx, &search->results, cIndex) : cIndex;
+		if (historyIndex >= columns->count) { continue; }
+		if (view->statusFilter != HistoryStatusFilter_All && GetHistoryStatusClass(columns->flags[historyIndex], columns->statusCodes[historyIndex]) != view->statusFilter) { continue; }
+		if (view->verbFilter != HttpVerb_None && columns->verbs[historyIndex] != (u8)view->verbFilter) { continue; }
+		if (hostMatches != nullptr && !hostMatches[columns->hostIndices[historyIndex]]) { continue; }
+		matches[numMatches] = (u32)historyIndex;
+		numMatches++;
+	}
+	
+	u32* sortedMatches = matches;
+	if (view->sort != HistorySort_Newest && numMatches > 1)
+	{
+		u64* keys = AllocArray(u64, scratch, numMatches);
+		NotNull(keys);
+		for (uxx mIndex = 0; mIndex < numMatches; mIndex++)
+		{
+			if (view->sort == HistorySort_Slowest)
+			{
+				//NOTE: Items without timings go last
+				u64 latencyUs = columns->latenciesUs[matches[mIndex]];
+				keys[mIndex] = (latencyUs != HTTP_PHASE_UNKNOWN) ? latencyUs + 1 : 0;
+			}
+			else { keys[mIndex] = columns->sizes[matches[mIndex]]; }
+		}
+		sortedMatches = RadixSortHistoryRows(scratch, numMatches, keys, matches);
+	}
+	
+	MyMemSet(columns->listRows, 0xFF, sizeof(u32) * columns->count);
+	for (uxx rowIndex = 0; rowIndex < numMatches; rowIndex++)
+	{
+		u32 historyIndex = sortedMatches[numMatches-1 - rowIndex];
+		u32* rowSpace = VarArrayAdd(u32, &view->rows);
+		NotNull(rowSpace);
+		*rowSpace = historyIndex;
+		columns->listRows[historyIndex] = (u32)rowIndex;
+	}
+	
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+}
@@ -0,0 +1,339 @@
+/*
+File:   app_compress.c
+Date:   10\16\2026
+Description:
+	** Holds a small LZ77 block codec (the LZ4 block format: a token byte of literal and
+	** match lengths, the literals, then a 2 byte offset) and the HistoryCodec, a thread
+	** that compresses the HistoryBodies nobody is looking at and decompresses them again
+	** when an item that shares one gets selected. The format was picked for decode speed,
+	** a selected body comes back at memcpy-ish rates, and because both directions are
+	** simple enough to bounds check every read and write
+*/
+
+#define LZ_MIN_MATCH       4
+#define LZ_MAX_OFFSET      65535
+#define LZ_HASH_BITS       14
+#define LZ_HASH_SIZE       (1 << LZ_HASH_BITS) //entries in the compressor's hash table (u32 positions)
+#define LZ_END_LITERALS    5 //the last bytes of a block are always literals...
+#define LZ_MATCH_SEARCH_END 12 //...and no match starts this close to the end
+#define LZ_MAX_INPUT_SIZE  0xFFFFFFFF //positions in the hash table are u32
+
+// +--------------------------------------------------------------+
+// |                            Codec                             |
+// +--------------------------------------------------------------+
+u32 LzRead32(const u8* bytes)
+{
+	u32 result = 0;
+	MyMemCopy(&result, bytes, sizeof(u32));
+	return result;
+}
+
+// Lengths of 15 or more spill into extra bytes of 255 each and then the remainder
+void LzWriteExtraLength(u8* dst, uxx* writeIndex, uxx length)
+{
+	while (length >= 255) { dst[*writeIndex] = 255; (*writeIndex)++; length -= 255; }
+	dst[*writeIndex] = (u8)length;
+	(*writeIndex)++;
+}
+
+bool LzReadExtraLength(const u8* src, uxx srcSize, uxx* readIndex, uxx* lengthOut)
+{
+	while (true)
+	{
+		if (*readIndex >= srcSize) { return false; }
+		u8 value = src[*readIndex];
+		(*readIndex)++;
+		*lengthOut += value;
+		if (value != 255) { return true; }
+	}
+}
+
+// One sequence: numLiterals bytes copied as-is followed by a match of matchLength bytes offset bytes back.
+// The last sequence of a block has matchLength 0 and ends right after its literals
+bool LzWriteSequence(u8* dst, uxx dstCapacity, uxx* writeIndex, const u8* literals, uxx numLiterals, uxx offset, uxx matchLength)
+{
+	uxx maxSize = 1 + (numLiterals/255 + 1) + numLiterals + 2 + (matchLength/255 + 1);
+	if (maxSize > dstCapacity - *writeIndex) { return false; }
+	
+	uxx tokenIndex = *writeIndex;
+	(*writeIndex)++;
+	dst[tokenIndex] = (u8)(((numLiterals >= 15) ? 15 : numLiterals) << 4);
+	if (numLiterals >= 15) { LzWriteExtraLength(dst, writeIndex, numLiterals - 15); }
+	if (numLiterals > 0) { MyMemCopy(&dst[*writeIndex], literals, numLiterals); }
+	*writeIndex += numLiterals;
+	
+	if (matchLength > 0)
+	{
+		Assert(offset > 0 && offset <= LZ_MAX_OFFSET);
+		dst[(*writeIndex)++] = (u8)(offset & 0xFF);
+		dst[(*writeIndex)++] = (u8)((offset >> 8) & 0xFF);
+		uxx extraMatchLength = matchLength - LZ_MIN_MATCH;
+		dst[tokenIndex] |= (u8)((extraMatchLength >= 15) ? 15 : extraMatchLength);
+		if (extraMatchLength >= 15) { LzWriteExtraLength(dst, writeIndex, extraMatchLength - 15); }
+	}
+	return true;
+}
+
+// Greedy single pass compressor. Returns the compressed size, or 0 if it wouldn't fit in dstCapacity, which is how
+// callers ask for "only if it saves at least this much". hashTable must hold LZ_HASH_SIZE entries, its contents don't matter
+uxx LzCompress(const u8* src, uxx srcSize, u8* dst, uxx dstCapacity, u32* hashTable)
+{
+	NotNull(hashTable);
+	if (srcSize > LZ_MAX_INPUT_SIZE) { return 0; }
+	TracyCZoneN(Zone_Func, "LzCompress", true);
+	MyMemSet(hashTable, 0x00, sizeof(u32) * LZ_HASH_SIZE);
+	
+	uxx writeIndex = 0;
+	uxx anchor = 0;
+	if (srcSize > LZ_MATCH_SEARCH_END)
+	{
+		uxx matchLimit = srcSize - LZ_END_LITERALS;
+		uxx searchLimit = srcSize - LZ_MATCH_SEARCH_END;
+		uxx position = 0;
+		while (position < searchLimit)
+		{
+			u32 sequence = LzRead32(&src[position]);
+			u32 hashIndex = (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+			uxx candidate = hashTable[hashIndex];
+			hashTable[hashIndex] = (u32)position;
+			//NOTE: The table starts zeroed, so a "candidate" of 0 might just be an empty entry. Comparing the bytes sorts that out
+			if (candidate < position && position - candidate <= LZ_MAX_OFFSET && LzRead32(&src[candidate]) == sequence)
+			{
+				uxx matchLength = LZ_MIN_MATCH;
+				while (position + matchLength < matchLimit && src[candidate + matchLength] == src[position + matchLength]) { matchLength++; }
+				if (!LzWriteSequence(dst, dstCapacity, &writeIndex, &src[anchor], position - anchor, position - candidate, matchLength)) { TracyCZoneEnd(Zone_Func); return 0; }
+				position += matchLength;
+				anchor = position;
+			}
+			else { position++; }
+		}
+	}
+	
+	bool fits = LzWriteSequence(dst, dstCapacity, &writeIndex, &src[anchor], srcSize - anchor, 0, 0);
+	TracyCZoneEnd(Zone_Func);
+	return fits ? writeIndex : 0;
+}
+
+// dstSize must be exactly what was compressed. Every length and offset is checked, so corrupt input fails rather than reading or writing out of bounds
+bool LzDecompress(const u8* src, uxx srcSize, u8* dst, uxx dstSize)
+{
+	TracyCZoneN(Zone_Func, "LzDecompress", true);
+	uxx readIndex = 0;
+	uxx writeIndex = 0;
+	bool isValid = true;
+	while (isValid && readIndex < srcSize)
+	{
+		u8 token = src[readIndex];
+		readIndex++;
+		
+		uxx numLiterals = (token >> 4);
+		if (numLiterals == 15 && !LzReadExtraLength(src, srcSize, &readIndex, &numLiterals)) { isValid = false; break; }
+		if (numLiterals > srcSize - readIndex || numLiterals > dstSize - writeIndex) { isValid = false; break; }
+		if (numLiterals > 0) { MyMemCopy(&dst[writeIndex], &src[readIndex], numLiterals); }
+		readIndex += numLiterals;
+		writeIndex += numLiterals;
+		if (readIndex == srcSize) { break; } //the last sequence is only literals
+		
+		if (srcSize - readIndex < 2) { isValid = false; break; }
+		uxx offset = (uxx)src[readIndex] | ((uxx)src[readIndex+1] << 8);
+		readIndex += 2;
+		uxx matchLength = (token & 0x0F);
+		if (matchLength == 15 && !LzReadExtraLength(src, srcSize, &readIndex, &matchLength)) { isValid = false; break; }
+		matchLength += LZ_MIN_MATCH;
+		if (offset == 0 || offset > writeIndex || matchLength > dstSize - writeIndex) { isValid = false; break; }
+		
+		//NOTE: A match can overlap the bytes it's producing (offset < matchLength repeats a short pattern), those get copied a byte at a time
+		if (offset >= matchLength) { MyMemCopy(&dst[writeIndex], &dst[writeIndex - offset], matchLength); }
+		else { for (uxx bIndex = 0; bIndex < matchLength; bIndex++) { dst[writeIndex + bIndex] = dst[writeIndex - offset + bIndex]; } }
+		writeIndex += matchLength;
+	}
+	TracyCZoneEnd(Zone_Func);
+	return (isValid && writeIndex == dstSize);
+}
+
+// +--------------------------------------------------------------+
+// |                         Codec Thread                         |
+// +--------------------------------------------------------------+
+// void HistoryCodecThreadMain(void* contextPntr)
+SYS_THREAD_FUNC_DEF(HistoryCodecThreadMain)
+{
+	HistoryCodec* codec = (HistoryCodec*)contextPntr;
+	InitScratchArenasVirtual(Gigabytes(4));
+	#if TARGET_HAS_THREADING
+	OsSetThreadName(nullptr, StrLit("HistoryCodec"));
+	#endif
+	
+	while (!SysIsWorkerStopping(&codec->worker))
+	{
+		LockMutex(&codec->mutex, TIMEOUT_FOREVER);
+		bool hasWork = codec->hasWork;
+		UnlockMutex(&codec->mutex);
+		
+		if (!hasWork) { SysWorkerWait(&codec->worker, SYS_WAIT_FOREVER); continue; }
+		
+		//NOTE: The UI thread doesn't touch the job's input or output while hasWork is set, so they're safe to use without the lock
+		bool succeeded = false;
+		uxx outputSize = 0;
+		if (codec->jobIsCompress)
+		{
+			outputSize = LzCompress((const u8*)codec->jobInput.chars, codec->jobInput.length, (u8*)codec->jobOutput, codec->jobOutputCapacity, codec->hashTable);
+			succeeded = (outputSize > 0);
+		}
+		else
+		{
+			succeeded = LzDecompress((const u8*)codec->jobInput.chars, codec->jobInput.length, (u8*)codec->jobOutput, codec->jobOutputCapacity);
+			outputSize = codec->jobOutputCapacity;
+		}
+		
+		LockMutex(&codec->mutex, TIMEOUT_FOREVER);
+		codec->hasWork = false;
+		codec->isDone = true;
+		codec->succeeded = succeeded;
+		codec->jobOutputSize = outputSize;
+		UnlockMutex(&codec->mutex);
+	}
+}
+
+void InitHistoryCodec(Arena* arena, HistoryCodec* codec)
+{
+	NotNull(codec);
+	ClearPointer(codec);
+	codec->arena = arena;
+	codec->hashTable = AllocArray(u32, arena, LZ_HASH_SIZE);
+	NotNull(codec->hashTable);
+	InitVarArray(HistoryBody*, &codec->compressQueue, arena);
+	InitMutex(&codec->mutex);
+	bool startedThread = SysStartWorker(&codec->worker, HistoryCodecThreadMain, (void*)codec);
+	Assert(startedThread);
+}
+
+// Hands the body to the codec thread. Compressing only succeeds if it saves at least 1/HISTORY_COMPRESS_MIN_SAVINGS of the body
+void StartHistoryCodecJob(HistoryCodec* codec, HistoryBody* body, bool compress)
+{
+	NotNull(codec);
+	NotNull(body);
+	Assert(!codec->isBusy && !body->inCodec);
+	Assert(compress ? (body->chars.chars != nullptr && body->compressed.chars == nullptr) : (body->chars.chars == nullptr && body->compressed.chars != nullptr));
+	codec->isBusy = true;
+	codec->jobBody = body;
+	codec->jobIsCompress = compress;
+	codec->jobInput = compress ? body->chars : body->compressed;
+	codec->jobOutputCapacity = compress ? (body->length - body->length/HISTORY_COMPRESS_MIN_SAVINGS) : body->length;
+	codec->jobOutput = AllocArray(char, body->arena, codec->jobOutputCapacity);
+	NotNull(codec->jobOutput);
+	body->inCodec = true;
+	
+	LockMutex(&codec->mutex, TIMEOUT_FOREVER);
+	codec->hasWork = true;
+	UnlockMutex(&codec->mutex);
+	SysWakeWorker(&codec->worker);
+}
+
+// Drops the raw bytes of a body that has a compressed copy, once no item is showing it
+void TrimHistoryBody(HistoryBody* body)
+{
+	NotNull(body);
+	if (body->inCodec || body->numAttached > 0 || body->chars.chars == nullptr || body->compressed.chars == nullptr) { return; }
+	FreeArray(char, body->arena, body->chars.length, body->chars.chars);
+	body->chars = Str8_Empty;
+}
+
+// Applies a finished job to its body. A body that lost its last reference while in the codec only gets its memory freed now
+void FinishHistoryCodecJob(HistoryCodec* codec, bool succeeded, uxx outputSize)
+{
+	HistoryBody* body = codec->jobBody;
+	body->inCodec = false;
+	if (codec->jobIsCompress)
+	{
+		if (succeeded && body->refCount > 0)
+		{
+			char* compressedChars = AllocArray(char, body->arena, outputSize);
+			NotNull(compressedChars);
+			MyMemCopy(compressedChars, codec->jobOutput, outputSize);
+			body->compressed = MakeStr8(outputSize, compressedChars);
+			codec->numCompressed++;
+			//NOTE: Someone may have selected an item with this body while it was being compressed, then the raw bytes have to stay for now
+			TrimHistoryBody(body);
+		}
+		else if (!succeeded) { body->compressFailed = true; }
+		FreeArray(char, body->arena, codec->jobOutputCapacity, codec->jobOutput);
+	}
+	else
+	{
+		//NOTE: The compressed copy is kept, so when the item is deselected again the raw bytes can just be dropped
+		if (succeeded)
+		{
+			body->chars = MakeStr8(codec->jobOutputCapacity, codec->jobOutput);
+			codec->numDecompressed++;
+		}
+		else
+		{
+			PrintLine_E("Failed to decompress %llu byte history body", (u64)body->length);
+			body->decompressFailed = true;
+			FreeArray(char, body->arena, codec->jobOutputCapacity, codec->jobOutput);
+		}
+	}
+	if (body->refCount == 0)
+	{
+		if (body->chars.chars != nullptr) { FreeArray(char, body->arena, body->chars.length, body->chars.chars); }
+		if (body->compressed.chars != nullptr) { FreeArray(char, body->arena, body->compressed.length, body->compressed.chars); }
+		body->chars = Str8_Empty;
+		body->compressed = Str8_Empty;
+	}
+	codec->jobBody = nullptr;
+	codec->jobOutput = nullptr;
+	codec->jobOutputCapacity = 0;
+	codec->jobInput = Str8_Empty;
+}
+
+// Picks up the current job once it's done. With waitForCodec this blocks until then, which anything that's about
+// to free HistoryBodies (or the codec itself) needs to do first
+void PollHistoryCodec(HistoryCodec* codec, bool waitForCodec)
+{
+	NotNull(codec);
+	while (codec->isBusy)
+	{
+		LockMutex(&codec->mutex, TIMEOUT_FOREVER);
+		bool isDone = codec->isDone;
+		bool succeeded = codec->succeeded;
+		uxx outputSize = codec->jobOutputSize;
+		codec->isDone = false;
+		UnlockMutex(&codec->mutex);
+		
+		if (isDone)
+		{
+			codec->isBusy = false;
+			FinishHistoryCodecJob(codec, succeeded, outputSize);
+		}
+		else if (waitForCodec) { SysSleepMs(1); }
+		else { break; }
+	}
+}
+
+// Starts compressing the next queued body, if the codec is free. Queued bodies may have been looked at (or emptied)
+// since they were queued, so each one is checked again here and skipped if it no longer qualifies
+void StartNextHistoryCompression(HistoryCodec* codec)
+{
+	NotNull(codec);
+	while (!codec->isBusy && codec->compressQueueReadIndex < codec->compressQueue.length)
+	{
+		HistoryBody* body = *VarArrayGet(HistoryBody*, &codec->compressQueue, codec->compressQueueReadIndex);
+		codec->compressQueueReadIndex++;
+		if (codec->compressQueueReadIndex >= codec->compressQueue.length) { VarArrayClear(&codec->compressQueue); codec->compressQueueReadIndex = 0; }
+		body->isQueued = false;
+		if (body->refCount == 0 || body->numAttached > 0 || body->inCodec || body->compressFailed) { continue; }
+		if (body->chars.chars == nullptr || body->compressed.chars != nullptr || body->length < HISTORY_COMPRESS_MIN_SIZE) { continue; }
+		StartHistoryCodecJob(codec, body, true);
+	}
+}
+
+void FreeHistoryCodec(HistoryCodec* codec)
+{
+	NotNull(codec);
+	PollHistoryCodec(codec, true);
+	SysStopWorker(&codec->worker);
+	DestroyMutex(&codec->mutex);
+	FreeVarArray(&codec->compressQueue);
+	FreeArray(u32, codec->arena, LZ_HASH_SIZE, codec->hashTable);
+	ClearPointer(codec);
+}
@@ -336,34 +336,435 @@ Color32 GetColorForHttpStatusCode(u16 statusCode)
 	return MonokaiPurple;
 }
 
+Color32 GetColorForHttpPhase(HttpPhase phase)
+{
+	switch (phase)
+	{
+		case HttpPhase_Queue:    return MonokaiGray1;
+		case HttpPhase_Dns:      return MonokaiYellow;
+		case HttpPhase_Connect:  return MonokaiOrange;
+		case HttpPhase_Tls:      return MonokaiPurple;
+		case HttpPhase_Send:     return MonokaiBlue;
+		case HttpPhase_Wait:     return MonokaiGreen;
+		case HttpPhase_Download: return MonokaiWhite;
+		default: return MonokaiMagenta;
+	}
+}
+
 void FreeHistoryItem(HistoryItem* item)
 {
 	NotNull(item);
-	if (item->arena != nullptr)
+	//NOTE: Items that haven't been materialized don't own anything yet, their url points into the mapped history.txt
+	if (item->arena != nullptr && !item->needsMaterialize)
+	{
+		FreeHistoryResponse(item);
+		if (item->responseHeaders != nullptr) { FreeArray(char, item->arena, item->responseHeadersBlockSize, (char*)item->responseHeaders); }
+		if (item->dataBlock != nullptr) { FreeArray(char, item->arena, item->dataBlockSize, item->dataBlock); }
+	}
+	ClearPointer(item);
+}
+
+// Copies str to block[*writeIndex] and returns the copy. Empty strings come back as Str8_Empty, same as a field that was never set
+Str8 PackHistoryStr(char* block, uxx* writeIndex, Str8 str)
+{
+	if (str.length == 0) { return Str8_Empty; }
+	Str8 result = MakeStr8(str.length, &block[*writeIndex]);
+	MyMemCopy(result.chars, str.chars, str.length);
+	*writeIndex += str.length;
+	return result;
+}
+
+uxx GetHistoryPairsSize(uxx numPairs, const Str8Pair* pairs)
+{
+	uxx result = numPairs * sizeof(Str8Pair);
+	for (uxx pIndex = 0; pIndex < numPairs; pIndex++) { result += pairs[pIndex].key.length + pairs[pIndex].value.length; }
+	return result;
+}
+
+// Copies everything the request was made from into a single allocation from item->arena and points the item's fields at it.
+// The passed in strings can live anywhere (the UI, a scratch arena, the mapped history.txt), nothing needs to outlive this call
+void PackHistoryItemData(HistoryItem* item, Str8 url, Str8 uploadPath, Str8 downloadPath, uxx numHeaders, const Str8Pair* headers, uxx numContentItems, const Str8Pair* contentItems)
+{
+	NotNull(item);
+	NotNull(item->arena);
+	Assert(item->dataBlock == nullptr);
+	uxx blockSize = GetHistoryPairsSize(numHeaders, headers) + GetHistoryPairsSize(numContentItems, contentItems) + url.length + uploadPath.length + downloadPath.length;
+	item->numHeaders = numHeaders;
+	item->numContentItems = numContentItems;
+	if (blockSize == 0)
+	{
+		item->url = Str8_Empty; item->uploadPath = Str8_Empty; item->downloadPath = Str8_Empty;
+		item->headers = nullptr; item->contentItems = nullptr;
+		return;
+	}
+	
+	char* block = AllocArray(char, item->arena, blockSize);
+	NotNull(block);
+	uxx writeIndex = 0;
+	//NOTE: The arrays go first so they keep the allocation's alignment
+	item->headers = (numHeaders > 0) ? (Str8Pair*)&block[writeIndex] : nullptr;
+	writeIndex += numHeaders * sizeof(Str8Pair);
+	item->contentItems = (numContentItems > 0) ? (Str8Pair*)&block[writeIndex] : nullptr;
+	writeIndex += numContentItems * sizeof(Str8Pair);
+	item->url = PackHistoryStr(block, &writeIndex, url);
+	item->uploadPath = PackHistoryStr(block, &writeIndex, uploadPath);
+	item->downloadPath = PackHistoryStr(block, &writeIndex, downloadPath);
+	for (uxx hIndex = 0; hIndex < numHeaders; hIndex++)
+	{
+		item->headers[hIndex].key = PackHistoryStr(block, &writeIndex, headers[hIndex].key);
+		item->headers[hIndex].value = PackHistoryStr(block, &writeIndex, headers[hIndex].value);
+	}
+	for (uxx cIndex = 0; cIndex < numContentItems; cIndex++)
+	{
+		item->contentItems[cIndex].key = PackHistoryStr(block, &writeIndex, contentItems[cIndex].key);
+		item->contentItems[cIndex].value = PackHistoryStr(block, &writeIndex, contentItems[cIndex].value);
+	}
+	Assert(writeIndex == blockSize);
+	item->dataBlock = block;
+	item->dataBlockSize = blockSize;
+}
+
+// Same idea as PackHistoryItemData, the array and all of its strings in one allocation. Replaces whatever response headers the item had
+void SetHistoryResponseHeaders(HistoryItem* item, uxx numHeaders, const Str8Pair* headers)
+{
+	NotNull(item);
+	NotNull(item->arena);
+	if (item->responseHeaders != nullptr) { FreeArray(char, item->arena, item->responseHeadersBlockSize, (char*)item->responseHeaders); }
+	item->numResponseHeaders = 0;
+	item->responseHeaders = nullptr;
+	item->responseHeadersBlockSize = 0;
+	if (numHeaders == 0) { return; }
+	
+	uxx blockSize = GetHistoryPairsSize(numHeaders, headers);
+	char* block = AllocArray(char, item->arena, blockSize);
+	NotNull(block);
+	Str8Pair* newHeaders = (Str8Pair*)block;
+	uxx writeIndex = numHeaders * sizeof(Str8Pair);
+	for (uxx hIndex = 0; hIndex < numHeaders; hIndex++)
+	{
+		newHeaders[hIndex].key = PackHistoryStr(block, &writeIndex, headers[hIndex].key);
+		newHeaders[hIndex].value = PackHistoryStr(block, &writeIndex, headers[hIndex].value);
+	}
+	Assert(writeIndex == blockSize);
+	item->numResponseHeaders = numHeaders;
+	item->responseHeaders = newHeaders;
+	item->responseHeadersBlockSize = blockSize;
+}
+
+// Drops the body, its UiLargeText and the response headers. Only valid for items with a blob, LoadHistoryBlob
+// puts everything back the next time the item is selected. Returns how many bytes that actually gave back: a shared
+// body is only freed once its last item lets go of it, until then evicting a sharer only frees the item's own parts
+uxx EvictHistoryResponse(HistoryItem* item)
+{
+	NotNull(item);
+	Assert(item->finished && item->hasBlob);
+	const HistoryBody* body = item->sharedBody;
+	uxx bodyBytes = (body != nullptr) ? (body->chars.length + body->compressed.length) : 0;
+	uxx ownBytes = GetHistoryResponseMemoryUsage(item) - ((body != nullptr) ? bodyBytes / body->refCount : 0);
+	uxx responseLength = item->responseLength; //still needed to find the body in the blob store
+	FreeHistoryResponse(item);
+	item->responseLength = responseLength;
+	SetHistoryResponseHeaders(item, 0, nullptr);
+	item->blobLoaded = false;
+	bool freedBody = (body != nullptr && body->chars.chars == nullptr && body->compressed.chars == nullptr);
+	return ownBytes + (freedBody ? bodyBytes : 0);
+}
+
+// +--------------------------------------------------------------+
+// |                        History Lookup                        |
+// +--------------------------------------------------------------+
+void InitHistoryLookup(Arena* arena, HistoryLookup* lookup)
+{
+	NotNull(lookup);
+	ClearPointer(lookup);
+	lookup->arena = arena;
+}
+
+void FreeHistoryLookup(HistoryLookup* lookup)
+{
+	NotNull(lookup);
+	if (lookup->slots != nullptr) { FreeArray(HistoryLookupSlot, lookup->arena, lookup->capacity, lookup->slots); }
+	Arena* arena = lookup->arena;
+	ClearPointer(lookup);
+	lookup->arena = arena;
+}
+
+// Fibonacci hashing, ids and httpIds are mostly sequential and this spreads runs of them evenly over the table
+uxx GetHistoryLookupSlotIndex(const HistoryLookup* lookup, u64 key)
+{
+	return (uxx)((key * 0x9E3779B97F4A7C15ULL) >> (64 - lookup->capacityBits));
+}
+
+void HistoryLookupInsertSlot(HistoryLookup* lookup, u64 key, uxx value)
+{
+	uxx slotIndex = GetHistoryLookupSlotIndex(lookup, key);
+	while (lookup->slots[slotIndex].key != 0 && lookup->slots[slotIndex].key != key) { slotIndex = (slotIndex + 1) & (lookup->capacity - 1); }
+	if (lookup->slots[slotIndex].key == 0) { lookup->numEntries++; }
+	lookup->slots[slotIndex].key = key;
+	lookup->slots[slotIndex].value = value;
+}
+
+// Adding a key that's already there replaces its value
+void HistoryLookupAdd(HistoryLookup* lookup, u64 key, uxx value)
+{
+	NotNull(lookup);
+	if (key == 0) { return; }
+	if ((lookup->numEntries + 1) * 2 > lookup->capacity)
 	{
-		for (uxx hIndex = 0; hIndex < item->numHeaders; hIndex++)
+		uxx oldCapacity = lookup->capacity;
+		HistoryLookupSlot* oldSlots = lookup->slots;
+		lookup->capacity = (oldCapacity > 0) ? oldCapacity * 2 : HISTORY_LOOKUP_MIN_CAPACITY;
+		lookup->capacityBits = 0;
+		while (((uxx)1 << lookup->capacityBits) < lookup->capacity) { lookup->capacityBits++; }
+		lookup->slots = AllocArray(HistoryLookupSlot, lookup->arena, lookup->capacity);
+		NotNull(lookup->slots);
+		MyMemSet(lookup->slots, 0x00, sizeof(HistoryLookupSlot) * lookup->capacity);
+		lookup->numEntries = 0;
+		for (uxx sIndex = 0; sIndex < oldCapacity; sIndex++)
 		{
-			FreeStr8(item->arena, &item->headers[hIndex].key);
-			FreeStr8(item->arena, &item->headers[hIndex].value);
+			if (oldSlots[sIndex].key != 0) { HistoryLookupInsertSlot(lookup, oldSlots[sIndex].key, oldSlots[sIndex].value); }
 		}
-		if (item->headers != nullptr) { FreeArray(Str8Pair, item->arena, item->numHeaders, item->headers); }
-		for (uxx cIndex = 0; cIndex < item->numContentItems; cIndex++)
+		if (oldSlots != nullptr) { FreeArray(HistoryLookupSlot, lookup->arena, oldCapacity, oldSlots); }
+	}
+	HistoryLookupInsertSlot(lookup, key, value);
+}
+
+// Returns UINTXX_MAX if nothing was added with that key
+uxx HistoryLookupFind(const HistoryLookup* lookup, u64 key)
+{
+	NotNull(lookup);
+	if (key == 0 || lookup->numEntries == 0) { return UINTXX_MAX; }
+	uxx slotIndex = GetHistoryLookupSlotIndex(lookup, key);
+	while (lookup->slots[slotIndex].key != 0)
+	{
+		if (lookup->slots[slotIndex].key == key) { return lookup->slots[slotIndex].value; }
+		slotIndex = (slotIndex + 1) & (lookup->capacity - 1);
+	}
+	return UINTXX_MAX;
+}
+
+// Has to be called for every item added to app->history
+void AddHistoryLookups(uxx historyIndex)
+{
+	HistoryItem* historyItem = VarArrayGet(HistoryItem, &app->history, historyIndex);
+	HistoryLookupAdd(&app->historyById, historyItem->id, historyIndex);
+	HistoryLookupAdd(&app->historyByHttpId, historyItem->httpId, historyIndex);
+}
+
+// Items with the same verb and url are "runs" of the same request as far as HistoryItem.bodyChanged is concerned
+u64 GetHistoryRequestKey(const HistoryItem* item)
+{
+	u64 result = item->urlHash ^ ((u64)item->verb * 0x9E3779B97F4A7C15ULL);
+	return (result != 0) ? result : 1;
+}
+
+// "http://user@example.com:8080/path?query" -> "example.com:8080". Urls without a scheme are taken to start with the host
+Str8 GetUrlHost(Str8 url)
+{
+	uxx hostStart = 0;
+	for (uxx cIndex = 0; cIndex + 3 <= url.length; cIndex++)
+	{
+		if (url.chars[cIndex] == '/' || url.chars[cIndex] == '?' || url.chars[cIndex] == '#') { break; }
+		if (url.chars[cIndex] == ':' && url.chars[cIndex+1] == '/' && url.chars[cIndex+2] == '/') { hostStart = cIndex + 3; break; }
+	}
+	uxx hostEnd = hostStart;
+	while (hostEnd < url.length && url.chars[hostEnd] != '/' && url.chars[hostEnd] != '?' && url.chars[hostEnd] != '#')
+	{
+		if (url.chars[hostEnd] == '@') { hostStart = hostEnd + 1; }
+		hostEnd++;
+	}
+	return StrSlice(url, hostStart, hostEnd);
+}
+
+u64 GetHistoryHostKey(Str8 host)
+{
+	u64 result = UpdateHttpContentHash(HTTP_CONTENT_HASH_START, host);
+	return (result != 0) ? result : 1;
+}
+
+// Returns the index of host in hosts (Str8), adding it if it isn't there yet so every distinct host is stored once.
+// hostLookup maps GetHistoryHostKey to that index. New hosts are copied into copyArena, or kept as-is if it's nullptr
+u32 InternHistoryHost(VarArray* hosts, HistoryLookup* hostLookup, Str8 host, Arena* copyArena)
+{
+	u64 hostKey = GetHistoryHostKey(host);
+	uxx hostIndex = HistoryLookupFind(hostLookup, hostKey);
+	bool isCollision = false;
+	if (hostIndex != UINTXX_MAX)
+	{
+		if (StrExactEquals(*VarArrayGet(Str8, hosts, hostIndex), host)) { return (u32)hostIndex; }
+		//NOTE: A hash collision. The first host keeps the lookup entry and any others are found by scanning, which is fine since it basically never happens
+		isCollision = true;
+		VarArrayLoop(hosts, hIndex)
 		{
-			FreeStr8(item->arena, &item->contentItems[cIndex].key);
-			FreeStr8(item->arena, &item->contentItems[cIndex].value);
+			if (StrExactEquals(*VarArrayGet(Str8, hosts, hIndex), host)) { return (u32)hIndex; }
 		}
-		if (item->contentItems != nullptr) { FreeArray(Str8Pair, item->arena, item->numContentItems, item->contentItems); }
-		FreeStr8(item->arena, &item->response);
+	}
+	
+	hostIndex = hosts->length;
+	Str8* hostSpace = VarArrayAdd(Str8, hosts);
+	NotNull(hostSpace);
+	*hostSpace = (copyArena != nullptr) ? AllocStr8(copyArena, host) : host;
+	if (!isCollision) { HistoryLookupAdd(hostLookup, hostKey, hostIndex); }
+	return (u32)hostIndex;
+}
+
+// Compares a finished item's body with the last finished run of the same request, then makes this item the last run.
+// Items have to come through here in the order they finished
+void TrackHistoryRequestBody(uxx historyIndex)
+{
+	HistoryItem* historyItem = VarArrayGet(HistoryItem, &app->history, historyIndex);
+	if (historyItem->bodyHash == 0 || historyItem->failed) { return; }
+	u64 requestKey = GetHistoryRequestKey(historyItem);
+	uxx prevIndex = HistoryLookupFind(&app->historyByRequest, requestKey);
+	if (prevIndex != UINTXX_MAX)
+	{
+		HistoryItem* prevItem = VarArrayGet(HistoryItem, &app->history, prevIndex);
+		historyItem->bodyChanged = (prevItem->bodyHash != historyItem->bodyHash);
+	}
+	HistoryLookupAdd(&app->historyByRequest, requestKey, historyIndex);
+}
+
+// Called when the item finishes. Joins the streamed chunks, hashes the body and hands it to a HistoryBody,
+// or if one with the same bytes already exists, frees ours and points response at that one instead
+void FinishHistoryResponse(HistoryLookup* bodies, HistoryItem* item)
+{
+	NotNull(bodies);
+	NotNull(item);
+	Assert(item->finished);
+	Assert(item->sharedBody == nullptr);
+	TracyCZoneN(Zone_Func, "FinishHistoryResponse", true);
+	
+	//NOTE: A UiLargeText would point into the response we might be about to free, so it goes first
+	if (item->hasResponseLargeText)
+	{
 		FreeUiLargeText(&item->responseLargeText);
-		VarArrayLoop(&item->responseHeaders, hIndex)
+		item->hasResponseLargeText = false;
+	}
+	JoinHistoryResponseChunks(item);
+	
+	if (!IsEmptyStr(item->downloadPath)) { item->bodyHash = item->downloadHash; }
+	else
+	{
+		item->bodyHash = UpdateHttpContentHash(HTTP_CONTENT_HASH_START, item->response);
+		if (item->response.length > 0)
 		{
-			VarArrayLoopGet(Str8Pair, header, &item->responseHeaders, hIndex);
-			FreeStr8(item->arena, &header->key);
-			FreeStr8(item->arena, &header->value);
+			u64 bodyKey = (item->bodyHash != 0) ? item->bodyHash : 1;
+			uxx bodyPntr = HistoryLookupFind(bodies, bodyKey);
+			HistoryBody* body = (bodyPntr != UINTXX_MAX) ? (HistoryBody*)bodyPntr : nullptr;
+			if (body == nullptr)
+			{
+				body = AllocType(HistoryBody, item->arena);
+				NotNull(body);
+				ClearPointer(body);
+				body->arena = item->arena;
+				body->hash = bodyKey;
+				HistoryLookupAdd(bodies, bodyKey, (uxx)body);
+			}
+			
+			if (body->inCodec) { body = nullptr; } //rare enough that keeping our own copy is simpler than waiting on the HistoryCodec
+			else if (body->chars.chars == nullptr && body->compressed.chars == nullptr)
+			{
+				//NOTE: Nobody holds these bytes right now, so ours become the shared copy
+				Assert(body->refCount == 0);
+				body->chars = item->response;
+				body->length = item->response.length;
+				body->compressFailed = false;
+				body->decompressFailed = false;
+			}
+			else if (body->chars.chars == nullptr)
+			{
+				//NOTE: The body is only held compressed. Decompressing to compare is much cheaper than the request was, and if
+				// it matches our bytes just become its raw copy again (the compressed copy stays valid)
+				ScratchBegin(scratch);
+				char* decompressed = (body->length == item->response.length) ? AllocArray(char, scratch, body->length) : nullptr;
+				bool isSame = (decompressed != nullptr
+					&& LzDecompress((const u8*)body->compressed.chars, body->compressed.length, (u8*)decompressed, body->length)
+					&& MyMemEquals(decompressed, item->response.chars, body->length));
+				ScratchEnd(scratch);
+				if (isSame) { body->chars = item->response; }
+				else { body = nullptr; }
+			}
+			else if (StrExactEquals(body->chars, item->response))
+			{
+				FreeArray(char, item->arena, item->response.length, item->response.chars);
+				item->response = body->chars;
+			}
+			else { body = nullptr; } //a hash collision, this item keeps its own copy
+			
+			if (body != nullptr)
+			{
+				body->refCount++;
+				body->numAttached++;
+				item->sharedBody = body;
+			}
 		}
-		FreeVarArray(&item->responseHeaders);
 	}
-	ClearPointer(item);
+	
+	RebuildHistoryResponseLargeText(item);
+	TracyCZoneEnd(Zone_Func);
+}
+
+// Frees every HistoryBody in the lookup (and the lookup). Only called once no item points at them anymore (and the HistoryCodec is idle)
+void FreeHistoryBodies(HistoryLookup* bodies)
+{
+	NotNull(bodies);
+	for (uxx sIndex = 0; sIndex < bodies->capacity; sIndex++)
+	{
+		if (bodies->slots[sIndex].key == 0) { continue; }
+		HistoryBody* body = (HistoryBody*)bodies->slots[sIndex].value;
+		Assert(body->refCount == 0 && !body->inCodec);
+		if (body->chars.chars != nullptr) { FreeArray(char, body->arena, body->chars.length, body->chars.chars); }
+		if (body->compressed.chars != nullptr) { FreeArray(char, body->arena, body->compressed.length, body->compressed.chars); }
+		FreeType(HistoryBody, body->arena, body);
+	}
+	FreeHistoryLookup(bodies);
+}
+
+// Lets go of the item's view of its shared body (and the UiLargeText built on it) while keeping the reference, so the
+// body can be compressed once none of its items are showing it. Only finished items that aren't selected get detached
+void DetachHistoryResponse(HistoryItem* item)
+{
+	NotNull(item);
+	NotNull(item->sharedBody);
+	Assert(item->finished && !item->responseDetached);
+	if (item->hasResponseLargeText) { FreeUiLargeText(&item->responseLargeText); }
+	item->hasResponseLargeText = false;
+	item->responseLargeTextNumLines = 0;
+	item->response = Str8_Empty;
+	item->responseDetached = true;
+	Assert(item->sharedBody->numAttached > 0);
+	item->sharedBody->numAttached--;
+	TrimHistoryBody(item->sharedBody);
+}
+
+// Called every frame for the selected item. If its body is only held compressed this starts decompressing it (once the
+// HistoryCodec is free) and the item stays detached until that's done, so it usually takes a frame or two
+void AttachHistoryResponse(HistoryCodec* codec, HistoryItem* item)
+{
+	NotNull(codec);
+	NotNull(item);
+	if (!item->responseDetached) { return; }
+	HistoryBody* body = item->sharedBody;
+	if (body->chars.chars == nullptr)
+	{
+		if (body->decompressFailed)
+		{
+			//NOTE: Evicting sends a saved item back to the HistoryBlobStore for its body, otherwise all we can do is say so
+			if (item->hasBlob) { EvictHistoryResponse(item); }
+			else
+			{
+				SetHistoryResponse(item, StrLit("The response couldn't be decompressed..."));
+				RebuildHistoryResponseLargeText(item);
+			}
+		}
+		else if (!body->inCodec && !codec->isBusy) { StartHistoryCodecJob(codec, body, false); }
+		return;
+	}
+	
+	item->response = body->chars;
+	item->responseDetached = false;
+	body->numAttached++;
+	RebuildHistoryResponseLargeText(item);
 }
 
 #endif //BUILD_WITH_SOKOL_GFX
\ No newline at end of file
@@ -0,0 +1,208 @@
+/*
+File:   app_load_test.c
+Date:   10\16\2026
+Description:
+	** Runs a single request (copied from a HistoryItem) at a constant arrival rate for
+	** a fixed duration. Every request's send time is decided up front (start + n/rate)
+	** and handed to the HttpService with notBeforeUs, so the schedule never waits on
+	** responses (open model) and latency is measured from when a request *should* have
+	** been sent. Responses are discarded on the service thread, we only keep timings
+*/
+
+#if BUILD_WITH_HTTP
+
+void InitLoadTest(Arena* arena, LoadTest* test)
+{
+	NotNull(arena);
+	NotNull(test);
+	ClearPointer(test);
+	test->arena = arena;
+	InitLatencyHistogram(arena, LATENCY_HISTOGRAM_DEFAULT_HIGHEST, &test->latency);
+	InitLatencyHistogram(arena, LATENCY_HISTOGRAM_DEFAULT_HIGHEST, &test->serviceTime);
+}
+
+void FreeLoadTestRequest(LoadTest* test)
+{
+	NotNull(test);
+	if (test->url.chars != nullptr) { FreeStr8(test->arena, &test->url); }
+	for (uxx hIndex = 0; hIndex < test->numHeaders; hIndex++)
+	{
+		FreeStr8(test->arena, &test->headers[hIndex].key);
+		FreeStr8(test->arena, &test->headers[hIndex].value);
+	}
+	if (test->headers != nullptr) { FreeArray(Str8Pair, test->arena, test->numHeaders, test->headers); }
+	for (uxx cIndex = 0; cIndex < test->numContentItems; cIndex++)
+	{
+		FreeStr8(test->arena, &test->contentItems[cIndex].key);
+		FreeStr8(test->arena, &test->contentItems[cIndex].value);
+	}
+	if (test->contentItems != nullptr) { FreeArray(Str8Pair, test->arena, test->numContentItems, test->contentItems); }
+	if (test->uploadPath.chars != nullptr) { FreeStr8(test->arena, &test->uploadPath); }
+	test->url = Str8_Empty;
+	test->numHeaders = 0;
+	test->headers = nullptr;
+	test->numContentItems = 0;
+	test->contentItems = nullptr;
+	test->uploadPath = Str8_Empty;
+}
+
+bool IsLoadTestActive(const LoadTest* test)
+{
+	return (test->state == LoadTestState_Running || test->state == LoadTestState_Draining);
+}
+
+u64 GetLoadTestIntendedTimeUs(const LoadTest* test, u64 sequenceIndex)
+{
+	return test->startTimeUs + (u64)(((r64)sequenceIndex * 1000000.0) / test->requestsPerSecond);
+}
+
+void StartLoadTest(LoadTest* test, const HistoryItem* source, r64 requestsPerSecond, r64 durationSeconds)
+{
+	NotNull(test);
+	NotNull(source);
+	Assert(!IsLoadTestActive(test));
+	Assert(requestsPerSecond > 0.0 && durationSeconds > 0.0);
+	
+	FreeLoadTestRequest(test);
+	test->sourceHistoryId = source->id;
+	test->verb = source->verb;
+	test->url = AllocStr8(test->arena, source->url);
+	if (source->numHeaders > 0)
+	{
+		test->numHeaders = source->numHeaders;
+		test->headers = AllocArray(Str8Pair, test->arena, source->numHeaders);
+		NotNull(test->headers);
+		for (uxx hIndex = 0; hIndex < source->numHeaders; hIndex++)
+		{
+			test->headers[hIndex].key = AllocStr8(test->arena, source->headers[hIndex].key);
+			test->headers[hIndex].value = AllocStr8(test->arena, source->headers[hIndex].value);
+		}
+	}
+	if (source->numContentItems > 0)
+	{
+		test->numContentItems = source->numContentItems;
+		test->contentItems = AllocArray(Str8Pair, test->arena, source->numContentItems);
+		NotNull(test->contentItems);
+		for (uxx cIndex = 0; cIndex < source->numContentItems; cIndex++)
+		{
+			test->contentItems[cIndex].key = AllocStr8(test->arena, source->contentItems[cIndex].key);
+			test->contentItems[cIndex].value = AllocStr8(test->arena, source->contentItems[cIndex].value);
+		}
+	}
+	if (!IsEmptyStr(source->uploadPath)) { test->uploadPath = AllocStr8(test->arena, source->uploadPath); }
+	
+	//NOTE: Bumping the run index means completions from a previous (stopped) run that are still trickling in get ignored
+	test->runIndex = (test->runIndex + 1) & LOAD_TEST_RUN_MASK;
+	test->requestsPerSecond = requestsPerSecond;
+	test->totalRequests = (u64)(requestsPerSecond * durationSeconds);
+	if (test->totalRequests < 1) { test->totalRequests = 1; }
+	if (test->totalRequests > LOAD_TEST_SEQUENCE_MASK) { test->totalRequests = LOAD_TEST_SEQUENCE_MASK; }
+	test->numSent = 0;
+	test->numCompleted = 0;
+	test->numFailed = 0;
+	test->numNon2xx = 0;
+	test->maxInFlight = 0;
+	test->totalResponseBytes = 0;
+	ResetLatencyHistogram(&test->latency);
+	ResetLatencyHistogram(&test->serviceTime);
+	test->startTimeUs = SysGetTimeUs() + LOAD_TEST_SCHEDULE_AHEAD;
+	test->endTimeUs = 0;
+	test->state = LoadTestState_Running;
+	PrintLine_D("Starting load test: %s \"%.*s\" at %g req/s for %llu request%s",
+		GetHttpVerbStr(test->verb), StrPrint(test->url),
+		test->requestsPerSecond,
+		test->totalRequests, Plural(test->totalRequests, "s")
+	);
+}
+
+// Requests that were already handed to the HttpService will still go out, we just stop scheduling new ones
+void StopLoadTest(LoadTest* test)
+{
+	NotNull(test);
+	if (test->state != LoadTestState_Running) { return; }
+	test->totalRequests = test->numSent;
+	test->state = LoadTestState_Draining;
+}
+
+void FinishLoadTest(LoadTest* test, u64 nowUs)
+{
+	test->endTimeUs = nowUs;
+	test->state = LoadTestState_Finished;
+	PrintLine_D("Load test finished: %llu/%llu completed, %llu failed, p50=%.3fms p99=%.3fms max=%.3fms",
+		test->numCompleted, test->numSent, test->numFailed,
+		GetLatencyPercentile(&test->latency, 50.0) / 1000.0,
+		GetLatencyPercentile(&test->latency, 99.0) / 1000.0,
+		test->latency.maxValue / 1000.0
+	);
+}
+
+void UpdateLoadTest(LoadTest* test)
+{
+	NotNull(test);
+	if (!IsLoadTestActive(test)) { return; }
+	TracyCZoneN(Zone_Func, "UpdateLoadTest", true);
+	u64 nowUs = SysGetTimeUs();
+	
+	if (test->state == LoadTestState_Running)
+	{
+		HttpRequestArgs args = ZEROED;
+		args.verb = test->verb;
+		args.urlStr = test->url;
+		args.numHeaders = test->numHeaders;
+		args.headers = test->headers;
+		args.contentEncoding = MimeType_FormUrlEncoded;
+		args.numContentItems = test->numContentItems;
+		args.contentItems = test->contentItems;
+		HttpRequestOptions options = ZEROED;
+		options.discardResponseBytes = true;
+		options.uploadPath = test->uploadPath; //every request maps the file on its own, the page cache means it's only read from disk once
+		
+		//NOTE: We only run once a frame, so everything due within the next LOAD_TEST_SCHEDULE_AHEAD gets
+		// queued now and the HttpService thread releases each one at its exact notBeforeUs
+		while (test->numSent < test->totalRequests)
+		{
+			u64 intendedTimeUs = GetLoadTestIntendedTimeUs(test, test->numSent);
+			if (intendedTimeUs > nowUs + LOAD_TEST_SCHEDULE_AHEAD) { break; }
+			args.contextId = LOAD_TEST_CONTEXT_FLAG | (test->runIndex << LOAD_TEST_RUN_SHIFT) | test->numSent;
+			options.notBeforeUs = intendedTimeUs;
+			platform->MakeHttpRequest(&args, &options);
+			test->numSent++;
+		}
+		u64 numInFlight = test->numSent - test->numCompleted;
+		if (numInFlight > test->maxInFlight) { test->maxInFlight = numInFlight; }
+		if (test->numSent >= test->totalRequests) { test->state = LoadTestState_Draining; }
+	}
+	
+	if (test->state == LoadTestState_Draining)
+	{
+		u64 lastIntendedTimeUs = (test->numSent > 0) ? GetLoadTestIntendedTimeUs(test, test->numSent-1) : test->startTimeUs;
+		if (test->numCompleted >= test->numSent) { FinishLoadTest(test, nowUs); }
+		else if (nowUs > lastIntendedTimeUs && nowUs - lastIntendedTimeUs >= LOAD_TEST_DRAIN_TIMEOUT)
+		{
+			PrintLine_W("Gave up waiting on %llu load test request%s", test->numSent - test->numCompleted, Plural(test->numSent - test->numCompleted, "s"));
+			FinishLoadTest(test, nowUs);
+		}
+	}
+	TracyCZoneEnd(Zone_Func);
+}
+
+void HandleLoadTestEvent(LoadTest* test, const HttpEvent* event)
+{
+	NotNull(test);
+	NotNull(event);
+	Assert(IsFlagSet(event->contextId, LOAD_TEST_CONTEXT_FLAG));
+	u64 runIndex = (event->contextId >> LOAD_TEST_RUN_SHIFT) & LOAD_TEST_RUN_MASK;
+	u64 sequenceIndex = (event->contextId & LOAD_TEST_SEQUENCE_MASK);
+	if (runIndex != test->runIndex || test->state == LoadTestState_None) { return; }
+	if (event->type != HttpEventType_Finished) { return; } //we ask for discardResponseBytes so we shouldn't get Data events anyway
+	
+	u64 intendedTimeUs = GetLoadTestIntendedTimeUs(test, sequenceIndex);
+	RecordLatency(&test->latency, (event->timeUs > intendedTimeUs) ? (event->timeUs - intendedTimeUs) : 0);
+	RecordLatency(&test->serviceTime, (event->timeUs > event->timings.startUs) ? (event->timeUs - event->timings.startUs) : 0);
+	test->numCompleted++;
+	test->totalResponseBytes += event->totalBytes;
+	if (event->error != Result_None && event->error != Result_Success) { test->numFailed++; }
+	else if (event->statusCode < 200 || event->statusCode >= 300) { test->numNon2xx++; }
+}
+
+#endif //BUILD_WITH_HTTP
@@ -28,6 +28,8 @@ Description:
 // +--------------------------------------------------------------+
 // |                         Header Files                         |
 // +--------------------------------------------------------------+
+#include "sys_helpers.h"
+#include "latency_histogram.h"
 #include "platform_interface.h"
 #include "app_resources.h"
 #include "app_main.h"
@@ -51,8 +53,14 @@ static Arena* stdHeap = nullptr;
 // |                         Source Files                         |
 // +--------------------------------------------------------------+
 #include "app_resources.c"
+#include "app_response.c"
+#include "app_compress.c"
 #include "app_helpers.c"
+#include "app_virtual_list.c"
 #include "app_save.c"
+#include "app_search.c"
+#include "app_columns.c"
+#include "app_load_test.c"
 
 // +==============================+
 // |           DllMain            |
@@ -150,18 +158,52 @@ EXPORT_FUNC APP_INIT_DEF(AppInit)
 	InitUiListView(stdHeap, StrLit("ContentListView"), &app->contentListView);
 	InitUiTextbox(stdHeap, StrLit("ContentKeyTextbox"), StrLit(""), &app->contentKeyTextbox);
 	InitUiTextbox(stdHeap, StrLit("ContentValueTextbox"), StrLit(""), &app->contentValueTextbox);
-	InitUiListView(stdHeap, StrLit("HistoryListView"), &app->historyListView);
-	app->historyListView.itemPaddingLeft = 0; app->historyListView.itemPaddingRight = 0;
-	app->historyListView.itemPaddingTop = 0; app->historyListView.itemPaddingBottom = 0;
+	InitVirtualListView(stdHeap, StrLit("HistoryListView"), &app->historyListView);
+	app->selectedHistoryIndex = UINTXX_MAX;
+	InitUiTextbox(stdHeap, StrLit("HistorySearchTextbox"), StrLit(""), &app->historySearchTextbox);
+	InitUiTextbox(stdHeap, StrLit("HistoryHostTextbox"), StrLit(""), &app->historyHostTextbox);
 	
 	InitUiLargeTextView(stdHeap, StrLit("ResponseTextView"), &app->responseTextView);
 	app->responseTextView.wordWrapEnabled = true;
+	InitVirtualListView(stdHeap, StrLit("ResponsePreviewList"), &app->responsePreviewList);
+	app->responsePreviewList.selectionDisabled = true;
+	
+	InitUiTextbox(stdHeap, StrLit("LoadRateTextbox"), StrLit(LOAD_TEST_DEFAULT_RATE), &app->loadRateTextbox);
+	InitUiTextbox(stdHeap, StrLit("LoadDurationTextbox"), StrLit(LOAD_TEST_DEFAULT_DURATION), &app->loadDurationTextbox);
+	InitUiTextbox(stdHeap, StrLit("ConnectTimeoutTextbox"), StrLit(HTTP_DEFAULT_CONNECT_TIMEOUT), &app->connectTimeoutTextbox);
+	InitUiTextbox(stdHeap, StrLit("FirstByteTimeoutTextbox"), StrLit(HTTP_DEFAULT_FIRST_BYTE_TIMEOUT), &app->firstByteTimeoutTextbox);
+	InitUiTextbox(stdHeap, StrLit("IdleTimeoutTextbox"), StrLit(HTTP_DEFAULT_IDLE_TIMEOUT), &app->idleTimeoutTextbox);
+	InitUiTextbox(stdHeap, StrLit("TotalTimeoutTextbox"), StrLit(HTTP_DEFAULT_TOTAL_TIMEOUT), &app->totalTimeoutTextbox);
 	
 	InitVarArray(Str8Pair, &app->httpHeaders, stdHeap);
 	InitVarArray(Str8Pair, &app->httpContent, stdHeap);
 	InitVarArray(HistoryItem, &app->history, stdHeap);
+	InitHistoryLookup(stdHeap, &app->historyById);
+	InitHistoryLookup(stdHeap, &app->historyByHttpId);
+	InitHistoryLookup(stdHeap, &app->historyBodies);
+	InitHistoryLookup(stdHeap, &app->historyByRequest);
 	app->nextHistoryId = 1;
-	LoadHistory(stdHeap, &app->history, &app->nextHistoryId);
+	InitHistoryJournal(stdHeap, &app->historyJournal);
+	InitHistoryBlobStore(stdHeap, &app->historyBlobs);
+	InitHistoryWriter(stdHeap, &app->historyWriter);
+	InitHistoryCodec(stdHeap, &app->historyCodec);
+	InitHistorySearch(stdHeap, &app->historySearch);
+	InitHistoryColumns(stdHeap, &app->historyColumns);
+	InitHistoryView(stdHeap, &app->historyView);
+	app->historyMemoryBudget = inPlatformInfo->historyMemoryBudget;
+	LoadHistory(stdHeap, &app->historyJournal, &app->history, &app->nextHistoryId);
+	VarArrayLoop(&app->history, hIndex)
+	{
+		AddHistoryLookups(hIndex);
+		TrackHistoryRequestBody(hIndex);
+		VarArrayLoopGet(HistoryItem, historyItem, &app->history, hIndex);
+		AddHistoryColumnsRow(&app->historyColumns, hIndex, historyItem, GetLoadedHistoryItemHost(&app->historyJournal, historyItem));
+	}
+	FreeHistoryIndexHosts(&app->historyJournal);
+	app->historySearch.numToBackfill = app->history.length;
+	#if BUILD_WITH_HTTP
+	InitLoadTest(stdHeap, &app->loadTest);
+	#endif
 	
 	app->httpVerb = HttpVerb_POST;
 	app->currentResultTab = ResultTab_Raw;
@@ -247,15 +289,94 @@ UI_LIST_VIEW_ITEM_RENDER_DEF(RenderContentItem)
 }
 
 // +==============================+
-// |      RenderHistoryItem       |
+// |      GetNumHistoryRows       |
+// +==============================+
+// While a search, filter or sort is active the history list only shows app->historyView.rows, otherwise all of history newest first
+uxx GetNumHistoryRows()
+{
+	return app->historyView.isActive ? app->historyView.rows.length : app->history.length;
+}
+
+// Row in the history list to index in app->history
+uxx GetHistoryIndexForRow(uxx row)
+{
+	Assert(row < GetNumHistoryRows());
+	if (app->historyView.isActive) { return (uxx)*VarArrayGet(u32, &app->historyView.rows, row); }
+	return (app->history.length-1) - row;
+}
+
+// Returns UINTXX_MAX when the item isn't in the list (i.e. it doesn't match the search or filters)
+uxx FindHistoryRowForIndex(uxx historyIndex)
+{
+	if (historyIndex >= app->history.length) { return UINTXX_MAX; }
+	if (!app->historyView.isActive) { return (app->history.length-1) - historyIndex; }
+	if (historyIndex >= app->historyColumns.count) { return UINTXX_MAX; }
+	u32 row = app->historyColumns.listRows[historyIndex];
+	if (row == HISTORY_COLUMN_NOT_LISTED || row >= app->historyView.rows.length) { return UINTXX_MAX; }
+	return (uxx)row;
+}
+
+//NOTE: The selection is kept as a history index rather than a row, rows move whenever an item is added or the search changes
+HistoryItem* GetSelectedHistoryItem(uxx* indexOut)
+{
+	if (app->selectedHistoryIndex >= app->history.length) { return nullptr; }
+	if (indexOut != nullptr) { *indexOut = app->selectedHistoryIndex; }
+	return VarArrayGet(HistoryItem, &app->history, app->selectedHistoryIndex);
+}
+
+// +==============================+
+// |      RefreshHistoryView      |
+// +==============================+
+// Rebuilds the search results and the view if anything changed. Changes to the search or filters rebuild right away, new or
+// finished items only once every HISTORY_VIEW_REBUILD_INTERVAL so a burst of requests doesn't rebuild every frame.
+// If the selected item isn't in the list anymore nothing is selected
+void RefreshHistoryView(bool force)
+{
+	HistoryView* view = &app->historyView;
+	bool historyChanged = (view->historyChanged || app->historySearch.resultsDirty);
+	if (!force && !view->settingsChanged && !historyChanged) { return; }
+	if (!force && !view->settingsChanged && TimeSinceBy(appIn->programTime, view->lastBuildTime) < HISTORY_VIEW_REBUILD_INTERVAL) { return; }
+	
+	if (app->historySearch.resultsDirty) { UpdateHistorySearchResults(&app->historySearch, &app->history); }
+	BuildHistoryView(view, &app->historyColumns, &app->historySearch);
+	view->settingsChanged = false;
+	view->historyChanged = false;
+	view->lastBuildTime = appIn->programTime;
+	if (app->selectedHistoryIndex != UINTXX_MAX && FindHistoryRowForIndex(app->selectedHistoryIndex) == UINTXX_MAX) { app->selectedHistoryIndex = UINTXX_MAX; }
+}
+
+// +==============================+
+// |  RenderResponsePreviewLine   |
+// +==============================+
+// void RenderResponsePreviewLine(VirtualListView* list, void* userPntr, uxx rowIndex, bool isSelected, bool isHovered)
+VIRTUAL_LIST_ROW_RENDER_DEF(RenderResponsePreviewLine)
+{
+	UNUSED(list);
+	UNUSED(isSelected);
+	UNUSED(isHovered);
+	HistoryItem* historyItem = (HistoryItem*)userPntr;
+	CLAY_TEXT(
+		GetStreamingResponseLine(uiArena, historyItem, rowIndex, RESPONSE_PREVIEW_MAX_LINE_LENGTH),
+		CLAY_TEXT_CONFIG({
+			.fontId = app->clayUiFontId,
+			.fontSize = (u16)app->uiFontSize,
+			.textColor = MonokaiWhite,
+			.wrapMode = CLAY_TEXT_WRAP_NONE,
+			.textAlignment = CLAY_TEXT_ALIGN_SHRINK,
+			.userData = { .contraction = TextContraction_ClipRight },
+	}));
+}
+
+// +==============================+
+// |       RenderHistoryRow       |
 // +==============================+
-// void RenderHistoryItem(UiListView* list, void* item, uxx index, bool isSelected, bool isHovered)
-UI_LIST_VIEW_ITEM_RENDER_DEF(RenderHistoryItem)
+// void RenderHistoryRow(VirtualListView* list, void* userPntr, uxx rowIndex, bool isSelected, bool isHovered)
+VIRTUAL_LIST_ROW_RENDER_DEF(RenderHistoryRow)
 {
 	UNUSED(isHovered);
-	UNUSED(item);
+	UNUSED(userPntr);
 	UNUSED(list);
-	uxx actualIndex = (app->history.length-1 - index);
+	uxx actualIndex = GetHistoryIndexForRow(rowIndex);
 	HistoryItem* historyItem = VarArrayGet(HistoryItem, &app->history, actualIndex);
 	
 	Color32 statusColor = Transparent;
@@ -300,6 +421,22 @@ UI_LIST_VIEW_ITEM_RENDER_DEF(RenderHistoryItem)
 		}));
 	}
 	
+	if (historyItem->bodyChanged)
+	{
+		CLAY({ .layout = { .padding = { .right = UI_U16(4), .top = UI_U16(2), .bottom = UI_U16(2) } } })
+		{
+			CLAY_TEXT(
+				StrLit("changed"),
+				CLAY_TEXT_CONFIG({
+					.fontId = app->clayUiFontId,
+					.fontSize = (u16)app->uiFontSize,
+					.textColor = isSelected ? MonokaiDarkGray : MonokaiYellow,
+					.wrapMode = CLAY_TEXT_WRAP_NONE,
+					.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+			}));
+		}
+	}
+	
 	// CLAY({ .layout = { .sizing = { .width=CLAY_SIZING_GROW(0) } } } ) {}
 	// Str8 btnIdStr = PrintInArenaStr(uiArena, "History_Item%llu_LoadBtn", actualIndex);
 	// if (ClayBtnStrEx(btnIdStr, StrLit("^"), Str8_Empty, true, false, false, nullptr))
@@ -308,49 +445,261 @@ UI_LIST_VIEW_ITEM_RENDER_DEF(RenderHistoryItem)
 	// } Clay__CloseElement();
 }
 
-#if BUILD_WITH_HTTP
 // +==============================+
-// |         HttpCallback         |
+// |     FindHistoryItemById      |
+// +==============================+
+HistoryItem* FindHistoryItemById(u64 id, uxx* indexOut)
+{
+	uxx historyIndex = HistoryLookupFind(&app->historyById, id);
+	if (historyIndex == UINTXX_MAX) { return nullptr; }
+	Assert(historyIndex < app->history.length);
+	HistoryItem* result = VarArrayGet(HistoryItem, &app->history, historyIndex);
+	Assert(result->id == id);
+	if (indexOut != nullptr) { *indexOut = historyIndex; }
+	return result;
+}
+
+// +==============================+
+// |   FindHistoryItemByHttpId    |
+// +==============================+
+HistoryItem* FindHistoryItemByHttpId(u64 httpId, uxx* indexOut)
+{
+	uxx historyIndex = HistoryLookupFind(&app->historyByHttpId, httpId);
+	if (historyIndex == UINTXX_MAX) { return nullptr; }
+	Assert(historyIndex < app->history.length);
+	HistoryItem* result = VarArrayGet(HistoryItem, &app->history, historyIndex);
+	Assert(result->httpId == httpId);
+	if (indexOut != nullptr) { *indexOut = historyIndex; }
+	return result;
+}
+
+// +==============================+
+// |      SelectHistoryItem       |
 // +==============================+
-// void HttpCallback(plex HttpRequest* request)
-HTTP_CALLBACK_DEF(HttpCallback)
+// Selects the item and scrolls the list to it. If the item doesn't match the current search or filters they all get cleared,
+// we never select something the list isn't showing
+void SelectHistoryItem(u64 id)
 {
-	NotNull(request);
-	HistoryItem* history = nullptr;
 	uxx historyIndex = 0;
+	if (FindHistoryItemById(id, &historyIndex) == nullptr) { return; }
+	RefreshHistoryView(true);
+	if (FindHistoryRowForIndex(historyIndex) == UINTXX_MAX)
+	{
+		UiTextboxClear(&app->historySearchTextbox);
+		UiTextboxClear(&app->historyHostTextbox);
+		SetHistorySearchQuery(&app->historySearch, Str8_Empty);
+		SetHistoryViewHostFilter(&app->historyView, Str8_Empty);
+		app->historyView.statusFilter = HistoryStatusFilter_All;
+		app->historyView.verbFilter = HttpVerb_None;
+		RefreshHistoryView(true);
+		Assert(FindHistoryRowForIndex(historyIndex) != UINTXX_MAX);
+	}
+	app->selectedHistoryIndex = historyIndex;
+	app->historyListView.scrollToSelection = true;
+}
+
+// Oldest lastViewedTime first, for qsort
+int CompareHistoryEvictCandidates(const void* left, const void* right)
+{
+	const HistoryEvictCandidate* leftCandidate = (const HistoryEvictCandidate*)left;
+	const HistoryEvictCandidate* rightCandidate = (const HistoryEvictCandidate*)right;
+	if (leftCandidate->lastViewedTime != rightCandidate->lastViewedTime) { return (leftCandidate->lastViewedTime < rightCandidate->lastViewedTime) ? -1 : 1; }
+	if (leftCandidate->historyIndex != rightCandidate->historyIndex) { return (leftCandidate->historyIndex < rightCandidate->historyIndex) ? -1 : 1; }
+	return 0;
+}
+
+// +==============================+
+// |  EnforceHistoryMemoryBudget  |
+// +==============================+
+// Adds up what every item's response is costing us and, while that's over app->historyMemoryBudget, evicts the least
+// recently viewed ones. Only items whose blob has been written can be evicted (the blob store is where they come back from)
+// so bodies that haven't been saved yet, the selected item and anything still in progress always stay
+//NOTE: Each sharer of a body is charged its share of it, but the body is only freed along with its last sharer, so
+// we count what each eviction actually released rather than what the item was charged
+void EnforceHistoryMemoryBudget()
+{
+	TracyCZoneN(Zone_Func, "EnforceHistoryMemoryBudget", true);
+	ScratchBegin(scratch);
+	uxx selectedIndex = UINTXX_MAX;
+	GetSelectedHistoryItem(&selectedIndex);
+	HistoryEvictCandidate* candidates = (app->history.length > 0) ? AllocArray(HistoryEvictCandidate, scratch, app->history.length) : nullptr;
+	uxx numCandidates = 0;
+	uxx totalUsage = 0;
 	VarArrayLoop(&app->history, hIndex)
 	{
-		VarArrayLoopGet(HistoryItem, historyItem, &app->history, hIndex);
-		if (historyItem->id == request->args.contextId) { history = historyItem; historyIndex = hIndex; break; }
+		VarArrayLoopGet(HistoryItem, item, &app->history, hIndex);
+		uxx itemUsage = GetHistoryResponseMemoryUsage(item);
+		totalUsage += itemUsage;
+		if (itemUsage > 0 && hIndex != selectedIndex && item->finished && item->hasBlob)
+		{
+			HistoryEvictCandidate* candidate = &candidates[numCandidates];
+			numCandidates++;
+			candidate->historyIndex = hIndex;
+			candidate->lastViewedTime = item->lastViewedTime;
+		}
+	}
+	
+	if (app->historyMemoryBudget > 0 && totalUsage > app->historyMemoryBudget && numCandidates > 0)
+	{
+		qsort(candidates, numCandidates, sizeof(HistoryEvictCandidate), CompareHistoryEvictCandidates);
+		for (uxx cIndex = 0; cIndex < numCandidates && totalUsage > app->historyMemoryBudget; cIndex++)
+		{
+			HistoryItem* item = VarArrayGet(HistoryItem, &app->history, candidates[cIndex].historyIndex);
+			uxx numReleased = EvictHistoryResponse(item);
+			totalUsage -= MinUXX(numReleased, totalUsage);
+			app->numHistoryEvictions++;
+		}
+	}
+	app->historyMemoryUsage = totalUsage;
+	
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+}
+
+// +==============================+
+// |    DetachInactiveHistory     |
+// +==============================+
+// Detaches every finished item that isn't selected from its shared body and queues the bodies that nobody is showing
+// anymore for the HistoryCodec (or just drops their raw bytes if they already have a compressed copy). Items have to be in the blob store first (WriteHistoryBlobs reads the body from response)
+void DetachInactiveHistory()
+{
+	TracyCZoneN(Zone_Func, "DetachInactiveHistory", true);
+	uxx selectedIndex = UINTXX_MAX;
+	GetSelectedHistoryItem(&selectedIndex);
+	VarArrayLoop(&app->history, hIndex)
+	{
+		VarArrayLoopGet(HistoryItem, item, &app->history, hIndex);
+		HistoryBody* body = item->sharedBody;
+		if (body == nullptr) { continue; }
+		if (!item->responseDetached && hIndex != selectedIndex && (item->hasBlob || app->historyBlobs.writeFailed)) { DetachHistoryResponse(item); }
+		if (item->responseDetached) { TrimHistoryBody(body); } //i.e. it was decompressed for an item that's no longer selected
+		if (item->responseDetached && body->numAttached == 0 && !body->isQueued && body->chars.chars != nullptr && body->compressed.chars == nullptr &&
+			!body->compressFailed && !body->inCodec && body->length >= HISTORY_COMPRESS_MIN_SIZE)
+		{
+			HistoryBody** queueSpace = VarArrayAdd(HistoryBody*, &app->historyCodec.compressQueue);
+			NotNull(queueSpace);
+			*queueSpace = body;
+			body->isQueued = true;
+		}
 	}
-	if (history == nullptr) { PrintLine_W("Couldn't find history item with ID %llu", request->args.contextId); return; }
+	TracyCZoneEnd(Zone_Func);
+}
+
+#if BUILD_WITH_HTTP
+// +==============================+
+// |       HandleHttpEvent        |
+// +==============================+
+//NOTE: Events are produced on the HttpService thread and drained at the top of AppUpdate
+void HandleHttpEvent(const HttpEvent* event)
+{
+	NotNull(event);
+	uxx historyIndex = 0;
+	HistoryItem* history = FindHistoryItemById(event->contextId, &historyIndex);
+	if (history == nullptr) { PrintLine_W("Couldn't find history item with ID %llu", event->contextId); return; }
+	//NOTE: Make sure this is the request the item actually made, an event for a cleared item must never land on another one
+	if (history->httpId != event->httpId) { PrintLine_W("Dropping event for request %llu, history item %llu belongs to request %llu", event->httpId, history->id, history->httpId); return; }
 	Assert(!history->finished);
 	
-	PrintLine_D("Callback for history %llu: %s \"%.*s\" result=%s, got %llu byte%s",
+	if (event->bytes.length > 0)
+	{
+		if (history->firstResponseByteTimeUs == 0) { history->firstResponseByteTimeUs = event->timeUs; }
+		history->lastResponseByteTimeUs = event->timeUs;
+		AppendHistoryResponseBytes(history, event->bytes);
+	}
+	else if (!IsEmptyStr(history->downloadPath) && event->totalBytes > history->responseLength)
+	{
+		//NOTE: Downloads only get byteless progress events, the body itself is being written to the file on the HttpService thread
+		if (history->firstResponseByteTimeUs == 0) { history->firstResponseByteTimeUs = event->timeUs; }
+		history->lastResponseByteTimeUs = event->timeUs;
+		history->responseLength = event->totalBytes;
+	}
+	if (event->type != HttpEventType_Finished) { return; }
+	
+	PrintLine_D("Finished history %llu: %s \"%.*s\" result=%s, got %llu byte%s",
 		history->id,
 		GetHttpVerbStr(history->verb),
 		StrPrint(history->url),
-		GetHttpRequestStateStr(request->state),
-		request->responseBytes.length, Plural(request->responseBytes.length, "s")
+		GetHttpRequestStateStr(event->state),
+		event->totalBytes, Plural(event->totalBytes, "s")
 	);
-	history->finished = true;
-	history->failed = (request->error != Result_None && request->error != Result_Success);
-	history->failureReason = request->error;
-	Str8 responseStr = MakeStr8(request->responseBytes.length, (char*)request->responseBytes.items);
-	NotNullStr(responseStr);
-	history->responseStatusCode = request->statusCode;
-	history->response = AllocStr8(history->arena, responseStr);
-	InitUiLargeText(stdHeap, history->response, &history->responseLargeText);
-	InitVarArrayWithInitial(Str8Pair, &history->responseHeaders, history->arena, request->numResponseHeaders);
-	for (uxx hIndex = 0; hIndex < request->numResponseHeaders; hIndex++)
+	if (!IsEmptyStr(history->downloadPath))
 	{
-		Str8Pair* historyHeader = VarArrayAdd(Str8Pair, &history->responseHeaders);
-		NotNull(historyHeader);
-		ClearPointer(historyHeader);
-		historyHeader->key = AllocStr8(history->arena, request->responseHeaders[hIndex].key);
-		historyHeader->value = AllocStr8(history->arena, request->responseHeaders[hIndex].value);
+		history->responseLength = event->totalBytes;
+		history->downloadHash = event->downloadHash;
 	}
+	Assert(history->responseLength == event->totalBytes);
+	history->finished = true;
+	history->failed = (event->error != Result_None && event->error != Result_Success);
+	history->failureReason = event->error;
+	history->responseStatusCode = event->statusCode;
+	history->responseEncoding = event->contentEncoding;
+	history->encodedResponseLength = event->encodedBytes;
+	history->abortReason = event->abortReason;
+	GetHttpPhaseDurations(&event->timings, &history->phaseDurationsUs[0]);
+	history->hasTimings = true;
+	FinishHistoryResponse(&app->historyBodies, history);
+	SetHistoryResponseHeaders(history, event->numResponseHeaders, event->responseHeaders);
+	IndexHistoryItemResponse(&app->historySearch, historyIndex, history->numResponseHeaders, history->responseHeaders, history->response);
+	SetHistoryColumnsRow(&app->historyColumns, historyIndex, history);
+	app->historyView.historyChanged = true;
+	TrackHistoryRequestBody(historyIndex);
+	QueueHistoryJournalItem(&app->historyJournal, historyIndex);
+	app->historyChanged = true;
+}
+
+// Seconds (fractions are fine) to microseconds, empty is the same as 0 (no limit)
+bool TryParseTimeoutTextbox(const UiTextbox* textbox, u64* timeoutUsOut)
+{
+	if (IsEmptyStr(textbox->text)) { *timeoutUsOut = 0; return true; }
+	r64 seconds = 0.0;
+	if (!TryParseR64(textbox->text, &seconds, nullptr) || seconds < 0.0) { return false; }
+	*timeoutUsOut = (u64)(seconds * 1000000.0);
+	return true;
+}
+
+// +==============================+
+// |      MakeHistoryRequest      |
+// +==============================+
+//NOTE: The HttpService deep copies the args, and we make our own copies for the HistoryItem, so the passed in strings only need to live for this call
+// A non-empty uploadPath sends that file as the body (in place of the contentItems)
+// A non-empty downloadPath streams the response body into that file instead of keeping it in the HistoryItem
+HistoryItem* MakeHistoryRequest(HttpVerb verb, Str8 url, uxx numHeaders, const Str8Pair* headers, uxx numContentItems, const Str8Pair* contentItems, Str8 uploadPath, Str8 downloadPath, const HttpTimeouts* timeouts)
+{
+	uxx historyId = app->nextHistoryId;
+	app->nextHistoryId++;
+	
+	HttpRequestArgs args = ZEROED;
+	args.verb = verb;
+	args.urlStr = url;
+	args.numHeaders = numHeaders;
+	args.headers = (Str8Pair*)headers;
+	args.contentEncoding = MimeType_FormUrlEncoded;
+	args.numContentItems = numContentItems;
+	args.contentItems = (Str8Pair*)contentItems;
+	args.contextId = historyId;
+	HttpRequestOptions options = ZEROED;
+	options.uploadPath = uploadPath;
+	options.downloadPath = downloadPath;
+	if (timeouts != nullptr) { MyMemCopy(&options.timeouts, timeouts, sizeof(HttpTimeouts)); }
+	u64 httpId = platform->MakeHttpRequest(&args, &options);
+	
+	HistoryItem* historyItem = VarArrayAdd(HistoryItem, &app->history);
+	NotNull(historyItem);
+	ClearPointer(historyItem);
+	historyItem->arena = stdHeap;
+	historyItem->id = historyId;
+	historyItem->httpId = httpId;
+	historyItem->urlHash = UpdateHttpContentHash(HTTP_CONTENT_HASH_START, url);
+	historyItem->verb = verb;
+	historyItem->lastViewedTime = appIn->programTime; //so it isn't the first thing evicted the moment it finishes
+	PackHistoryItemData(historyItem, url, uploadPath, downloadPath, numHeaders, headers, numContentItems, contentItems);
+	AddHistoryLookups(app->history.length-1);
+	IndexHistoryItemRequest(&app->historySearch, app->history.length-1, historyItem);
+	AddHistoryColumnsRow(&app->historyColumns, app->history.length-1, historyItem, GetUrlHost(url));
+	app->historyView.historyChanged = true;
+	
 	app->historyChanged = true;
+	return historyItem;
 }
 #endif
 
@@ -373,7 +722,10 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	
 	UiTextbox* focusableTextboxes[] = {
 		&app->urlTextbox,
-		&app->headerKeyTextbox, &app->headerValueTextbox, &app->contentKeyTextbox, &app->contentValueTextbox
+		&app->headerKeyTextbox, &app->headerValueTextbox, &app->contentKeyTextbox, &app->contentValueTextbox,
+		&app->connectTimeoutTextbox, &app->firstByteTimeoutTextbox, &app->idleTimeoutTextbox, &app->totalTimeoutTextbox,
+		&app->historySearchTextbox, &app->historyHostTextbox,
+		&app->loadRateTextbox, &app->loadDurationTextbox
 	};
 	
 	bool addHeader = false;
@@ -381,20 +733,64 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 	bool addContent = false;
 	bool canAddContent = (app->contentKeyTextbox.text.length > 0 && app->contentValueTextbox.text.length > 0);
 	bool makeRequest = false;
+	bool downloadRequest = false; //makeRequest but the body goes to a file picked with a save dialog
+	bool pickUploadFile = false;
+	bool clearUploadFile = false;
 	bool canMakeRequest = true; UNUSED(canMakeRequest);
+	bool replayHistory = false;
+	bool cancelHistory = false;
+	#if BUILD_WITH_HTTP
+	HttpTimeouts requestTimeouts = ZEROED; //parsed from the timeout textboxes each frame
+	#endif
+	bool startLoadTest = false;
+	bool stopLoadTest = false;
+	r64 loadTestRate = 0.0;
+	r64 loadTestDuration = 0.0;
 	
 	// +==============================+
 	// |            Update            |
 	// +==============================+
 	TracyCZoneN(Zone_Update, "Update", true);
 	{
+		//NOTE: Anything that shows the selected item needs all of it, not just what the history index had
+		PollHistoryCodec(&app->historyCodec, false);
+		HistoryItem* selectedHistory = GetSelectedHistoryItem(nullptr);
+		if (selectedHistory != nullptr)
+		{
+			MaterializeHistoryItem(&app->historyJournal, selectedHistory);
+			LoadHistoryBlob(&app->historyBlobs, selectedHistory);
+			AttachHistoryResponse(&app->historyCodec, selectedHistory);
+			selectedHistory->lastViewedTime = appIn->programTime;
+		}
+		
+		#if BUILD_WITH_HTTP
+		HttpEvent httpEvent = ZEROED;
+		while (platform->PopHttpEvent(&httpEvent))
+		{
+			if (IsFlagSet(httpEvent.contextId, LOAD_TEST_CONTEXT_FLAG)) { HandleLoadTestEvent(&app->loadTest, &httpEvent); }
+			else { HandleHttpEvent(&httpEvent); }
+			platform->FreeHttpEvent(&httpEvent);
+		}
+		UpdateLoadTest(&app->loadTest);
+		#endif
+		
+		BackfillHistorySearch(&app->historySearch, &app->historyBlobs, &app->history, HISTORY_SEARCH_BACKFILL_TIME * 1000);
+		RefreshHistoryView(false);
+		
 		if (app->historyChanged && (app->lastHistorySaveTime == 0 || TimeSinceBy(appIn->programTime, app->lastHistorySaveTime) >= SAVE_HISTORY_DELAY))
 		{
-			SaveHistory(&app->history);
+			app->historyChanged = !SaveHistory(&app->historyJournal, &app->historyBlobs, &app->historyWriter, &app->history);
 			app->lastHistorySaveTime = appIn->programTime;
-			app->historyChanged = false;
 		}
 		
+		if (app->lastHistoryMemoryCheckTime == 0 || TimeSinceBy(appIn->programTime, app->lastHistoryMemoryCheckTime) >= HISTORY_MEMORY_CHECK_INTERVAL)
+		{
+			EnforceHistoryMemoryBudget();
+			DetachInactiveHistory();
+			app->lastHistoryMemoryCheckTime = appIn->programTime;
+		}
+		StartNextHistoryCompression(&app->historyCodec);
+		
 		// +==================================+
 		// | Handle Ctrl+Plus/Minus/0/Scroll  |
 		// +==================================+
@@ -881,17 +1277,75 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 									else { app->httpVerb = (HttpVerb)1; }
 								} Clay__CloseElement();
 								
-								StrErrorList requestErrors = NewStrErrorList(scratch, 1);
+								//NOTE: The file is only opened (and mapped) by the HttpService when the request runs, so picking a huge file here costs nothing
+								Str8 bodyFileBtnText = IsEmptyStr(app->uploadFilePath) ? StrLit("Body From File...") : PrintInArenaStr(uiArena, "Body: %.*s", StrPrint(GetFileNamePart(app->uploadFilePath, true)));
+								if (ClayBtnStrEx(StrLit("BodyFromFile"), bodyFileBtnText, Str8_Empty, true, false, false, nullptr))
+								{
+									pickUploadFile = true;
+								} Clay__CloseElement();
+								if (!IsEmptyStr(app->uploadFilePath))
+								{
+									if (ClayBtnStrEx(StrLit("ClearBodyFile"), StrLit("X"), Str8_Empty, true, false, false, nullptr))
+									{
+										clearUploadFile = true;
+									} Clay__CloseElement();
+								}
+								
+								StrErrorList requestErrors = NewStrErrorList(scratch, 2);
 								if (app->urlHasErrors) { AddStrError(&requestErrors, RangeUXX_Zero, StrLit("URL has errors")); }
+								#if BUILD_WITH_HTTP
+								if (!TryParseTimeoutTextbox(&app->connectTimeoutTextbox, &requestTimeouts.connectUs) ||
+									!TryParseTimeoutTextbox(&app->firstByteTimeoutTextbox, &requestTimeouts.firstByteUs) ||
+									!TryParseTimeoutTextbox(&app->idleTimeoutTextbox, &requestTimeouts.idleUs) ||
+									!TryParseTimeoutTextbox(&app->totalTimeoutTextbox, &requestTimeouts.totalUs))
+								{
+									AddStrError(&requestErrors, RangeUXX_Zero, StrLit("Timeouts must be 0 or a positive number of seconds"));
+									canMakeRequest = false;
+								}
+								#endif
 								if (ClayBtnStrEx(StrLit("MakeRequest"), StrLit("Make Request"), StrLit("Ctrl+Enter"), true, (requestErrors.numErrors > 0), true, nullptr))
 								{
 									makeRequest = true;
 								} Clay__CloseElement();
+								if (ClayBtnStrEx(StrLit("DownloadRequest"), StrLit("Download to File..."), Str8_Empty, true, (requestErrors.numErrors > 0), false, nullptr))
+								{
+									downloadRequest = true;
+								} Clay__CloseElement();
 								Str8 makeRequestBtnIdStr = StrLit("Btn_MakeRequest");
 								ClayId makeRequestBtnId = ToClayId(makeRequestBtnIdStr);
 								bool shouldShowError = (IsMouseOverClay(makeRequestBtnId) || (app->makeRequestAttemptTime > 0 && TimeSinceBy(appIn->programTime, app->makeRequestAttemptTime) < 2000));
 								DoErrorHoverable(&uiContext, makeRequestBtnIdStr, &requestErrors, shouldShowError);
 							}
+							
+							// +==============================+
+							// |         Timeouts Row         |
+							// +==============================+
+							CLAY({ .id = CLAY_ID("TimeoutsRow"),
+								.layout = {
+									.sizing = { .width = CLAY_SIZING_GROW(0), },
+									.layoutDirection = CLAY_LEFT_TO_RIGHT,
+									.padding = { .left = UI_U16(8), .top = UI_U16(8), .right = UI_U16(8) },
+									.childGap = UI_U16(8),
+									.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+								},
+							})
+							{
+								Str8 timeoutLabels[] = { StrLit("Timeouts (s)  Connect:"), StrLit("First Byte:"), StrLit("Idle:"), StrLit("Total:") };
+								UiTextbox* timeoutTextboxes[] = { &app->connectTimeoutTextbox, &app->firstByteTimeoutTextbox, &app->idleTimeoutTextbox, &app->totalTimeoutTextbox };
+								for (uxx tIndex = 0; tIndex < ArrayCount(timeoutTextboxes); tIndex++)
+								{
+									CLAY_TEXT(
+										timeoutLabels[tIndex],
+										CLAY_TEXT_CONFIG({
+											.fontId = app->clayUiBoldFontId,
+											.fontSize = (u16)app->uiFontSize,
+											.textColor = MonokaiWhite,
+											.wrapMode = CLAY_TEXT_WRAP_NONE,
+											.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+									}));
+									DoUiTextbox(&uiContext, timeoutTextboxes[tIndex], &app->uiFont, UI_FONT_STYLE, app->uiFontSize);
+								}
+							}
 						}
 					}
 					
@@ -909,37 +1363,182 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 							// +==============================+
 							DoUiResizableSplitSection(historyResponseSection, Left)
 							{
-								UiListViewItem* historyListItems = nullptr;
-								if (app->history.length > 0)
+								CLAY({ .id = CLAY_ID("HistorySearchRow"),
+									.layout = {
+										.sizing = { .width = CLAY_SIZING_GROW(0), },
+										.layoutDirection = CLAY_LEFT_TO_RIGHT,
+										.padding = { .bottom = UI_U16(4) },
+										.childGap = UI_U16(4),
+										.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+									},
+								})
+								{
+									CLAY_TEXT(
+										StrLit("Search:"),
+										CLAY_TEXT_CONFIG({
+											.fontId = app->clayUiBoldFontId,
+											.fontSize = (u16)app->uiFontSize,
+											.textColor = MonokaiWhite,
+											.wrapMode = CLAY_TEXT_WRAP_NONE,
+											.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+									}));
+									DoUiTextbox(&uiContext, &app->historySearchTextbox, &app->uiFont, UI_FONT_STYLE, app->uiFontSize);
+									if (app->historySearchTextbox.textChanged)
+									{
+										app->historySearchTextbox.textChanged = false;
+										SetHistorySearchQuery(&app->historySearch, app->historySearchTextbox.text);
+										app->historyView.settingsChanged = true;
+										RefreshHistoryView(false);
+									}
+								}
+								
+								CLAY({ .id = CLAY_ID("HistoryFilterRow"),
+									.layout = {
+										.sizing = { .width = CLAY_SIZING_GROW(0), },
+										.layoutDirection = CLAY_LEFT_TO_RIGHT,
+										.padding = { .bottom = UI_U16(4) },
+										.childGap = UI_U16(4),
+										.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+									},
+								})
 								{
-									historyListItems = AllocArray(UiListViewItem, scratch, app->history.length);
-									NotNull(historyListItems);
-									for (uxx hIndex = app->history.length; hIndex > 0; hIndex--)
+									HistoryView* historyView = &app->historyView;
+									Str8 statusFilterStr = PrintInArenaStr(uiArena, "Status: %s", GetHistoryStatusFilterStr(historyView->statusFilter));
+									if (ClayBtnStrEx(StrLit("HistoryStatusFilter"), statusFilterStr, Str8_Empty, true, false, false, nullptr))
+									{
+										if (historyView->statusFilter+1 < HistoryStatusFilter_Count) { historyView->statusFilter = (HistoryStatusFilter)(historyView->statusFilter + 1); }
+										else { historyView->statusFilter = (HistoryStatusFilter)0; }
+										historyView->settingsChanged = true;
+									} Clay__CloseElement();
+									
+									Str8 verbFilterStr = PrintInArenaStr(uiArena, "Verb: %s", (historyView->verbFilter != HttpVerb_None) ? GetHttpVerbStr(historyView->verbFilter) : "All");
+									if (ClayBtnStrEx(StrLit("HistoryVerbFilter"), verbFilterStr, Str8_Empty, true, false, false, nullptr))
+									{
+										//NOTE: HttpVerb_None stands in for "All" here
+										if (historyView->verbFilter+1 < HttpVerb_Count) { historyView->verbFilter = (HttpVerb)(historyView->verbFilter + 1); }
+										else { historyView->verbFilter = HttpVerb_None; }
+										historyView->settingsChanged = true;
+									} Clay__CloseElement();
+									
+									Str8 sortStr = PrintInArenaStr(uiArena, "Sort: %s", GetHistorySortStr(historyView->sort));
+									if (ClayBtnStrEx(StrLit("HistorySort"), sortStr, Str8_Empty, true, false, false, nullptr))
 									{
-										VarArrayLoopGet(HistoryItem, historyItem, &app->history, hIndex-1);
-										UiListViewItem* item = &historyListItems[app->history.length - hIndex];
-										ClearPointer(item);
-										item->idStr = PrintInArenaStr(uiArena, "History%llu", historyItem->id);
-										item->displayStr = AllocStr8(uiArena, historyItem->url);
-										item->render = RenderHistoryItem;
+										if (historyView->sort+1 < HistorySort_Count) { historyView->sort = (HistorySort)(historyView->sort + 1); }
+										else { historyView->sort = (HistorySort)0; }
+										historyView->settingsChanged = true;
+									} Clay__CloseElement();
+									
+									CLAY_TEXT(
+										StrLit("Host:"),
+										CLAY_TEXT_CONFIG({
+											.fontId = app->clayUiBoldFontId,
+											.fontSize = (u16)app->uiFontSize,
+											.textColor = MonokaiWhite,
+											.wrapMode = CLAY_TEXT_WRAP_NONE,
+											.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+									}));
+									DoUiTextbox(&uiContext, &app->historyHostTextbox, &app->uiFont, UI_FONT_STYLE, app->uiFontSize);
+									if (app->historyHostTextbox.textChanged)
+									{
+										app->historyHostTextbox.textChanged = false;
+										SetHistoryViewHostFilter(historyView, app->historyHostTextbox.text);
 									}
+									
+									RefreshHistoryView(false);
 								}
-								DoUiListView(&uiContext, &app->historyListView,
-									CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0), 0,
-									app->history.length, historyListItems);
 								
-								if (ClayBtnStrEx(StrLit("ClearHistory"), StrLit("Clear"), Str8_Empty, (app->history.length > 0), false, true, nullptr))
+								//NOTE: Only the rows on screen get built, so this costs the same with 10 items or 1M
+								uxx selectedHistoryRow = FindHistoryRowForIndex(app->selectedHistoryIndex);
+								app->historyListView.selectionActive = (selectedHistoryRow != UINTXX_MAX);
+								app->historyListView.selectionIndex = app->historyListView.selectionActive ? selectedHistoryRow : 0;
+								DoVirtualListView(&app->historyListView,
+									CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0), fontHeight + UI_R32(4),
+									GetNumHistoryRows(), RenderHistoryRow, nullptr);
+								if (app->historyListView.selectionChanged)
 								{
-									VarArrayLoop(&app->history, hIndex)
+									app->historyListView.selectionChanged = false;
+									app->selectedHistoryIndex = GetHistoryIndexForRow(app->historyListView.selectionIndex);
+								}
+								
+								CLAY({ .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT, .sizing = { .width = CLAY_SIZING_GROW(0) }, .childGap = UI_U16(4) } })
+								{
+									if (ClayBtnStrEx(StrLit("ReplayHistory"), StrLit("Replay All"), Str8_Empty, (app->history.length > 0), false, true, nullptr))
 									{
-										VarArrayLoopGet(HistoryItem, item, &app->history, hIndex);
-										FreeHistoryItem(item);
+										replayHistory = true;
+									} Clay__CloseElement();
+									
+									HistoryItem* selectedHistory = GetSelectedHistoryItem(nullptr);
+									bool selectedInProgress = (selectedHistory != nullptr && !selectedHistory->finished);
+									if (ClayBtnStrEx(StrLit("CancelHistory"), StrLit("Cancel"), Str8_Empty, selectedInProgress, false, true, nullptr))
+									{
+										cancelHistory = true;
+									} Clay__CloseElement();
+									
+									if (ClayBtnStrEx(StrLit("ClearHistory"), StrLit("Clear"), Str8_Empty, (app->history.length > 0), false, true, nullptr))
+									{
+										//NOTE: A snapshot being written still points at these items' strings, and the codec at one of the bodies
+										PollHistoryWriter(&app->historyJournal, &app->historyWriter, true);
+										PollHistoryCodec(&app->historyCodec, true);
+										VarArrayLoop(&app->history, hIndex)
+										{
+											VarArrayLoopGet(HistoryItem, item, &app->history, hIndex);
+											#if BUILD_WITH_HTTP
+											//NOTE: Nobody will own the response once the item is gone, so stop it rather than let it keep downloading
+											if (!item->finished) { platform->CancelHttpRequest(item->httpId); }
+											#endif
+											FreeHistoryItem(item);
+										}
+										VarArrayClear(&app->history);
+										FreeHistoryLookup(&app->historyById);
+										FreeHistoryLookup(&app->historyByHttpId);
+										FreeHistoryBodies(&app->historyBodies);
+										VarArrayClear(&app->historyCodec.compressQueue);
+										app->historyCodec.compressQueueReadIndex = 0;
+										FreeHistoryLookup(&app->historyByRequest);
+										app->historyJournal.numUnmaterialized = 0;
+										platform->UnmapFile(&app->historyJournal.historyMapping);
+										VarArrayClear(&app->historyJournal.pending);
+										app->historyJournal.needsCompaction = true;
+										ResetHistorySearch(&app->historySearch);
+										ClearHistoryColumns(&app->historyColumns);
+										VarArrayClear(&app->historyView.rows);
+										app->historyView.historyChanged = true;
+										app->selectedHistoryIndex = UINTXX_MAX;
+										//NOTE: nextHistoryId keeps counting so the cancelled requests' last events can't land on a new item that reused their id
+										app->historyChanged = true;
+									} Clay__CloseElement();
+								}
+								
+								if (app->historyView.isActive || app->historySearch.numBackfilled < app->historySearch.numToBackfill)
+								{
+									Str8 searchStatusStr = Str8_Empty;
+									if (app->historyView.isActive) { searchStatusStr = PrintInArenaStr(uiArena, "%llu of %llu match", (u64)app->historyView.rows.length, (u64)app->history.length); }
+									if (app->historySearch.numBackfilled < app->historySearch.numToBackfill)
+									{
+										searchStatusStr = PrintInArenaStr(uiArena, "%.*s%sIndexing %llu/%llu", StrPrint(searchStatusStr), (searchStatusStr.length > 0) ? ", " : "", (u64)app->historySearch.numBackfilled, (u64)app->historySearch.numToBackfill);
 									}
-									VarArrayClear(&app->history);
-									app->historyListView.selectionActive = false;
-									app->nextHistoryId = 1;
-									app->historyChanged = true;
-								} Clay__CloseElement();
+									CLAY_TEXT(
+										searchStatusStr,
+										CLAY_TEXT_CONFIG({
+											.fontId = app->clayUiFontId,
+											.fontSize = (u16)app->uiFontSize,
+											.textColor = MonokaiGray1,
+											.wrapMode = CLAY_TEXT_WRAP_NONE,
+											.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+									}));
+								}
+								
+								CLAY_TEXT(
+									(app->historyMemoryBudget > 0)
+										? PrintInArenaStr(uiArena, "Memory: %.*s / %.*s (%llu evicted)", StrPrint(FormatBytes(uiArena, app->historyMemoryUsage)), StrPrint(FormatBytes(uiArena, app->historyMemoryBudget)), (u64)app->numHistoryEvictions)
+										: PrintInArenaStr(uiArena, "Memory: %.*s (no limit)", StrPrint(FormatBytes(uiArena, app->historyMemoryUsage))),
+									CLAY_TEXT_CONFIG({
+										.fontId = app->clayUiFontId,
+										.fontSize = (u16)app->uiFontSize,
+										.textColor = MonokaiGray1,
+										.wrapMode = CLAY_TEXT_WRAP_NONE,
+										.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+								}));
 							}
 							
 							// +==============================+
@@ -988,9 +1587,9 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 														.textAlignment = CLAY_TEXT_ALIGN_LEFT,
 												}));
 												
-												if (tab == ResultTab_Meta && app->historyListView.selectionActive && app->historyListView.selectionIndex < app->history.length)
+												HistoryItem* selectedHistory = (tab == ResultTab_Meta) ? GetSelectedHistoryItem(nullptr) : nullptr;
+												if (selectedHistory != nullptr)
 												{
-													HistoryItem* selectedHistory = VarArrayGet(HistoryItem, &app->history, (app->history.length-1) - app->historyListView.selectionIndex);
 													if (selectedHistory->finished)
 													{
 														if (selectedHistory->failed)
@@ -1019,6 +1618,20 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 														}
 													}
 												}
+												#if BUILD_WITH_HTTP
+												if (tab == ResultTab_LoadTest && IsLoadTestActive(&app->loadTest))
+												{
+													CLAY_TEXT(
+														PrintInArenaStr(uiArena, "%llu/%llu", app->loadTest.numCompleted, app->loadTest.totalRequests),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiGreen,
+															.wrapMode = CLAY_TEXT_WRAP_NONE,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+												}
+												#endif
 											}
 										}
 									}
@@ -1043,15 +1656,17 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 											// +==============================+
 											case ResultTab_Raw:
 											{
-												if (app->historyListView.selectionActive && app->historyListView.selectionIndex < app->history.length)
+												HistoryItem* selectedHistory = GetSelectedHistoryItem(nullptr);
+												if (selectedHistory != nullptr)
 												{
-													HistoryItem* selectedHistory = VarArrayGet(HistoryItem, &app->history, (app->history.length-1) - app->historyListView.selectionIndex);
 													if (selectedHistory->finished)
 													{
 														if (selectedHistory->failed)
 														{
 															CLAY_TEXT(
-																PrintInArenaStr(uiArena, "Request Failed: %s", GetResultStr(selectedHistory->failureReason)),
+																(selectedHistory->abortReason != HttpAbortReason_None)
+																	? PrintInArenaStr(uiArena, "Request Failed: %s", GetHttpAbortReasonStr(selectedHistory->abortReason))
+																	: PrintInArenaStr(uiArena, "Request Failed: %s", GetResultStr(selectedHistory->failureReason)),
 																CLAY_TEXT_CONFIG({
 																	.fontId = app->clayUiFontId,
 																	.fontSize = (u16)app->uiFontSize,
@@ -1060,6 +1675,34 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
 															}));
 														}
+														else if (!IsEmptyStr(selectedHistory->downloadPath))
+														{
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "Downloaded %llu byte%s to \"%.*s\"\nFNV-1a: %016llX",
+																	selectedHistory->responseLength, Plural(selectedHistory->responseLength, "s"),
+																	StrPrint(selectedHistory->downloadPath),
+																	selectedHistory->downloadHash
+																),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiWhite,
+																	.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+															}));
+														}
+														else if (selectedHistory->responseDetached)
+														{
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "Decompressing %.*s...", StrPrint(FormatBytes(uiArena, selectedHistory->responseLength))),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiGray1,
+																	.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+															}));
+														}
 														else if (selectedHistory->response.length > 0)
 														{
 															DoUiLargeTextView(&uiContext, &app->responseTextView,
@@ -1103,6 +1746,8 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																} Clay__CloseElement();
 																
 																Str8 infoStr = PrintInArenaStr(uiArena, "%llu byte%s", selectedHistory->response.length, Plural(selectedHistory->response.length, "s"));
+																r64 bytesPerSecond = GetHistoryResponseBytesPerSecond(selectedHistory, SysGetTimeUs());
+																if (bytesPerSecond > 0.0) { infoStr = PrintInArenaStr(uiArena, "%.*s (%.*s)", StrPrint(infoStr), StrPrint(FormatBytesPerSecond(uiArena, bytesPerSecond))); }
 																CLAY_TEXT(
 																	infoStr,
 																	CLAY_TEXT_CONFIG({
@@ -1140,6 +1785,55 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 															}));
 														}
 													}
+													else if (!IsEmptyStr(selectedHistory->downloadPath))
+													{
+														CLAY_TEXT(
+															PrintInArenaStr(uiArena, "Downloading to \"%.*s\"... %llu byte%s (%.*s)",
+																StrPrint(selectedHistory->downloadPath),
+																selectedHistory->responseLength, Plural(selectedHistory->responseLength, "s"),
+																StrPrint(FormatBytesPerSecond(uiArena, GetHistoryResponseBytesPerSecond(selectedHistory, SysGetTimeUs())))
+															),
+															CLAY_TEXT_CONFIG({
+																.fontId = app->clayUiFontId,
+																.fontSize = (u16)app->uiFontSize,
+																.textColor = MonokaiGray1,
+																.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+														}));
+													}
+													else if (selectedHistory->firstResponseChunk != nullptr)
+													{
+														//NOTE: Only the lines on screen are read out of the chunks, so this costs the same no matter how much has arrived
+														DoVirtualListView(&app->responsePreviewList,
+															CLAY_SIZING_GROW(0), CLAY_SIZING_GROW(0), fontHeight,
+															GetStreamingResponseNumLines(selectedHistory), RenderResponsePreviewLine, (void*)selectedHistory);
+														
+														CLAY({
+															.layout = {
+																.sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIT(0) },
+																.layoutDirection = CLAY_LEFT_TO_RIGHT,
+																.padding = { .left = UI_U16(4), .top = UI_U16(4) },
+																.childGap = UI_U16(8),
+																.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+															},
+															.backgroundColor = MonokaiBack,
+														})
+														{
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "Receiving... %llu byte%s (%.*s)",
+																	selectedHistory->responseLength, Plural(selectedHistory->responseLength, "s"),
+																	StrPrint(FormatBytesPerSecond(uiArena, GetHistoryResponseBytesPerSecond(selectedHistory, SysGetTimeUs())))
+																),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiGray1,
+																	.wrapMode = CLAY_TEXT_WRAP_NONE,
+																	.textAlignment = CLAY_TEXT_ALIGN_SHRINK,
+																	.userData = { .contraction = TextContraction_ClipRight },
+															}));
+														}
+													}
 													else
 													{
 														CLAY_TEXT(
@@ -1169,9 +1863,9 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 											
 											case ResultTab_Meta:
 											{
-												if (app->historyListView.selectionActive && app->historyListView.selectionIndex < app->history.length)
+												HistoryItem* selectedHistory = GetSelectedHistoryItem(nullptr);
+												if (selectedHistory != nullptr)
 												{
-													HistoryItem* selectedHistory = VarArrayGet(HistoryItem, &app->history, (app->history.length-1) - app->historyListView.selectionIndex);
 													if (selectedHistory->finished)
 													{
 														CLAY_TEXT(
@@ -1194,8 +1888,43 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																.textAlignment = CLAY_TEXT_ALIGN_LEFT,
 														}));
 														
+														if (!IsEmptyStr(selectedHistory->uploadPath))
+														{
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "  Body from file: %.*s", StrPrint(selectedHistory->uploadPath)),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiWhite,
+																	.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+															}));
+														}
+														
+														if (selectedHistory->responseEncoding != HttpContentEncoding_None)
+														{
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "  %s encoded: %llu byte%s over the wire, %llu decoded",
+																	GetHttpContentEncodingStr(selectedHistory->responseEncoding),
+																	selectedHistory->encodedResponseLength, Plural(selectedHistory->encodedResponseLength, "s"),
+																	selectedHistory->responseLength
+																),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiWhite,
+																	.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+															}));
+														}
+														
 														CLAY_TEXT(
-															PrintInArenaStr(uiArena, "  %s%s", selectedHistory->failed ? "Failure: " : "Success", selectedHistory->failed ? GetResultStr(selectedHistory->failureReason) : ""),
+															PrintInArenaStr(uiArena, "  %s%s%s%s",
+																selectedHistory->failed ? "Failure: " : "Success",
+																selectedHistory->failed ? GetResultStr(selectedHistory->failureReason) : "",
+																(selectedHistory->abortReason != HttpAbortReason_None) ? ", " : "",
+																(selectedHistory->abortReason != HttpAbortReason_None) ? GetHttpAbortReasonStr(selectedHistory->abortReason) : ""
+															),
 															CLAY_TEXT_CONFIG({
 																.fontId = app->clayUiFontId,
 																.fontSize = (u16)app->uiFontSize,
@@ -1229,8 +1958,50 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
 															}));
 															
+															const HistoryBody* sharedBody = selectedHistory->sharedBody;
+															Str8 bodyStr = StrLit("  Body:");
+															bool hasBodyInfo = false;
+															if (selectedHistory->bodyChanged)
+															{
+																bodyStr = PrintInArenaStr(uiArena, "%.*s changed since the last run of this request", StrPrint(bodyStr));
+																hasBodyInfo = true;
+															}
+															if (sharedBody != nullptr && sharedBody->refCount > 1)
+															{
+																uxx numOthers = sharedBody->refCount-1;
+																bodyStr = PrintInArenaStr(uiArena, "%.*s%s shared with %llu other item%s", StrPrint(bodyStr), hasBodyInfo ? "," : "", (u64)numOthers, Plural(numOthers, "s"));
+																hasBodyInfo = true;
+															}
+															//NOTE: The compressed copy is kept after decompressing, so the ratio still shows while the item is selected
+															if (sharedBody != nullptr && sharedBody->compressed.length > 0)
+															{
+																bodyStr = PrintInArenaStr(uiArena, "%.*s%s compressed %.*s / %.*s raw (%.1f%%)",
+																	StrPrint(bodyStr), hasBodyInfo ? "," : "",
+																	StrPrint(FormatBytes(uiArena, sharedBody->compressed.length)), StrPrint(FormatBytes(uiArena, sharedBody->length)),
+																	100.0 * (r64)sharedBody->compressed.length / (r64)sharedBody->length
+																);
+																hasBodyInfo = true;
+															}
+															else if (sharedBody != nullptr && sharedBody->compressFailed)
+															{
+																bodyStr = PrintInArenaStr(uiArena, "%.*s%s %.*s raw (doesn't compress)", StrPrint(bodyStr), hasBodyInfo ? "," : "", StrPrint(FormatBytes(uiArena, sharedBody->length)));
+																hasBodyInfo = true;
+															}
+															if (hasBodyInfo)
+															{
+																CLAY_TEXT(
+																	bodyStr,
+																	CLAY_TEXT_CONFIG({
+																		.fontId = app->clayUiFontId,
+																		.fontSize = (u16)app->uiFontSize,
+																		.textColor = selectedHistory->bodyChanged ? MonokaiYellow : MonokaiWhite,
+																		.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																		.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+																}));
+															}
+															
 															CLAY_TEXT(
-																PrintInArenaStr(uiArena, "  Headers (%llu):", selectedHistory->responseHeaders.length),
+																PrintInArenaStr(uiArena, "  Headers (%llu):", selectedHistory->numResponseHeaders),
 																CLAY_TEXT_CONFIG({
 																	.fontId = app->clayUiFontId,
 																	.fontSize = (u16)app->uiFontSize,
@@ -1239,9 +2010,9 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
 															}));
 															
-															VarArrayLoop(&selectedHistory->responseHeaders, hIndex)
+															for (uxx hIndex = 0; hIndex < selectedHistory->numResponseHeaders; hIndex++)
 															{
-																VarArrayLoopGet(Str8Pair, header, &selectedHistory->responseHeaders, hIndex);
+																const Str8Pair* header = &selectedHistory->responseHeaders[hIndex];
 																CLAY_TEXT(
 																	PrintInArenaStr(uiArena, "    %.*s: %.*s", StrPrint(header->key), StrPrint(header->value)),
 																	CLAY_TEXT_CONFIG({
@@ -1253,6 +2024,88 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 																}));
 															}
 														}
+														
+														if (selectedHistory->hasTimings)
+														{
+															CLAY({ .layout = { .sizing = { .height = CLAY_SIZING_FIXED(UI_R32(15)) } } }) { }
+															
+															u64 totalDurationUs = 0;
+															bool anyUnknownPhases = false;
+															for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+															{
+																if (selectedHistory->phaseDurationsUs[pIndex] == HTTP_PHASE_UNKNOWN) { anyUnknownPhases = true; }
+																else { totalDurationUs += selectedHistory->phaseDurationsUs[pIndex]; }
+															}
+															
+															CLAY_TEXT(
+																PrintInArenaStr(uiArena, "Timing: %.3fms", totalDurationUs / 1000.0),
+																CLAY_TEXT_CONFIG({
+																	.fontId = app->clayUiBoldFontId,
+																	.fontSize = (u16)app->uiFontSize,
+																	.textColor = MonokaiWhite,
+																	.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																	.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+															}));
+															
+															// +==============================+
+															// |       Timing Waterfall       |
+															// +==============================+
+															CLAY({ .id = CLAY_ID("TimingWaterfall"),
+																.layout = {
+																	.sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(fontHeight) },
+																	.layoutDirection = CLAY_LEFT_TO_RIGHT,
+																	.padding = { .left = UI_U16(8), .right = UI_U16(8), .top = UI_U16(2), .bottom = UI_U16(2) },
+																},
+															})
+															{
+																for (uxx pIndex = 0; pIndex < HttpPhase_Count && totalDurationUs > 0; pIndex++)
+																{
+																	u64 durationUs = selectedHistory->phaseDurationsUs[pIndex];
+																	if (durationUs == HTTP_PHASE_UNKNOWN || durationUs == 0) { continue; }
+																	CLAY({
+																		.layout = { .sizing = { .width = CLAY_SIZING_PERCENT((r32)((r64)durationUs / (r64)totalDurationUs)), .height = CLAY_SIZING_GROW(0) } },
+																		.backgroundColor = GetColorForHttpPhase((HttpPhase)pIndex),
+																	}) { }
+																}
+															}
+															
+															for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+															{
+																u64 durationUs = selectedHistory->phaseDurationsUs[pIndex];
+																CLAY({ .layout = { .layoutDirection = CLAY_LEFT_TO_RIGHT, .padding = { .left = UI_U16(8) }, .childGap = UI_U16(4), .childAlignment = { .y = CLAY_ALIGN_Y_CENTER } } })
+																{
+																	CLAY({
+																		.layout = { .sizing = { .width = CLAY_SIZING_FIXED(UI_R32(10)), .height = CLAY_SIZING_FIXED(UI_R32(10)) } },
+																		.backgroundColor = GetColorForHttpPhase((HttpPhase)pIndex),
+																	}) { }
+																	
+																	CLAY_TEXT(
+																		(durationUs == HTTP_PHASE_UNKNOWN)
+																			? PrintInArenaStr(uiArena, "%s: -", GetHttpPhaseStr((HttpPhase)pIndex))
+																			: PrintInArenaStr(uiArena, "%s: %.3fms", GetHttpPhaseStr((HttpPhase)pIndex), durationUs / 1000.0),
+																		CLAY_TEXT_CONFIG({
+																			.fontId = app->clayUiFontId,
+																			.fontSize = (u16)app->uiFontSize,
+																			.textColor = (durationUs == HTTP_PHASE_UNKNOWN) ? MonokaiGray1 : MonokaiWhite,
+																			.wrapMode = CLAY_TEXT_WRAP_NONE,
+																			.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+																	}));
+																}
+															}
+															
+															if (anyUnknownPhases)
+															{
+																CLAY_TEXT(
+																	StrLit("  Phases marked - weren't reported by the HTTP backend, their time is counted in the next phase"),
+																	CLAY_TEXT_CONFIG({
+																		.fontId = app->clayUiFontId,
+																		.fontSize = (u16)app->uiFontSize,
+																		.textColor = MonokaiGray1,
+																		.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																		.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+																}));
+															}
+														}
 													}
 													else
 													{
@@ -1281,6 +2134,161 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 												}
 											} break;
 											
+											// +==============================+
+											// |       Load Test Result       |
+											// +==============================+
+											case ResultTab_LoadTest:
+											{
+												#if BUILD_WITH_HTTP
+												LoadTest* test = &app->loadTest;
+												HistoryItem* selectedHistory = GetSelectedHistoryItem(nullptr);
+												
+												CLAY({
+													.layout = {
+														.sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIT(0) },
+														.layoutDirection = CLAY_LEFT_TO_RIGHT,
+														.padding = CLAY_PADDING_ALL(UI_U16(4)),
+														.childGap = UI_U16(8),
+														.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+													},
+													.backgroundColor = MonokaiBack,
+												})
+												{
+													CLAY_TEXT(
+														StrLit("Rate (req/s):"),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiBoldFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiWhite,
+															.wrapMode = CLAY_TEXT_WRAP_NONE,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+													DoUiTextbox(&uiContext, &app->loadRateTextbox, &app->uiFont, UI_FONT_STYLE, app->uiFontSize);
+													
+													CLAY_TEXT(
+														StrLit("Duration (s):"),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiBoldFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiWhite,
+															.wrapMode = CLAY_TEXT_WRAP_NONE,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+													DoUiTextbox(&uiContext, &app->loadDurationTextbox, &app->uiFont, UI_FONT_STYLE, app->uiFontSize);
+													
+													if (IsLoadTestActive(test))
+													{
+														if (ClayBtnStrEx(StrLit("StopLoadTest"), StrLit("Stop"), Str8_Empty, (test->state == LoadTestState_Running), false, false, nullptr))
+														{
+															stopLoadTest = true;
+														} Clay__CloseElement();
+													}
+													else
+													{
+														StrErrorList loadTestErrors = NewStrErrorList(scratch, 3);
+														if (!TryParseR64(app->loadRateTextbox.text, &loadTestRate, nullptr) || loadTestRate <= 0.0) { AddStrError(&loadTestErrors, RangeUXX_Zero, StrLit("Rate must be a positive number")); }
+														if (!TryParseR64(app->loadDurationTextbox.text, &loadTestDuration, nullptr) || loadTestDuration <= 0.0) { AddStrError(&loadTestErrors, RangeUXX_Zero, StrLit("Duration must be a positive number")); }
+														if (selectedHistory == nullptr) { AddStrError(&loadTestErrors, RangeUXX_Zero, StrLit("Select a history item to run")); }
+														if (ClayBtnStrEx(StrLit("StartLoadTest"), StrLit("Start"), Str8_Empty, true, (loadTestErrors.numErrors > 0), false, nullptr))
+														{
+															if (loadTestErrors.numErrors == 0) { startLoadTest = true; }
+														} Clay__CloseElement();
+														DoErrorHoverable(&uiContext, StrLit("Btn_StartLoadTest"), &loadTestErrors, false);
+													}
+												}
+												
+												if (test->state != LoadTestState_None)
+												{
+													u64 nowUs = (test->state == LoadTestState_Finished) ? test->endTimeUs : SysGetTimeUs();
+													r64 elapsedSeconds = (nowUs > test->startTimeUs) ? (r64)(nowUs - test->startTimeUs) / 1000000.0 : 0.0;
+													r64 plannedSeconds = (r64)test->totalRequests / test->requestsPerSecond;
+													r64 throughput = (elapsedSeconds > 0.0) ? (r64)test->numCompleted / elapsedSeconds : 0.0;
+													
+													CLAY_TEXT(
+														PrintInArenaStr(uiArena, "%s %.*s", GetHttpVerbStr(test->verb), StrPrint(test->url)),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiBoldFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiWhite,
+															.wrapMode = CLAY_TEXT_WRAP_WORDS,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+													
+													Str8 statLines[] = {
+														PrintInArenaStr(uiArena, "  %s: %.1fs / %.1fs", GetLoadTestStateStr(test->state), elapsedSeconds, plannedSeconds),
+														PrintInArenaStr(uiArena, "  Sent %llu / %llu, Completed %llu, In Flight %llu (max %llu)", test->numSent, test->totalRequests, test->numCompleted, test->numSent - test->numCompleted, test->maxInFlight),
+														PrintInArenaStr(uiArena, "  Failed %llu, Non-2xx %llu", test->numFailed, test->numNon2xx),
+														PrintInArenaStr(uiArena, "  Throughput %.1f req/s (target %g req/s), %.1f kB/s", throughput, test->requestsPerSecond, (elapsedSeconds > 0.0) ? ((r64)test->totalResponseBytes / 1024.0) / elapsedSeconds : 0.0),
+													};
+													for (uxx lIndex = 0; lIndex < ArrayCount(statLines); lIndex++)
+													{
+														CLAY_TEXT(
+															statLines[lIndex],
+															CLAY_TEXT_CONFIG({
+																.fontId = app->clayUiFontId,
+																.fontSize = (u16)app->uiFontSize,
+																.textColor = (lIndex == 2 && (test->numFailed > 0 || test->numNon2xx > 0)) ? MonokaiOrange : MonokaiWhite,
+																.wrapMode = CLAY_TEXT_WRAP_WORDS,
+																.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+														}));
+													}
+													
+													CLAY({ .layout = { .sizing = { .height = CLAY_SIZING_FIXED(UI_R32(15)) } } }) { }
+													
+													CLAY_TEXT(
+														StrLit("Latency (from scheduled send) / Service Time (from actual send):"),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiBoldFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiWhite,
+															.wrapMode = CLAY_TEXT_WRAP_WORDS,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+													
+													const char* percentileNames[] = { "p50", "p90", "p99", "p99.9", "max" };
+													r64 percentiles[] = { 50.0, 90.0, 99.0, 99.9, 100.0 };
+													for (uxx pIndex = 0; pIndex < ArrayCount(percentiles); pIndex++)
+													{
+														CLAY_TEXT(
+															PrintInArenaStr(uiArena, "  %-6s %10.3fms / %10.3fms",
+																percentileNames[pIndex],
+																GetLatencyPercentile(&test->latency, percentiles[pIndex]) / 1000.0,
+																GetLatencyPercentile(&test->serviceTime, percentiles[pIndex]) / 1000.0
+															),
+															CLAY_TEXT_CONFIG({
+																.fontId = app->clayUiFontId,
+																.fontSize = (u16)app->uiFontSize,
+																.textColor = MonokaiWhite,
+																.wrapMode = CLAY_TEXT_WRAP_NONE,
+																.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+														}));
+													}
+												}
+												else
+												{
+													CLAY_TEXT(
+														StrLit("Select a history item, pick a rate and duration, then press Start"),
+														CLAY_TEXT_CONFIG({
+															.fontId = app->clayUiFontId,
+															.fontSize = (u16)app->uiFontSize,
+															.textColor = MonokaiGray1,
+															.wrapMode = CLAY_TEXT_WRAP_WORDS,
+															.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+													}));
+												}
+												#else //!BUILD_WITH_HTTP
+												CLAY_TEXT(
+													StrLit("HTTP layer of PigCore is disabled"),
+													CLAY_TEXT_CONFIG({
+														.fontId = app->clayUiFontId,
+														.fontSize = (u16)app->uiFontSize,
+														.textColor = MonokaiOrange,
+														.wrapMode = CLAY_TEXT_WRAP_WORDS,
+														.textAlignment = CLAY_TEXT_ALIGN_LEFT,
+												}));
+												#endif //BUILD_WITH_HTTP
+											} break;
+											
 											default: 
 											{
 												CLAY_TEXT(
@@ -1423,76 +2431,106 @@ EXPORT_FUNC APP_UPDATE_DEF(AppUpdate)
 		UiTextboxClear(&app->contentValueTextbox);
 	}
 	
+	// +==============================+
+	// |       Pick Upload File       |
+	// +==============================+
+	if (clearUploadFile || pickUploadFile)
+	{
+		FilePath pickedPath = FilePath_Empty;
+		if (pickUploadFile && OsDoOpenFileDialog(scratch, &pickedPath) != Result_Success) { pickedPath = FilePath_Empty; }
+		if (clearUploadFile || !IsEmptyStr(pickedPath))
+		{
+			if (app->uploadFilePath.chars != nullptr) { FreeStr8(stdHeap, &app->uploadFilePath); }
+			app->uploadFilePath = IsEmptyStr(pickedPath) ? FilePath_Empty : AllocStr8(stdHeap, pickedPath);
+		}
+	}
+	
+	// +==============================+
+	// |       Start/Stop Load Test   |
+	// +==============================+
+	#if BUILD_WITH_HTTP
+	if (stopLoadTest) { StopLoadTest(&app->loadTest); }
+	HistoryItem* sourceItem = GetSelectedHistoryItem(nullptr);
+	if (startLoadTest && !IsLoadTestActive(&app->loadTest) && sourceItem != nullptr)
+	{
+		MaterializeHistoryItem(&app->historyJournal, sourceItem);
+		StartLoadTest(&app->loadTest, sourceItem, loadTestRate, loadTestDuration);
+	}
+	#endif
+	
 	// +==============================+
 	// |         Make Request         |
 	// +==============================+
-	if (makeRequest)
+	if (makeRequest || downloadRequest)
 	{
 		#if BUILD_WITH_HTTP
 		if (!canMakeRequest) { app->makeRequestAttemptTime = appIn->programTime; }
 		else
 		{
 			app->makeRequestAttemptTime = 0;
-			uxx historyId = app->nextHistoryId;
-			app->nextHistoryId++;
-			
-			HttpRequestArgs args = ZEROED;
-			args.verb = app->httpVerb;
-			args.urlStr = app->urlTextbox.text;
-			args.numHeaders = app->httpHeaders.length;
-			args.headers = (Str8Pair*)app->httpHeaders.items;
-			args.contentEncoding = MimeType_FormUrlEncoded;
-			args.numContentItems = app->httpContent.length;
-			args.contentItems = (Str8Pair*)app->httpContent.items;
-			args.callback = HttpCallback;
-			args.contextId = historyId;
-			HttpRequest* request = OsMakeHttpRequest(platformInfo->http, &args, appIn->programTime);
-			NotNull(request);
-			
-			HistoryItem* historyItem = VarArrayAdd(HistoryItem, &app->history);
-			NotNull(historyItem);
-			ClearPointer(historyItem);
-			historyItem->arena = stdHeap;
-			historyItem->id = historyId;
-			historyItem->httpId = request->id;
-			historyItem->url = AllocStr8(stdHeap, app->urlTextbox.text);
-			historyItem->verb = app->httpVerb;
-			if (app->httpHeaders.length > 0)
+			FilePath downloadPath = FilePath_Empty;
+			bool pickedPath = true;
+			if (downloadRequest)
 			{
-				historyItem->numHeaders = app->httpHeaders.length;
-				historyItem->headers = AllocArray(Str8Pair, stdHeap, historyItem->numHeaders);
-				NotNull(historyItem->headers);
-				VarArrayLoop(&app->httpHeaders, hIndex)
-				{
-					VarArrayLoopGet(Str8Pair, entry, &app->httpHeaders, hIndex);
-					historyItem->headers[hIndex].key = AllocStr8(stdHeap, entry->key);
-					historyItem->headers[hIndex].value = AllocStr8(stdHeap, entry->value);
-				}
+				Str8Pair extensions[] = { { .key=StrLit("All Files"), .value=StrLit("*.*") } };
+				pickedPath = (OsDoSaveFileDialog(ArrayCount(extensions), &extensions[0], 0, scratch, &downloadPath) == Result_Success);
 			}
-			if (app->httpContent.length > 0)
+			if (pickedPath)
 			{
-				historyItem->numContentItems = app->httpContent.length;
-				historyItem->contentItems = AllocArray(Str8Pair, stdHeap, historyItem->numContentItems);
-				NotNull(historyItem->contentItems);
-				VarArrayLoop(&app->httpContent, hIndex)
-				{
-					VarArrayLoopGet(Str8Pair, entry, &app->httpContent, hIndex);
-					historyItem->contentItems[hIndex].key = AllocStr8(stdHeap, entry->key);
-					historyItem->contentItems[hIndex].value = AllocStr8(stdHeap, entry->value);
-				}
+				HistoryItem* historyItem = MakeHistoryRequest(app->httpVerb, app->urlTextbox.text,
+					app->httpHeaders.length, (Str8Pair*)app->httpHeaders.items,
+					app->httpContent.length, (Str8Pair*)app->httpContent.items,
+					app->uploadFilePath, downloadPath,
+					&requestTimeouts
+				);
+				
+				SelectHistoryItem(historyItem->id);
 			}
-			
-			app->historyListView.selectionActive = true;
-			FreeStr8(app->historyListView.arena, &app->historyListView.selectedIdStr);
-			app->historyListView.selectedIdStr = PrintInArenaStr(app->historyListView.arena, "History%llu", historyItem->id);
-			
-			app->historyChanged = true;
 		}
 		#else //!BUILD_WITH_HTTP
 		Notify_W("HTTP layer of PigCore is disabled");
 		#endif //BUILD_WITH_HTTP
 	}
 	
+	// +==============================+
+	// |        Cancel History        |
+	// +==============================+
+	#if BUILD_WITH_HTTP
+	HistoryItem* cancelItem = GetSelectedHistoryItem(nullptr);
+	if (cancelHistory && cancelItem != nullptr)
+	{
+		//NOTE: The item stays in-progress until the HttpService sends its Finished event (with HttpAbortReason_Canceled)
+		if (!cancelItem->finished) { platform->CancelHttpRequest(cancelItem->httpId); }
+	}
+	#endif
+	
+	// +==============================+
+	// |        Replay History        |
+	// +==============================+
+	if (replayHistory)
+	{
+		#if BUILD_WITH_HTTP
+		//NOTE: All of these get queued in the HttpService at once, the global and per-host caps decide how many actually run in parallel
+		uxx numToReplay = app->history.length;
+		for (uxx hIndex = 0; hIndex < numToReplay; hIndex++)
+		{
+			MaterializeHistoryItem(&app->historyJournal, VarArrayGet(HistoryItem, &app->history, hIndex));
+			//NOTE: MakeHistoryRequest adds to app->history, so grab a copy of the item rather than holding a pointer into the array
+			HistoryItem sourceItem = *VarArrayGet(HistoryItem, &app->history, hIndex);
+			//NOTE: Downloads are replayed into the same file, overwriting what the original request wrote
+			MakeHistoryRequest(sourceItem.verb, sourceItem.url,
+				sourceItem.numHeaders, sourceItem.headers,
+				sourceItem.numContentItems, sourceItem.contentItems,
+				sourceItem.uploadPath, sourceItem.downloadPath,
+				&requestTimeouts
+			);
+		}
+		PrintLine_D("Replaying %llu history item%s", numToReplay, Plural(numToReplay, "s"));
+		#else //!BUILD_WITH_HTTP
+		Notify_W("HTTP layer of PigCore is disabled");
+		#endif //BUILD_WITH_HTTP
+	}
+	
 	ScratchEnd(scratch);
 	ScratchEnd(scratch2);
 	ScratchEnd(scratch3);
@@ -1515,11 +2553,15 @@ EXPORT_FUNC APP_CLOSING_DEF(AppClosing)
 	igSaveIniSettingsToDisk(app->imgui->io->IniFilename);
 	#endif
 	
-	if (app->historyChanged)
+	if (app->historyChanged && !SaveHistory(&app->historyJournal, &app->historyBlobs, &app->historyWriter, &app->history))
 	{
-		SaveHistory(&app->history);
-		app->historyChanged = false;
+		//NOTE: Whatever finished while a compaction was being written still has to be appended once it's done
+		PollHistoryWriter(&app->historyJournal, &app->historyWriter, true);
+		SaveHistory(&app->historyJournal, &app->historyBlobs, &app->historyWriter, &app->history);
 	}
+	FreeHistoryWriter(&app->historyJournal, &app->historyWriter);
+	FreeHistoryCodec(&app->historyCodec);
+	app->historyChanged = false;
 	
 	ScratchEnd(scratch);
 	ScratchEnd(scratch2);
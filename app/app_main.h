@@ -15,6 +15,7 @@ enum ResultTab
 	ResultTab_JSON,
 	ResultTab_Image,
 	ResultTab_Meta,
+	ResultTab_LoadTest,
 	ResultTab_Count,
 };
 const char* GetResultTabStr(ResultTab enumValue)
@@ -25,10 +26,41 @@ const char* GetResultTabStr(ResultTab enumValue)
 		case ResultTab_JSON:  return "JSON";
 		case ResultTab_Image: return "Image";
 		case ResultTab_Meta:  return "Meta";
+		case ResultTab_LoadTest: return "Load";
 		default: return UNKNOWN_STR;
 	}
 }
 
+//NOTE: The bytes live directly after the ResponseChunk in the same allocation
+typedef plex ResponseChunk ResponseChunk;
+plex ResponseChunk
+{
+	ResponseChunk* next;
+	uxx offset; //of its first byte in the body
+	uxx length;
+	uxx capacity;
+	u8* bytes;
+};
+
+// One copy of a response body, shared by every finished item that got exactly these bytes (see FinishHistoryResponse).
+// They're only freed when history is cleared. Until then one whose refCount hits 0 just drops its chars and waits to be reused.
+// A body none of its items are showing (numAttached == 0) gets compressed by the HistoryCodec, then chars is empty until one of them is selected again
+typedef plex HistoryBody HistoryBody;
+plex HistoryBody
+{
+	Arena* arena;
+	u64 hash;
+	uxx refCount;
+	uxx length; //of the raw bytes, still valid while compressed
+	Str8 chars;
+	uxx numAttached; //items whose response points at chars right now (see DetachHistoryResponse)
+	Str8 compressed; //LzCompress output. It's kept after decompressing, so chars can be dropped again as soon as nobody is showing it (see TrimHistoryBody)
+	bool compressFailed; //it wasn't worth compressing, so we don't try again
+	bool decompressFailed;
+	bool isQueued; //in the HistoryCodec's compressQueue
+	bool inCodec; //handed to the HistoryCodec, neither chars nor compressed can be freed until PollHistoryCodec sees it come back
+};
+
 typedef plex HistoryItem HistoryItem;
 plex HistoryItem
 {
@@ -41,14 +73,430 @@ plex HistoryItem
 	Str8Pair* headers;
 	uxx numContentItems;
 	Str8Pair* contentItems;
+	//NOTE: url, uploadPath, downloadPath and the headers and contentItems (arrays and strings) all live in this one allocation
+	// from arena (see PackHistoryItemData) so an item costs the same couple of frees no matter how many headers it has
+	char* dataBlock;
+	uxx dataBlockSize;
 	
 	bool finished;
 	bool failed; //i.e. didn't connect or get a response, separate from responseStatusCode being a "failure"
 	Result failureReason;
 	u16 responseStatusCode;
-	Str8 response;
+	bool hasTimings;
+	u64 phaseDurationsUs[HttpPhase_Count]; //HTTP_PHASE_UNKNOWN for phases the backend couldn't observe
+	Str8 response; //contiguous part of the body, everything once finished (see app_response.c)
+	HistoryBody* sharedBody; //once finished (and not loaded from a blob) response points at this body, which other items may share
+	bool responseDetached; //response was emptied (the sharedBody reference is kept) so the body can be compressed, see AttachHistoryResponse
+	ResponseChunk* firstResponseChunk; //the body while it's still streaming in, joined into response once finished
+	ResponseChunk* lastResponseChunk;
+	VarArray responseLineStarts; //uxx, offset of the byte after each '\n' in the chunks. Only initialized while there are chunks, see GetStreamingResponseLine
+	uxx responseLength; //total bytes received so far
+	u64 firstResponseByteTimeUs;
+	u64 lastResponseByteTimeUs;
+	bool hasResponseLargeText;
 	UiLargeText responseLargeText;
-	VarArray responseHeaders; //Str8Pair
+	uxx responseLargeTextNumLines; //counted when it's built, only used to estimate memory usage
+	uxx numResponseHeaders;
+	Str8Pair* responseHeaders; //the array and its strings are one allocation of responseHeadersBlockSize, see SetHistoryResponseHeaders
+	uxx responseHeadersBlockSize;
+	
+	Str8 uploadPath; //the request body was this file rather than contentItems
+	//NOTE: When downloadPath is set the body went straight to that file and response stays empty. responseLength is still the size
+	Str8 downloadPath;
+	u64 downloadHash; //UpdateHttpContentHash of the file's contents, only valid once finished
+	//NOTE: Gzip/Deflate bodies were decoded before they got to us, so response and responseLength are always the decoded body
+	HttpContentEncoding responseEncoding;
+	uxx encodedResponseLength; //body size as it came over the wire, only filled in once finished
+	HttpAbortReason abortReason; //canceled or timed out, failureReason is Result_Failure when this is set
+	
+	//NOTE: Finished items get their body and response headers written to the HistoryBlobStore when they're saved.
+	// Items loaded from disk don't touch theirs until they're selected, and then response points straight into blobMapping
+	bool hasBlob;
+	bool blobLoaded;
+	u64 blobOffset;
+	uxx blobHeadersSize;
+	FileMapping blobMapping;
+	bool blobBodyShared; //the body is in the record at blobBodyOffset (written for another item), this item's record only has headers
+	u64 blobBodyOffset;
+	u64 lastViewedTime; //programTime the item was last selected, the least recently viewed bodies are evicted first (see EnforceHistoryMemoryBudget)
+	
+	//NOTE: Items loaded through the history index start out with only the fields the index holds, and url pointing
+	// into HistoryJournal.historyMapping. MaterializeHistoryItem parses the rest out of history.txt once it's needed
+	bool needsMaterialize;
+	Str8 indexedText; //the item's lines in the mapped history.txt, compaction copies these as-is until it's materialized
+	u64 indexedLatencyUs; //what the index had for GetHistoryItemLatencyUs, since phaseDurationsUs aren't parsed until we materialize
+	u32 indexedHostIndex; //into HistoryJournal.indexedHosts, see GetLoadedHistoryItemHost
+	u64 urlHash; //UpdateHttpContentHash of the url
+	u64 bodyHash; //UpdateHttpContentHash of the body (downloadHash for downloads), 0 until finished or for items saved before we kept it
+	bool bodyChanged; //the previous finished run of the same verb and url got a different body (see TrackHistoryRequestBody)
+};
+
+// history.txt is only rewritten when we compact. In between, each item is appended to the journal once it finishes.
+// Loading reads history.txt and then the journal, so an item is in exactly one of the two. Both files start with the
+// generation they belong to, and a journal from an older generation than history.txt is skipped since its items were
+// already folded in (a crash after history.txt was replaced but before the journal got emptied)
+typedef plex HistoryJournal HistoryJournal;
+plex HistoryJournal
+{
+	VarArray pending; //uxx, indices into app->history of finished items that haven't been appended yet
+	bool needsCompaction; //set when items are removed, the journal can't express that so the next save rewrites everything
+	u64 generation; //of history.txt, every compaction writes the next one. Files from before we kept this are generation 0
+	uxx historyFileSize; //bytes in history.txt as of the last compaction
+	uxx journalFileSize; //bytes appended since then
+	
+	FileMapping historyMapping; //history.txt as it was at startup, kept mapped while any item still needsMaterialize
+	uxx numUnmaterialized;
+	
+	//NOTE: The index's hosts, so the HistoryColumns can be built at startup without reading a single url out of
+	// history.txt. Only kept until they have been (see FreeHistoryIndexHosts)
+	Arena* arena;
+	Str8 indexedHostChars;
+	VarArray indexedHosts; //Str8, slices of indexedHostChars
+};
+
+// Compaction happens on this thread. The UI thread hands it a snapshot, a shallow copy of every finished item, and the
+// writer only ever reads that. The snapshot's strings still belong to the items, so no history item gets freed while
+// isBusy (Clear waits for the writer first). Items that finish in the meantime stay pending until it's done
+typedef plex HistoryWriter HistoryWriter;
+plex HistoryWriter
+{
+	Arena* arena;
+	FilePath historyFilePath;
+	FilePath journalFilePath;
+	FilePath indexFilePath;
+	bool isBusy; //only touched by the UI thread, set when work is handed over and cleared once PollHistoryWriter sees it finish
+	SysWorker worker;
+	
+	//NOTE: Everything below is protected by mutex. snapshot is only written by the UI thread while !isBusy
+	Mutex mutex;
+	bool hasWork;
+	bool isDone;
+	bool succeeded;
+	bool emptiedJournal; //if history.txt was written but the journal couldn't be emptied, nothing can be appended to it until we compact again
+	uxx historyFileSize;
+	u64 generation; //what the snapshot gets written as, set along with it
+	VarArray snapshot; //HistoryItem
+};
+
+// Compresses and decompresses HistoryBodies on its own thread, one at a time. The UI thread allocates each job's output
+// and only touches the job (or the body's chars/compressed) again once PollHistoryCodec sees it finish
+typedef plex HistoryCodec HistoryCodec;
+plex HistoryCodec
+{
+	Arena* arena;
+	bool isBusy; //only touched by the UI thread, like everything up to the mutex
+	HistoryBody* jobBody;
+	VarArray compressQueue; //HistoryBody*, bodies that lost their last attached item. Entries can go stale, they're checked again when started
+	uxx compressQueueReadIndex;
+	uxx numCompressed;
+	uxx numDecompressed;
+	u32* hashTable; //LZ_HASH_SIZE, only touched by the codec thread
+	SysWorker worker;
+	
+	//NOTE: Everything below is protected by mutex. The job fields are only written by the UI thread while !isBusy
+	Mutex mutex;
+	bool hasWork;
+	bool isDone;
+	bool succeeded;
+	bool jobIsCompress;
+	Str8 jobInput;
+	char* jobOutput;
+	uxx jobOutputCapacity;
+	uxx jobOutputSize;
+};
+
+// The index is written next to history.txt every time we compact. It's this header followed by numItems entries, then
+// numHosts HistoryIndexHost and the hostCharsSize bytes they point into, so startup can create every item (and its
+// HistoryColumns row) without parsing (or even reading) history.txt
+#define HISTORY_INDEX_MAGIC   0x58444948 //"HIDX"
+#define HISTORY_INDEX_VERSION 6 //2: textLength no longer includes the blank line after each item, 3: added bodyHash, 4: added responseLength and latencyUs, 5: added hosts, 6: added generation
+typedef plex HistoryIndexHeader HistoryIndexHeader;
+plex HistoryIndexHeader
+{
+	u32 magic;
+	u32 version;
+	u64 numItems;
+	u64 historyFileSize; //the index only applies to a history.txt of exactly this size
+	u64 generation; //and of this generation, so an index left over from an earlier compaction is never trusted
+	u64 numHosts;
+	u64 hostCharsSize;
+};
+
+#define HISTORY_INDEX_FLAG_FAILED 0x01
+typedef plex HistoryIndexEntry HistoryIndexEntry;
+plex HistoryIndexEntry
+{
+	u64 textOffset;
+	u32 textLength;
+	u32 urlOffset; //from textOffset
+	u32 urlLength;
+	u16 statusCode;
+	u8 verb; //HttpVerb
+	u8 flags; //HISTORY_INDEX_FLAG_
+	u32 hostIndex; //which HistoryIndexHost is GetUrlHost of the url
+	u32 reserved;
+	u64 urlHash;
+	u64 bodyHash;
+	u64 responseLength;
+	u64 latencyUs; //GetHistoryItemLatencyUs
+};
+
+typedef plex HistoryIndexHost HistoryIndexHost;
+plex HistoryIndexHost
+{
+	u32 offset; //into the host chars that follow the last HistoryIndexHost
+	u32 length;
+};
+
+// Maps a u64 key to a uxx value, e.g. an id (or httpId) to that item's index in app->history. Open addressing with linear
+// probing, and since entries are only ever removed all at once (Clear) there's no need for tombstones. Keys are never 0, which marks an empty slot
+#define HISTORY_LOOKUP_MIN_CAPACITY 256 //must be a power of 2
+typedef plex HistoryLookupSlot HistoryLookupSlot;
+plex HistoryLookupSlot
+{
+	u64 key;
+	uxx value;
+};
+typedef plex HistoryLookup HistoryLookup;
+plex HistoryLookup
+{
+	Arena* arena;
+	uxx numEntries;
+	uxx capacity; //always a power of 2, and kept at least twice numEntries
+	u8 capacityBits;
+	HistoryLookupSlot* slots;
+};
+
+// Scratch bookkeeping for EnforceHistoryMemoryBudget, one per item whose body could be evicted
+typedef plex HistoryEvictCandidate HistoryEvictCandidate;
+plex HistoryEvictCandidate
+{
+	uxx historyIndex;
+	u64 lastViewedTime;
+};
+
+// Shared by every worker in TryDeserializeHistoryList. Each item is parsed into its own slot so merging is just a copy in order
+typedef plex HistoryParseContext HistoryParseContext;
+plex HistoryParseContext
+{
+	Str8 fileContents;
+	uxx numItems;
+	const uxx* itemStarts; //numItems+1, the last one is fileContents.length
+	Arena* workerArenas[SYS_PARALLEL_MAX_WORKERS];
+	HistoryItem* items;
+	Result* results;
+};
+
+// Each record in HISTORY_BLOBS_FILENAME is one of these followed by the body and then the headers (a u32 length
+// and the bytes for each key and value). Records are only ever appended, the file starts over when history is cleared
+#define HISTORY_BLOB_MAGIC 0x4C425243 //"CRBL"
+typedef plex HistoryBlobHeader HistoryBlobHeader;
+plex HistoryBlobHeader
+{
+	u32 magic;
+	u32 numResponseHeaders;
+	u64 bodySize;
+	u64 headersSize;
+};
+
+typedef plex HistoryBlobStore HistoryBlobStore;
+plex HistoryBlobStore
+{
+	FilePath filePath;
+	u64 fileSize; //where the next record will go
+	bool writeFailed; //we don't know where the end of the file is anymore, so nothing else gets written this session
+	HistoryLookup bodyOffsets; //bodyHash -> blobOffset of a record written this session that holds that body
+};
+
+// One trigram's posting list: the history index of every item whose text has it, ascending and without repeats
+typedef plex HistorySearchPostings HistorySearchPostings;
+plex HistorySearchPostings
+{
+	uxx count;
+	uxx capacity;
+	u32* itemIndices;
+};
+
+// The index behind the history search box, see app_search.c
+typedef plex HistorySearch HistorySearch;
+plex HistorySearch
+{
+	Arena* arena;
+	HistoryLookup trigrams; //trigram+1 -> index in postings (0 is a valid trigram but not a valid key)
+	VarArray postings; //HistorySearchPostings
+	u8* seenTrigrams; //HISTORY_SEARCH_NUM_TRIGRAMS bits, only set while an item is being indexed
+	uxx numToBackfill; //items loaded from disk, these get indexed by BackfillHistorySearch
+	uxx numBackfilled;
+	
+	Str8 query; //lowercased
+	bool resultsDirty;
+	VarArray results; //uxx, history indices that match query in ascending order
+};
+
+typedef enum HistoryStatusFilter HistoryStatusFilter;
+enum HistoryStatusFilter
+{
+	HistoryStatusFilter_All = 0,
+	HistoryStatusFilter_2xx,
+	HistoryStatusFilter_3xx,
+	HistoryStatusFilter_4xx,
+	HistoryStatusFilter_5xx,
+	HistoryStatusFilter_Failed, //never got a response
+	HistoryStatusFilter_InProgress,
+	HistoryStatusFilter_Count,
+};
+const char* GetHistoryStatusFilterStr(HistoryStatusFilter enumValue)
+{
+	switch (enumValue)
+	{
+		case HistoryStatusFilter_All:        return "All";
+		case HistoryStatusFilter_2xx:        return "2xx";
+		case HistoryStatusFilter_3xx:        return "3xx";
+		case HistoryStatusFilter_4xx:        return "4xx";
+		case HistoryStatusFilter_5xx:        return "5xx";
+		case HistoryStatusFilter_Failed:     return "Failed";
+		case HistoryStatusFilter_InProgress: return "In Progress";
+		default: return UNKNOWN_STR;
+	}
+}
+
+typedef enum HistorySort HistorySort;
+enum HistorySort
+{
+	HistorySort_Newest = 0,
+	HistorySort_Slowest,
+	HistorySort_Largest,
+	HistorySort_Count,
+};
+const char* GetHistorySortStr(HistorySort enumValue)
+{
+	switch (enumValue)
+	{
+		case HistorySort_Newest:  return "Newest";
+		case HistorySort_Slowest: return "Slowest";
+		case HistorySort_Largest: return "Largest";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// The handful of fields the history list filters and sorts on, one array per field indexed the same as app->history
+// (see app_columns.c). A scan over millions of items only touches the columns it needs instead of every HistoryItem
+#define HISTORY_COLUMN_FLAG_FINISHED 0x01
+#define HISTORY_COLUMN_FLAG_FAILED   0x02
+#define HISTORY_COLUMN_NOT_LISTED    UINT32_MAX //listRows value for items the HistoryView filtered out
+typedef plex HistoryColumns HistoryColumns;
+plex HistoryColumns
+{
+	Arena* arena;
+	uxx count;
+	uxx capacity;
+	u8* verbs; //HttpVerb
+	u16* statusCodes;
+	u8* flags; //HISTORY_COLUMN_FLAG_
+	u64* latenciesUs; //HTTP_PHASE_UNKNOWN for items without timings
+	u64* sizes; //responseLength
+	u32* hostIndices; //into hosts
+	u32* listRows; //row in the HistoryView (or HISTORY_COLUMN_NOT_LISTED), only valid while the view isActive
+	
+	VarArray hosts; //Str8, every distinct host in a url
+	HistoryLookup hostLookup; //GetHistoryHostKey -> index in hosts
+};
+
+// Decides which items the history list shows and in what order. Built from HistoryColumns and the search results
+typedef plex HistoryView HistoryView;
+plex HistoryView
+{
+	Arena* arena;
+	HistoryStatusFilter statusFilter;
+	HttpVerb verbFilter; //HttpVerb_None for every verb
+	Str8 hostFilter; //lowercased, items whose host contains this
+	HistorySort sort;
+	bool settingsChanged; //rebuilt before the next frame is drawn
+	bool historyChanged; //items were added or finished, rebuilt at most every HISTORY_VIEW_REBUILD_INTERVAL
+	u64 lastBuildTime;
+	bool isActive; //rows is what the list shows, otherwise it's all of history newest first
+	VarArray rows; //u32, history indices in the order they're listed
+};
+
+typedef enum LoadTestState LoadTestState;
+enum LoadTestState
+{
+	LoadTestState_None = 0,
+	LoadTestState_Running, //still issuing requests on schedule
+	LoadTestState_Draining, //all requests issued (or stopped early), waiting on the stragglers
+	LoadTestState_Finished,
+	LoadTestState_Count,
+};
+const char* GetLoadTestStateStr(LoadTestState enumValue)
+{
+	switch (enumValue)
+	{
+		case LoadTestState_None:     return "None";
+		case LoadTestState_Running:  return "Running";
+		case LoadTestState_Draining: return "Draining";
+		case LoadTestState_Finished: return "Finished";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Load test requests don't create HistoryItems. Their contextIds have the top bit set,
+// the run index in the next 15 bits and the request's sequence number in the bottom 48
+#define LOAD_TEST_CONTEXT_FLAG  0x8000000000000000ULL
+#define LOAD_TEST_RUN_SHIFT     48
+#define LOAD_TEST_RUN_MASK      0x7FFFULL
+#define LOAD_TEST_SEQUENCE_MASK 0x0000FFFFFFFFFFFFULL
+
+typedef plex LoadTest LoadTest;
+plex LoadTest
+{
+	Arena* arena;
+	LoadTestState state;
+	u64 runIndex;
+	
+	//Copied out of the HistoryItem when the test starts, so clearing history mid-test is fine
+	u64 sourceHistoryId;
+	HttpVerb verb;
+	Str8 url;
+	uxx numHeaders;
+	Str8Pair* headers;
+	uxx numContentItems;
+	Str8Pair* contentItems;
+	Str8 uploadPath;
+	
+	r64 requestsPerSecond;
+	u64 totalRequests;
+	u64 startTimeUs;
+	u64 endTimeUs; //set when we move to Finished
+	
+	u64 numSent;
+	u64 numCompleted;
+	u64 numFailed; //didn't connect or get a response
+	u64 numNon2xx;
+	u64 maxInFlight;
+	u64 totalResponseBytes;
+	
+	//NOTE: latency is measured from each request's intended send time (open model) so a slow server
+	// pushing requests back in the queue shows up in the tail rather than hiding it (coordinated omission)
+	// serviceTime is measured from when the request actually started, the gap between the two is queueing
+	LatencyHistogram latency;
+	LatencyHistogram serviceTime;
+};
+
+typedef plex VirtualListView VirtualListView;
+// void RenderVirtualListRow(VirtualListView* list, void* userPntr, uxx rowIndex, bool isSelected, bool isHovered)
+#define VIRTUAL_LIST_ROW_RENDER_DEF(functionName) void functionName(VirtualListView* list, void* userPntr, uxx rowIndex, bool isSelected, bool isHovered)
+typedef VIRTUAL_LIST_ROW_RENDER_DEF(VirtualListRowRender_f);
+
+// A list that only builds the rows that are on screen, see app_virtual_list.c. The scroll position lives in Clay's scroll container
+plex VirtualListView
+{
+	Arena* arena;
+	Str8 idStr;
+	bool selectionActive;
+	uxx selectionIndex; //row, not whatever the caller maps rows to
+	bool selectionChanged; //set when the user clicks a row, the caller clears it
+	bool scrollToSelection; //scrolls just far enough to show the selected row next time the list is laid out
+	bool selectionDisabled; //rows can't be clicked or hovered, for lists that are only for reading
 };
 
 typedef struct AppData AppData;
@@ -87,19 +535,48 @@ struct AppData
 	bool editedContentInputSinceFilled;
 	UiTextbox contentKeyTextbox;
 	UiTextbox contentValueTextbox;
-	UiListView historyListView;
+	VirtualListView historyListView;
+	VirtualListView responsePreviewList; //the Raw tab for a body that's still streaming in
+	uxx selectedHistoryIndex; //UINTXX_MAX when nothing is selected
 	u64 makeRequestAttemptTime;
 	
 	VarArray httpHeaders; //Str8Pair
 	VarArray httpContent; //Str8Pair
+	FilePath uploadFilePath; //when set this file is the request body and httpContent is ignored
 	
 	u64 nextHistoryId;
 	VarArray history; //HistoryItem
+	HistoryLookup historyById;
+	HistoryLookup historyByHttpId;
+	HistoryLookup historyBodies; //bodyHash -> HistoryBody*
+	HistoryLookup historyByRequest; //GetHistoryRequestKey -> index of the last finished item with that verb and url
+	HistoryJournal historyJournal;
+	HistoryBlobStore historyBlobs;
+	HistoryWriter historyWriter;
+	HistoryCodec historyCodec;
+	HistorySearch historySearch;
+	UiTextbox historySearchTextbox;
+	HistoryColumns historyColumns;
+	HistoryView historyView;
+	UiTextbox historyHostTextbox;
 	bool historyChanged;
 	uxx lastHistorySaveTime;
+	uxx historyMemoryBudget; //bytes, 0 means bodies are never evicted
+	uxx historyMemoryUsage; //as of the last EnforceHistoryMemoryBudget
+	u64 lastHistoryMemoryCheckTime;
+	uxx numHistoryEvictions;
 	
 	ResultTab currentResultTab;
 	UiLargeTextView responseTextView;
+	
+	LoadTest loadTest;
+	UiTextbox loadRateTextbox;
+	UiTextbox loadDurationTextbox;
+	
+	UiTextbox connectTimeoutTextbox;
+	UiTextbox firstByteTimeoutTextbox;
+	UiTextbox idleTimeoutTextbox;
+	UiTextbox totalTimeoutTextbox;
 };
 
 #endif //  _APP_MAIN_H
@@ -0,0 +1,274 @@
+/*
+File:   app_response.c
+Date:   10\16\2026
+Description:
+	** Holds the functions that manage a HistoryItem's response body. While a request is
+	** in progress new bytes get appended to a list of chunks (no realloc-and-copy as the
+	** body grows) and the chunks are only joined into the contiguous response once, when
+	** the request finishes. The Raw tab previews the body while it streams by keeping an
+	** index of where each line starts and reading the lines on screen out of the chunks
+*/
+
+ResponseChunk* AllocResponseChunk(Arena* arena, uxx capacity)
+{
+	ResponseChunk* chunk = (ResponseChunk*)AllocMem(arena, sizeof(ResponseChunk) + capacity);
+	NotNull(chunk);
+	ClearPointer(chunk);
+	chunk->capacity = capacity;
+	chunk->bytes = (u8*)(chunk + 1);
+	return chunk;
+}
+
+void FreeResponseChunks(HistoryItem* item)
+{
+	if (item->firstResponseChunk != nullptr) { FreeVarArray(&item->responseLineStarts); }
+	ResponseChunk* chunk = item->firstResponseChunk;
+	while (chunk != nullptr)
+	{
+		ResponseChunk* nextChunk = chunk->next;
+		FreeMem(item->arena, chunk, sizeof(ResponseChunk) + chunk->capacity);
+		chunk = nextChunk;
+	}
+	item->firstResponseChunk = nullptr;
+	item->lastResponseChunk = nullptr;
+}
+
+// Drops one item's reference. The HistoryBody itself stays in its lookup so an identical body arriving later can reuse it.
+// If the HistoryCodec is working on it, FinishHistoryCodecJob frees the memory instead
+void ReleaseHistoryBody(HistoryBody* body)
+{
+	NotNull(body);
+	Assert(body->refCount > 0);
+	body->refCount--;
+	if (body->refCount == 0 && !body->inCodec)
+	{
+		if (body->chars.chars != nullptr) { FreeArray(char, body->arena, body->chars.length, body->chars.chars); }
+		if (body->compressed.chars != nullptr) { FreeArray(char, body->arena, body->compressed.length, body->compressed.chars); }
+		body->chars = Str8_Empty;
+		body->compressed = Str8_Empty;
+	}
+}
+
+//NOTE: response is always allocated with AllocArray(char) (rather than AllocStr8) since JoinHistoryResponseChunks builds it in place
+void FreeHistoryResponse(HistoryItem* item)
+{
+	NotNull(item);
+	FreeResponseChunks(item);
+	//NOTE: A body loaded from the HistoryBlobStore points into the mapping rather than being allocated
+	if (item->blobMapping.isMapped) { platform->UnmapFile(&item->blobMapping); }
+	else if (item->sharedBody != nullptr)
+	{
+		if (!item->responseDetached) { Assert(item->sharedBody->numAttached > 0); item->sharedBody->numAttached--; }
+		ReleaseHistoryBody(item->sharedBody);
+	}
+	else if (item->response.chars != nullptr) { FreeArray(char, item->arena, item->response.length, item->response.chars); }
+	item->sharedBody = nullptr;
+	item->responseDetached = false;
+	item->response = Str8_Empty;
+	item->responseLength = 0;
+	if (item->hasResponseLargeText) { FreeUiLargeText(&item->responseLargeText); }
+	item->hasResponseLargeText = false;
+	item->responseLargeTextNumLines = 0;
+}
+
+void SetHistoryResponse(HistoryItem* item, Str8 response)
+{
+	NotNull(item);
+	FreeHistoryResponse(item);
+	if (response.length > 0)
+	{
+		char* chars = AllocArray(char, item->arena, response.length);
+		NotNull(chars);
+		MyMemCopy(chars, response.chars, response.length);
+		item->response = MakeStr8(response.length, chars);
+	}
+	item->responseLength = response.length;
+}
+
+void AppendHistoryResponseBytes(HistoryItem* item, Str8 bytes)
+{
+	NotNull(item);
+	uxx offset = 0;
+	while (offset < bytes.length)
+	{
+		ResponseChunk* chunk = item->lastResponseChunk;
+		if (chunk == nullptr || chunk->length >= chunk->capacity)
+		{
+			//NOTE: Chunks grow with the response, so small bodies stay small and huge ones don't turn into thousands of tiny nodes
+			uxx capacity = item->responseLength;
+			if (capacity < RESPONSE_MIN_CHUNK_SIZE) { capacity = RESPONSE_MIN_CHUNK_SIZE; }
+			if (capacity > RESPONSE_MAX_CHUNK_SIZE) { capacity = RESPONSE_MAX_CHUNK_SIZE; }
+			ResponseChunk* newChunk = AllocResponseChunk(item->arena, capacity);
+			newChunk->offset = item->responseLength;
+			if (chunk != nullptr) { chunk->next = newChunk; }
+			else { item->firstResponseChunk = newChunk; InitVarArray(uxx, &item->responseLineStarts, item->arena); }
+			item->lastResponseChunk = newChunk;
+			chunk = newChunk;
+		}
+		uxx numBytesToCopy = chunk->capacity - chunk->length;
+		if (numBytesToCopy > bytes.length - offset) { numBytesToCopy = bytes.length - offset; }
+		MyMemCopy(&chunk->bytes[chunk->length], &bytes.chars[offset], numBytesToCopy);
+		for (uxx cIndex = 0; cIndex < numBytesToCopy; )
+		{
+			const char* newLine = (const char*)memchr(&bytes.chars[offset + cIndex], '\n', numBytesToCopy - cIndex);
+			if (newLine == nullptr) { break; }
+			cIndex = (uxx)(newLine - &bytes.chars[offset]) + 1;
+			uxx* lineStart = VarArrayAdd(uxx, &item->responseLineStarts);
+			NotNull(lineStart);
+			*lineStart = item->responseLength + cIndex;
+		}
+		chunk->length += numBytesToCopy;
+		offset += numBytesToCopy;
+		item->responseLength += numBytesToCopy;
+	}
+}
+
+uxx GetStreamingResponseNumLines(const HistoryItem* item)
+{
+	NotNull(item);
+	return (item->firstResponseChunk != nullptr) ? item->responseLineStarts.length + 1 : 0;
+}
+
+// Reads one line of a body that's still streaming in (without its newline), at most maxLength bytes of it. Lines that sit
+// inside one chunk are returned in place, only one that straddles a chunk boundary gets copied into arena
+Str8 GetStreamingResponseLine(Arena* arena, const HistoryItem* item, uxx lineIndex, uxx maxLength)
+{
+	NotNull(arena);
+	NotNull(item);
+	Assert(item->response.length == 0); //bytes only move out of the chunks when the request finishes
+	Assert(lineIndex < GetStreamingResponseNumLines(item));
+	uxx lineStart = (lineIndex > 0) ? *VarArrayGet(uxx, &item->responseLineStarts, lineIndex-1) : 0;
+	uxx lineEnd = (lineIndex < item->responseLineStarts.length) ? *VarArrayGet(uxx, &item->responseLineStarts, lineIndex) - 1 : item->responseLength;
+	if (lineEnd - lineStart > maxLength) { lineEnd = lineStart + maxLength; }
+	
+	const ResponseChunk* chunk = item->firstResponseChunk;
+	while (chunk != nullptr && chunk->offset + chunk->length <= lineStart) { chunk = chunk->next; }
+	if (chunk == nullptr || lineEnd == lineStart) { return Str8_Empty; }
+	Str8 result = Str8_Empty;
+	if (lineEnd <= chunk->offset + chunk->length) { result = MakeStr8(lineEnd - lineStart, (char*)&chunk->bytes[lineStart - chunk->offset]); }
+	else
+	{
+		char* chars = AllocArray(char, arena, lineEnd - lineStart);
+		NotNull(chars);
+		uxx writeIndex = 0;
+		for (; chunk != nullptr && lineStart + writeIndex < lineEnd; chunk = chunk->next)
+		{
+			uxx readIndex = (lineStart + writeIndex) - chunk->offset;
+			uxx numBytes = MinUXX(chunk->length - readIndex, lineEnd - (lineStart + writeIndex));
+			MyMemCopy(&chars[writeIndex], &chunk->bytes[readIndex], numBytes);
+			writeIndex += numBytes;
+		}
+		result = MakeStr8(writeIndex, chars);
+	}
+	if (result.length > 0 && result.chars[result.length-1] == '\r') { result.length--; }
+	return result;
+}
+
+// Makes response hold the whole body. Only done once, when the request finishes (see FinishHistoryResponse), since the
+// finished body is kept (and shared, compressed and saved) as one block. Chunks are freed as they're copied so the peak is one body plus one chunk
+void JoinHistoryResponseChunks(HistoryItem* item)
+{
+	NotNull(item);
+	if (item->firstResponseChunk == nullptr) { return; }
+	Assert(item->responseLength > item->response.length);
+	Assert(!item->hasResponseLargeText); //the large text may point into the old response
+	FreeVarArray(&item->responseLineStarts);
+	
+	char* newChars = AllocArray(char, item->arena, item->responseLength);
+	NotNull(newChars);
+	uxx writeIndex = 0;
+	if (item->response.length > 0)
+	{
+		MyMemCopy(newChars, item->response.chars, item->response.length);
+		writeIndex = item->response.length;
+		FreeArray(char, item->arena, item->response.length, item->response.chars);
+	}
+	ResponseChunk* chunk = item->firstResponseChunk;
+	while (chunk != nullptr)
+	{
+		ResponseChunk* nextChunk = chunk->next;
+		MyMemCopy(&newChars[writeIndex], chunk->bytes, chunk->length);
+		writeIndex += chunk->length;
+		FreeMem(item->arena, chunk, sizeof(ResponseChunk) + chunk->capacity);
+		chunk = nextChunk;
+	}
+	Assert(writeIndex == item->responseLength);
+	item->firstResponseChunk = nullptr;
+	item->lastResponseChunk = nullptr;
+	item->response = MakeStr8(item->responseLength, newChars);
+}
+
+// Builds the UiLargeText for a body that's all in response. Bodies that are still streaming are shown from their chunks instead (see GetStreamingResponseLine)
+void RebuildHistoryResponseLargeText(HistoryItem* item)
+{
+	NotNull(item);
+	Assert(item->firstResponseChunk == nullptr);
+	if (item->hasResponseLargeText)
+	{
+		FreeUiLargeText(&item->responseLargeText);
+		item->hasResponseLargeText = false;
+	}
+	InitUiLargeText(item->arena, item->response, &item->responseLargeText);
+	item->hasResponseLargeText = true;
+	item->responseLargeTextNumLines = 1;
+	for (uxx cIndex = 0; cIndex < item->response.length; )
+	{
+		const char* newLine = (const char*)memchr(&item->response.chars[cIndex], '\n', item->response.length - cIndex);
+		if (newLine == nullptr) { break; }
+		item->responseLargeTextNumLines++;
+		cIndex = (uxx)(newLine - item->response.chars) + 1;
+	}
+}
+
+// What the item's response is costing us in RAM: the body (allocated or mapped), chunks that haven't been joined yet (and their line index),
+// the response headers and an estimate of the UiLargeText's per-line bookkeeping. A shared body (raw and/or compressed) is split evenly between the items that share it
+uxx GetHistoryResponseMemoryUsage(const HistoryItem* item)
+{
+	NotNull(item);
+	const HistoryBody* body = item->sharedBody;
+	uxx bodySize = (body != nullptr) ? (body->chars.length + body->compressed.length) / body->refCount : item->response.length;
+	uxx result = bodySize + item->responseHeadersBlockSize;
+	for (const ResponseChunk* chunk = item->firstResponseChunk; chunk != nullptr; chunk = chunk->next) { result += sizeof(ResponseChunk) + chunk->capacity; }
+	if (item->firstResponseChunk != nullptr) { result += item->responseLineStarts.length * sizeof(uxx); }
+	if (item->hasResponseLargeText) { result += item->responseLargeTextNumLines * HISTORY_LARGE_TEXT_LINE_SIZE; }
+	return result;
+}
+
+// Measured from the first Data event we saw, so a body that arrives all at once reports 0
+r64 GetHistoryResponseBytesPerSecond(const HistoryItem* item, u64 nowUs)
+{
+	NotNull(item);
+	u64 endTimeUs = item->finished ? item->lastResponseByteTimeUs : nowUs;
+	if (item->firstResponseByteTimeUs == 0 || endTimeUs <= item->firstResponseByteTimeUs) { return 0.0; }
+	return (r64)item->responseLength / ((r64)(endTimeUs - item->firstResponseByteTimeUs) / 1000000.0);
+}
+
+// The sum of every phase we have a duration for, HTTP_PHASE_UNKNOWN when the item has no timings at all
+u64 GetHistoryItemLatencyUs(const HistoryItem* item)
+{
+	NotNull(item);
+	if (item->needsMaterialize) { return item->indexedLatencyUs; }
+	if (!item->hasTimings) { return HTTP_PHASE_UNKNOWN; }
+	u64 result = 0;
+	for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+	{
+		if (item->phaseDurationsUs[pIndex] != HTTP_PHASE_UNKNOWN) { result += item->phaseDurationsUs[pIndex]; }
+	}
+	return result;
+}
+
+Str8 FormatBytes(Arena* arena, uxx numBytes)
+{
+	if (numBytes >= Gigabytes(1)) { return PrintInArenaStr(arena, "%.2f GB", (r64)numBytes / (1024.0*1024.0*1024.0)); }
+	if (numBytes >= Megabytes(1)) { return PrintInArenaStr(arena, "%.1f MB", (r64)numBytes / (1024.0*1024.0)); }
+	if (numBytes >= Kilobytes(1)) { return PrintInArenaStr(arena, "%.1f kB", (r64)numBytes / 1024.0); }
+	return PrintInArenaStr(arena, "%llu B", (u64)numBytes);
+}
+
+Str8 FormatBytesPerSecond(Arena* arena, r64 bytesPerSecond)
+{
+	if (bytesPerSecond >= 1024.0*1024.0*1024.0) { return PrintInArenaStr(arena, "%.2f GB/s", bytesPerSecond / (1024.0*1024.0*1024.0)); }
+	if (bytesPerSecond >= 1024.0*1024.0) { return PrintInArenaStr(arena, "%.2f MB/s", bytesPerSecond / (1024.0*1024.0)); }
+	if (bytesPerSecond >= 1024.0) { return PrintInArenaStr(arena, "%.1f kB/s", bytesPerSecond / 1024.0); }
+	return PrintInArenaStr(arena, "%.0f B/s", bytesPerSecond);
+}
@@ -7,31 +7,380 @@ Description:
 	** in the AppData folder to track things like history and
 	** preferences so we can restore this information when the
 	** application is closed and re-opened
+	** History is saved as a journal: finished items are appended to
+	** HISTORY_JOURNAL_FILENAME and only once that grows large enough is
+	** everything rewritten into HISTORY_FILENAME (see SaveHistory)
+	** Response bodies and headers go in a binary HistoryBlobStore next to those. The text
+	** files only hold each item's offset into it, and a loaded item maps its record back in
+	** once it's selected, so startup never reads the bodies
+	** Compacting also writes an index of history.txt. When it's valid, startup creates each
+	** item from its fixed size entry and only parses the item's text once something needs
+	** more than the index has (see MaterializeHistoryItem)
+	** Compacting happens on the HistoryWriter thread from a snapshot of the items, and each
+	** file is replaced by writing a temp file and renaming it over the old one
+	** Every compaction bumps the generation written at the top of history.txt (and copied
+	** into the index and the journal), so a crash part way through never gets a journal's
+	** items loaded twice or an old index trusted for the new history.txt
 */
 
+FilePath GetHistoryFilePath(Arena* arena, Str8 fileName)
+{
+	ScratchBegin1(scratch, arena);
+	FilePath saveFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
+	NotNull(saveFolderPath.chars);
+	FilePath result = JoinStringsInArena3(arena, saveFolderPath, StrLit("/"), fileName, false);
+	ScratchEnd(scratch);
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                          Blob Store                          |
+// +--------------------------------------------------------------+
+void InitHistoryBlobStore(Arena* arena, HistoryBlobStore* store)
+{
+	NotNull(store);
+	ClearPointer(store);
+	store->filePath = GetHistoryFilePath(arena, StrLit(HISTORY_BLOBS_FILENAME));
+	InitHistoryLookup(arena, &store->bodyOffsets);
+	//NOTE: Nothing gets mapped here, we only want to know where the end of the file is
+	FileMapping mapping = ZEROED;
+	if (OsDoesFileExist(store->filePath) && platform->MapFile(store->filePath, 0, 0, &mapping))
+	{
+		store->fileSize = mapping.fileSize;
+		platform->UnmapFile(&mapping);
+	}
+}
+
+// Only called once nothing references the old records (i.e. after history was cleared)
+void ResetHistoryBlobStore(HistoryBlobStore* store)
+{
+	NotNull(store);
+	ScratchBegin(scratch);
+	OsFile blobFile = ZEROED;
+	if (OsOpenFile(scratch, store->filePath, OsOpenFileMode_Create, false, &blobFile))
+	{
+		OsCloseFile(&blobFile);
+		store->fileSize = 0;
+		store->writeFailed = false;
+		FreeHistoryLookup(&store->bodyOffsets);
+	}
+	else { PrintLine_E("Failed to empty history blobs at \"%.*s\"", StrPrint(store->filePath)); }
+	ScratchEnd(scratch);
+}
+
+// Body bytes in the item's own record. Downloads have their body on disk already and a shared body is in another item's record
+uxx GetHistoryBlobBodySize(const HistoryItem* item)
+{
+	return (IsEmptyStr(item->downloadPath) && !item->blobBodyShared) ? item->responseLength : 0;
+}
+
+// Maps the body of an earlier record back in to see if it holds exactly these bytes. A matching bodyHash alone isn't
+// enough to share a body, two different responses can collide. When the record can't be read we say no and the caller writes its own copy
+bool DoesHistoryBlobBodyMatch(HistoryBlobStore* store, u64 bodyOffset, Str8 body)
+{
+	NotNull(store);
+	FileMapping mapping = ZEROED;
+	bool result = (platform->MapFile(store->filePath, bodyOffset, sizeof(HistoryBlobHeader) + body.length, &mapping) && mapping.isMapped);
+	if (result)
+	{
+		HistoryBlobHeader blobHeader = ZEROED;
+		MyMemCopy(&blobHeader, mapping.contents.chars, sizeof(blobHeader));
+		result = (blobHeader.magic == HISTORY_BLOB_MAGIC && blobHeader.bodySize == body.length
+			&& MyMemEquals(&mapping.contents.chars[sizeof(HistoryBlobHeader)], body.chars, body.length));
+	}
+	platform->UnmapFile(&mapping);
+	return result;
+}
+
+// Appends a record for each of the given items that doesn't have one yet. A body we've already written this session
+// (same bodyHash and the same bytes) isn't written again, the item's record only holds its headers and points at the earlier body
+void WriteHistoryBlobs(HistoryBlobStore* store, VarArray* historyList, uxx numIndices, const uxx* indices)
+{
+	NotNull(store);
+	if (store->writeFailed || numIndices == 0) { return; }
+	ScratchBegin(scratch);
+	OsFile blobFile = ZEROED;
+	if (!OsOpenFile(scratch, store->filePath, OsOpenFileMode_Append, false, &blobFile))
+	{
+		PrintLine_E("Failed to open history blobs at \"%.*s\"", StrPrint(store->filePath));
+		ScratchEnd(scratch);
+		return;
+	}
+	
+	for (uxx iIndex = 0; iIndex < numIndices; iIndex++)
+	{
+		HistoryItem* item = VarArrayGet(HistoryItem, historyList, indices[iIndex]);
+		if (!item->finished || item->hasBlob) { continue; }
+		
+		uxx headersSize = 0;
+		for (uxx hIndex = 0; hIndex < item->numResponseHeaders; hIndex++)
+		{
+			const Str8Pair* header = &item->responseHeaders[hIndex];
+			headersSize += sizeof(u32) + header->key.length + sizeof(u32) + header->value.length;
+		}
+		u8* headerBytes = (headersSize > 0) ? AllocArray(u8, scratch, headersSize) : nullptr;
+		uxx writeIndex = 0;
+		for (uxx hIndex = 0; hIndex < item->numResponseHeaders; hIndex++)
+		{
+			const Str8Pair* header = &item->responseHeaders[hIndex];
+			Str8 parts[] = { header->key, header->value };
+			for (uxx pIndex = 0; pIndex < ArrayCount(parts); pIndex++)
+			{
+				u32 partLength = (u32)parts[pIndex].length;
+				MyMemCopy(&headerBytes[writeIndex], &partLength, sizeof(u32));
+				writeIndex += sizeof(u32);
+				if (partLength > 0) { MyMemCopy(&headerBytes[writeIndex], parts[pIndex].chars, partLength); }
+				writeIndex += partLength;
+			}
+		}
+		Assert(writeIndex == headersSize);
+		
+		//NOTE: Downloads already have their body on disk, so they only store headers here
+		Str8 body = IsEmptyStr(item->downloadPath) ? item->response : Str8_Empty;
+		Assert(item->firstResponseChunk == nullptr); //finished items always have their chunks joined
+		uxx knownBodyOffset = (body.length > 0) ? HistoryLookupFind(&store->bodyOffsets, item->bodyHash) : UINTXX_MAX;
+		uxx sharedBodyOffset = (knownBodyOffset != UINTXX_MAX && DoesHistoryBlobBodyMatch(store, (u64)knownBodyOffset, body)) ? knownBodyOffset : UINTXX_MAX;
+		if (sharedBodyOffset != UINTXX_MAX) { body = Str8_Empty; }
+		HistoryBlobHeader blobHeader = ZEROED;
+		blobHeader.magic = HISTORY_BLOB_MAGIC;
+		blobHeader.numResponseHeaders = (u32)item->numResponseHeaders;
+		blobHeader.bodySize = body.length;
+		blobHeader.headersSize = headersSize;
+		bool writeSuccess = OsWriteToOpenFile(&blobFile, MakeStr8(sizeof(blobHeader), (char*)&blobHeader), false);
+		if (writeSuccess && body.length > 0) { writeSuccess = OsWriteToOpenFile(&blobFile, body, false); }
+		if (writeSuccess && headersSize > 0) { writeSuccess = OsWriteToOpenFile(&blobFile, MakeStr8(headersSize, (char*)headerBytes), false); }
+		if (!writeSuccess)
+		{
+			PrintLine_E("Failed to write history blob to \"%.*s\", responses won't be saved until restart", StrPrint(store->filePath));
+			store->writeFailed = true;
+			break;
+		}
+		
+		item->hasBlob = true;
+		item->blobLoaded = true; //the body and headers are still in memory, LoadHistoryBlob has nothing to do until they're evicted
+		item->blobOffset = store->fileSize;
+		item->blobHeadersSize = headersSize;
+		if (sharedBodyOffset != UINTXX_MAX)
+		{
+			item->blobBodyShared = true;
+			item->blobBodyOffset = (u64)sharedBodyOffset;
+		}
+		else if (body.length > 0 && knownBodyOffset == UINTXX_MAX) { HistoryLookupAdd(&store->bodyOffsets, item->bodyHash, (uxx)item->blobOffset); } //on a collision the first body keeps the slot
+		store->fileSize += sizeof(blobHeader) + body.length + headersSize;
+	}
+	
+	OsCloseFile(&blobFile);
+	ScratchEnd(scratch);
+}
+
+// The headers part of a blob record is numHeaders key/value pairs, each string a u32 length followed by its chars. It's
+// validated in full before headersOut is filled in (with slices of headerBytes), so a corrupt record never gives back half its headers
+bool ParseHistoryBlobHeaders(Arena* arena, Str8 headerBytes, u32 numHeaders, Str8Pair** headersOut)
+{
+	NotNull(headersOut);
+	uxx readIndex = 0;
+	for (uxx pIndex = 0; pIndex < (uxx)numHeaders * 2; pIndex++)
+	{
+		u32 partLength = 0;
+		if (readIndex + sizeof(u32) > headerBytes.length) { return false; }
+		MyMemCopy(&partLength, &headerBytes.chars[readIndex], sizeof(u32));
+		readIndex += sizeof(u32);
+		if (partLength > headerBytes.length - readIndex) { return false; }
+		readIndex += partLength;
+	}
+	if (readIndex != headerBytes.length) { return false; }
+	
+	Str8Pair* headers = (numHeaders > 0) ? AllocArray(Str8Pair, arena, numHeaders) : nullptr;
+	readIndex = 0;
+	for (u32 hIndex = 0; hIndex < numHeaders; hIndex++)
+	{
+		Str8 parts[2] = ZEROED;
+		for (uxx pIndex = 0; pIndex < ArrayCount(parts); pIndex++)
+		{
+			u32 partLength = 0;
+			MyMemCopy(&partLength, &headerBytes.chars[readIndex], sizeof(u32));
+			readIndex += sizeof(u32);
+			parts[pIndex] = MakeStr8(partLength, &headerBytes.chars[readIndex]);
+			readIndex += partLength;
+		}
+		headers[hIndex].key = parts[0];
+		headers[hIndex].value = parts[1];
+	}
+	*headersOut = headers;
+	return true;
+}
+
+// Maps the item's record, and the other item's record too when the body is shared. The item isn't touched, the caller gets
+// the body and the raw header bytes (see ParseHistoryBlobHeaders) and unmaps both mappings once it's done with them
+bool MapHistoryBlob(HistoryBlobStore* store, const HistoryItem* item, FileMapping* mappingOut, FileMapping* bodyMappingOut, Str8* bodyOut, Str8* headerBytesOut, u32* numHeadersOut)
+{
+	NotNull(store);
+	NotNull(item);
+	ClearPointer(mappingOut);
+	ClearPointer(bodyMappingOut);
+	uxx bodySize = GetHistoryBlobBodySize(item);
+	uxx headersStart = sizeof(HistoryBlobHeader) + bodySize;
+	uxx recordSize = headersStart + item->blobHeadersSize;
+	bool isValid = platform->MapFile(store->filePath, item->blobOffset, recordSize, mappingOut) && mappingOut->isMapped;
+	HistoryBlobHeader blobHeader = ZEROED;
+	if (isValid)
+	{
+		MyMemCopy(&blobHeader, mappingOut->contents.chars, sizeof(blobHeader));
+		isValid = (blobHeader.magic == HISTORY_BLOB_MAGIC && blobHeader.bodySize == bodySize && blobHeader.headersSize == item->blobHeadersSize);
+	}
+	if (!isValid)
+	{
+		PrintLine_E("History blob at %llu in \"%.*s\" is missing or corrupt", item->blobOffset, StrPrint(store->filePath));
+		platform->UnmapFile(mappingOut);
+		return false;
+	}
+	*bodyOut = MakeStr8(bodySize, &mappingOut->contents.chars[sizeof(HistoryBlobHeader)]);
+	*headerBytesOut = MakeStr8(item->blobHeadersSize, &mappingOut->contents.chars[headersStart]);
+	*numHeadersOut = blobHeader.numResponseHeaders;
+	
+	if (item->blobBodyShared && item->responseLength > 0)
+	{
+		//NOTE: Only the header and body of the other record are mapped, its headers belong to another item
+		uxx sharedBodySize = item->responseLength;
+		bool bodyValid = platform->MapFile(store->filePath, item->blobBodyOffset, sizeof(HistoryBlobHeader) + sharedBodySize, bodyMappingOut) && bodyMappingOut->isMapped;
+		if (bodyValid)
+		{
+			HistoryBlobHeader bodyHeader = ZEROED;
+			MyMemCopy(&bodyHeader, bodyMappingOut->contents.chars, sizeof(bodyHeader));
+			bodyValid = (bodyHeader.magic == HISTORY_BLOB_MAGIC && bodyHeader.bodySize == sharedBodySize);
+		}
+		if (!bodyValid)
+		{
+			PrintLine_E("Shared history blob at %llu in \"%.*s\" is missing or corrupt", item->blobBodyOffset, StrPrint(store->filePath));
+			platform->UnmapFile(bodyMappingOut);
+			platform->UnmapFile(mappingOut);
+			return false;
+		}
+		*bodyOut = MakeStr8(sharedBodySize, &bodyMappingOut->contents.chars[sizeof(HistoryBlobHeader)]);
+	}
+	return true;
+}
+
+// Maps the item's record and points response at the body inside it. Headers are small so those get copied out
+void LoadHistoryBlob(HistoryBlobStore* store, HistoryItem* item)
+{
+	NotNull(store);
+	NotNull(item);
+	if (!item->hasBlob || item->blobLoaded) { return; }
+	item->blobLoaded = true; //even on failure, so we don't try again every frame
+	TracyCZoneN(Zone_Func, "LoadHistoryBlob", true);
+	
+	ScratchBegin(scratch);
+	FileMapping mapping = ZEROED;
+	FileMapping bodyMapping = ZEROED;
+	Str8 body = Str8_Empty;
+	Str8 headerBytes = Str8_Empty;
+	u32 numHeaders = 0;
+	Str8Pair* headers = nullptr;
+	bool isValid = MapHistoryBlob(store, item, &mapping, &bodyMapping, &body, &headerBytes, &numHeaders);
+	if (isValid && !ParseHistoryBlobHeaders(scratch, headerBytes, numHeaders, &headers))
+	{
+		PrintLine_E("History blob at %llu in \"%.*s\" is missing or corrupt", item->blobOffset, StrPrint(store->filePath));
+		platform->UnmapFile(&bodyMapping);
+		platform->UnmapFile(&mapping);
+		isValid = false;
+	}
+	if (!isValid)
+	{
+		if (IsEmptyStr(item->downloadPath))
+		{
+			SetHistoryResponse(item, StrLit("The saved response couldn't be loaded..."));
+			RebuildHistoryResponseLargeText(item);
+		}
+		ScratchEnd(scratch);
+		TracyCZoneEnd(Zone_Func);
+		return;
+	}
+	SetHistoryResponseHeaders(item, numHeaders, headers);
+	ScratchEnd(scratch);
+	
+	if (body.length > 0)
+	{
+		//NOTE: Only the mapping the body lives in is kept, the record's headers were copied out above
+		FreeHistoryResponse(item);
+		if (bodyMapping.isMapped) { platform->UnmapFile(&mapping); item->blobMapping = bodyMapping; }
+		else { item->blobMapping = mapping; }
+		item->response = body;
+		item->responseLength = body.length;
+		RebuildHistoryResponseLargeText(item);
+	}
+	else
+	{
+		platform->UnmapFile(&bodyMapping);
+		platform->UnmapFile(&mapping);
+	}
+	TracyCZoneEnd(Zone_Func);
+}
+
 // +--------------------------------------------------------------+
 // |                          Serialize                           |
 // +--------------------------------------------------------------+
 
-Str8 SerializeHistory(Arena* arena, const VarArray* historyList, bool addNullTerm)
+// Pass nullptr for indices to serialize the whole list, otherwise only the items at those indices are written (in that order).
+// prefix goes in front of the first item as-is (see GetHistoryFilePrefix)
+Str8 SerializeHistory(Arena* arena, const VarArray* historyList, uxx numIndices, const uxx* indices, Str8 prefix, bool addNullTerm)
 {
+	uxx numItems = (indices != nullptr) ? numIndices : historyList->length;
 	TwoPassStr8Loop(result, arena, addNullTerm)
 	{
-		VarArrayLoop(historyList, hIndex)
+		TwoPassPrint(&result, "%.*s", StrPrint(prefix));
+		bool isFirstItem = true;
+		for (uxx iIndex = 0; iIndex < numItems; iIndex++)
 		{
-			VarArrayLoopGet(HistoryItem, item, historyList, hIndex);
+			HistoryItem* item = VarArrayGet(HistoryItem, historyList, (indices != nullptr) ? indices[iIndex] : iIndex);
 			if (item->finished)
 			{
-				if (result.index > 0)
+				if (!isFirstItem)
 				{
 					TwoPassChar(&result, '\n');
 				}
+				isFirstItem = false;
+				if (item->needsMaterialize)
+				{
+					//NOTE: Nothing about an unmaterialized item can have changed, so the text it was loaded from is still exactly right
+					TwoPassPrint(&result, "%.*s", StrPrint(item->indexedText));
+					continue;
+				}
 				TwoPassPrint(&result, "# %s %s %.*s\n", item->failed ? "Failed" : "Succeeded", GetHttpVerbStr(item->verb), StrPrint(item->url));
 				if (item->failed)
 				{
 					TwoPassPrint(&result, "FailureReason: %s\n", GetResultStr(item->failureReason));
+					if (item->abortReason != HttpAbortReason_None) { TwoPassPrint(&result, "Aborted: %s\n", GetHttpAbortReasonStr(item->abortReason)); }
 				}
 				TwoPassPrint(&result, "Status: %u\n", item->responseStatusCode);
+				if (!IsEmptyStr(item->uploadPath))
+				{
+					TwoPassPrint(&result, "Upload: \"%.*s\"\n", StrPrint(item->uploadPath));
+				}
+				if (!IsEmptyStr(item->downloadPath))
+				{
+					//NOTE: The body itself lives in the downloaded file, we only remember where it went and what it was
+					TwoPassPrint(&result, "Download: \"%.*s\"\n", StrPrint(item->downloadPath));
+					TwoPassPrint(&result, "DownloadSize: %llu\n", item->responseLength);
+					TwoPassPrint(&result, "DownloadHash: 0x%016llX\n", item->downloadHash);
+				}
+				if (item->responseEncoding != HttpContentEncoding_None)
+				{
+					//NOTE: The body we save is always the decoded one, these just remember how it came over the wire
+					TwoPassPrint(&result, "ContentEncoding: %s\n", GetHttpContentEncodingStr(item->responseEncoding));
+					TwoPassPrint(&result, "EncodedSize: %llu\n", item->encodedResponseLength);
+				}
+				if (item->hasTimings)
+				{
+					//NOTE: Microseconds for each HttpPhase in order, "-" for phases that weren't observed
+					TwoPassPrint(&result, "Timings:");
+					for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+					{
+						if (item->phaseDurationsUs[pIndex] == HTTP_PHASE_UNKNOWN) { TwoPassPrint(&result, " -"); }
+						else { TwoPassPrint(&result, " %llu", item->phaseDurationsUs[pIndex]); }
+					}
+					TwoPassChar(&result, '\n');
+				}
 				TwoPassPrint(&result, "NumHeaders: %llu\n", item->numHeaders);
 				for (uxx headerIndex = 0; headerIndex < item->numHeaders; headerIndex++)
 				{
@@ -44,7 +393,14 @@ Str8 SerializeHistory(Arena* arena, const VarArray* historyList, bool addNullTer
 					TwoPassPrint(&result, "\tKey: \"%.*s\"\n", StrPrint(item->contentItems[cIndex].key));
 					TwoPassPrint(&result, "\tValue: \"%.*s\"\n", StrPrint(item->contentItems[cIndex].value));
 				}
-				//TODO: Should we somehow save response and responseHeaders?
+				if (item->hasBlob)
+				{
+					//NOTE: The response and its headers live in the HistoryBlobStore, offset then body and header sizes
+					TwoPassPrint(&result, "Blob: %llu %llu %llu\n", item->blobOffset, GetHistoryBlobBodySize(item), item->blobHeadersSize);
+					//NOTE: A body that another record already holds isn't written again, we point at that record's body (offset then size) instead
+					if (item->blobBodyShared) { TwoPassPrint(&result, "BodyBlob: %llu %llu\n", item->blobBodyOffset, item->responseLength); }
+				}
+				if (item->bodyHash != 0) { TwoPassPrint(&result, "BodyHash: %llu\n", item->bodyHash); }
 			}
 		}
 		
@@ -53,39 +409,88 @@ Str8 SerializeHistory(Arena* arena, const VarArray* historyList, bool addNullTer
 	return result.str;
 }
 
-void SaveHistory(const VarArray* historyList)
+// What goes in front of items written to a history file. A new file starts with the generation line (and the blank
+// line that separates items), otherwise the items are appended after the blank line
+Str8 GetHistoryFilePrefix(Arena* arena, bool isNewFile, u64 generation)
 {
-	ScratchBegin(scratch);
-	
-	FilePath saveFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
-	NotNull(saveFolderPath.chars);
-	FilePath historyFilePath = JoinStringsInArena3(scratch, saveFolderPath, StrLit("/"), StrLit(HISTORY_FILENAME), false);
-	
-	Str8 serializedHistory = SerializeHistory(scratch, historyList, false);
-	if (serializedHistory.length > 0)
+	if (!isNewFile) { return StrLit("\n"); }
+	return PrintInArenaStr(arena, "%s: %llu\n\n", HISTORY_GENERATION_KEY, generation);
+}
+
+// Reads the generation line at the top of history.txt or the journal. Files written before we had one are generation 0
+u64 GetHistoryFileGeneration(Str8 fileContents)
+{
+	Str8 prefix = StrLit(HISTORY_GENERATION_KEY ": ");
+	if (fileContents.length < prefix.length || !StrExactEquals(StrSlice(fileContents, 0, prefix.length), prefix)) { return 0; }
+	uxx lineEnd = prefix.length;
+	while (lineEnd < fileContents.length && fileContents.chars[lineEnd] != '\n' && fileContents.chars[lineEnd] != '\r') { lineEnd++; }
+	u64 result = 0;
+	if (!TryParseU64(StrSlice(fileContents, prefix.length, lineEnd), &result, nullptr)) { return 0; }
+	return result;
+}
+
+void InitHistoryJournal(Arena* arena, HistoryJournal* journal)
+{
+	NotNull(journal);
+	ClearPointer(journal);
+	journal->arena = arena;
+	InitVarArray(uxx, &journal->pending, arena);
+	InitVarArray(Str8, &journal->indexedHosts, arena);
+}
+
+// Called once per item, when it finishes. The item gets appended on the next SaveHistory
+void QueueHistoryJournalItem(HistoryJournal* journal, uxx historyIndex)
+{
+	uxx* indexSpace = VarArrayAdd(uxx, &journal->pending);
+	NotNull(indexSpace);
+	*indexSpace = historyIndex;
+}
+
+// +--------------------------------------------------------------+
+// |                         Deserialize                          |
+// +--------------------------------------------------------------+
+// Parses the space separated list written for "Timings:" in SerializeHistory
+bool TryParseHistoryTimings(Str8 valueStr, u64* durationsOut)
+{
+	uxx phaseIndex = 0;
+	uxx partStart = 0;
+	for (uxx cIndex = 0; cIndex <= valueStr.length; cIndex++)
 	{
-		bool writeSuccess = OsWriteTextFile(historyFilePath, serializedHistory);
-		if (!writeSuccess)
+		if (cIndex < valueStr.length && valueStr.chars[cIndex] != ' ') { continue; }
+		Str8 part = StrSlice(valueStr, partStart, cIndex);
+		partStart = cIndex+1;
+		if (part.length == 0) { continue; }
+		if (phaseIndex >= HttpPhase_Count) { return false; }
+		if (StrExactEquals(part, StrLit("-"))) { durationsOut[phaseIndex] = HTTP_PHASE_UNKNOWN; }
+		else
 		{
-			PrintLine_E("Failed to save %llu byte history to \"%.*s\"", serializedHistory.length, StrPrint(historyFilePath));
+			uxx durationUs = 0;
+			if (!TryParseUXX(part, &durationUs, nullptr)) { return false; }
+			durationsOut[phaseIndex] = (u64)durationUs;
 		}
+		phaseIndex++;
 	}
-	else if (OsDoesFileExist(historyFilePath))
+	return (phaseIndex == HttpPhase_Count);
+}
+
+// Parses exactly numValues space separated numbers, like the ones written for "Blob:" in SerializeHistory
+bool TryParseHistoryNumberList(Str8 valueStr, uxx numValues, u64* valuesOut)
+{
+	uxx valueIndex = 0;
+	uxx partStart = 0;
+	for (uxx cIndex = 0; cIndex <= valueStr.length; cIndex++)
 	{
-		//TODO: We need to add a OsDeleteFile function!
-		bool writeSuccess = OsWriteTextFile(historyFilePath, StrLit(" "));
-		if (!writeSuccess)
-		{
-			PrintLine_E("Failed to write empty history to \"%.*s\"", StrPrint(historyFilePath));
-		}
+		if (cIndex < valueStr.length && valueStr.chars[cIndex] != ' ') { continue; }
+		Str8 part = StrSlice(valueStr, partStart, cIndex);
+		partStart = cIndex+1;
+		if (part.length == 0) { continue; }
+		if (valueIndex >= numValues) { return false; }
+		if (!TryParseU64(part, &valuesOut[valueIndex], nullptr)) { return false; }
+		valueIndex++;
 	}
-	
-	ScratchEnd(scratch);
+	return (valueIndex == numValues);
 }
 
-// +--------------------------------------------------------------+
-// |                         Deserialize                          |
-// +--------------------------------------------------------------+
 Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* itemOut)
 {
 	Result result = Result_None;
@@ -93,11 +498,22 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 	bool foundItemStart = false;
 	bool foundStatus = false;
 	bool foundFailureReason = false;
+	bool foundTimings = false;
+	bool foundDownload = false;
+	uxx downloadSize = 0;
+	bool foundBlob = false;
+	u64 blobValues[3] = ZEROED; //offset, body size, headers size
+	bool foundBodyBlob = false;
+	u64 bodyBlobValues[2] = ZEROED; //offset, body size
+	bool foundBodyHash = false;
 	bool foundNumHeaders = false;
 	uxx headerIndex = 0;
 	bool foundNumContent = false;
 	uxx contentIndex = 0;
 	bool expectingContentKey = false;
+	//NOTE: Until we know the item parsed, the strings are slices of fileContents and the arrays live in scratch.
+	// PackHistoryItemData copies them into the item's single allocation at the end
+	ScratchBegin1(scratch, arena);
 	
 	TextParser parser = MakeTextParser(fileContents);
 	parser.noComments = true;
@@ -151,13 +567,11 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 				
 				ClearPointer(itemOut);
 				itemOut->arena = arena;
-				itemOut->url = AllocStr8(arena, urlPart);
+				itemOut->url = urlPart;
+				itemOut->urlHash = UpdateHttpContentHash(HTTP_CONTENT_HASH_START, urlPart);
 				itemOut->verb = verb;
 				itemOut->finished = true;
 				itemOut->failed = failed;
-				itemOut->response = AllocStr8(arena, StrLit("Responses are not currently saved between sessions..."));
-				InitUiLargeText(arena, itemOut->response, &itemOut->responseLargeText);
-				InitVarArray(Str8Pair, &itemOut->responseHeaders, arena);
 				foundItemStart = true;
 			} break;
 			
@@ -167,8 +581,8 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 				
 				if (foundNumHeaders && headerIndex < itemOut->numHeaders)
 				{
-					itemOut->headers[headerIndex].key = AllocStr8(arena, token.key);
-					itemOut->headers[headerIndex].value = AllocStr8(arena, token.value);
+					itemOut->headers[headerIndex].key = token.key;
+					itemOut->headers[headerIndex].value = token.value;
 					headerIndex++;
 				}
 				else if (foundNumContent && contentIndex < itemOut->numContentItems)
@@ -181,8 +595,8 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 						if (StrExactStartsWith(valuePart, StrLit("\""))) { valuePart = StrSliceFrom(valuePart, 1); }
 						if (StrExactEndsWith(valuePart, StrLit("\""))) { valuePart.length--; }
 					}
-					if (expectingContentKey) { itemOut->contentItems[contentIndex].key = AllocStr8(arena, valuePart); }
-					else { itemOut->contentItems[contentIndex].value = AllocStr8(arena, valuePart); }
+					if (expectingContentKey) { itemOut->contentItems[contentIndex].key = valuePart; }
+					else { itemOut->contentItems[contentIndex].value = valuePart; }
 					if (!expectingContentKey) { contentIndex++; }
 					expectingContentKey = !expectingContentKey;
 				}
@@ -193,6 +607,86 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 					if (!TryParseU16(token.value, &itemOut->responseStatusCode, &parseError)) { result = parseError; break; }
 					foundStatus = true;
 				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Timings")))
+				{
+					if (foundTimings) { result = Result_Duplicate; break; }
+					if (!TryParseHistoryTimings(token.value, &itemOut->phaseDurationsUs[0])) { result = Result_InvalidSyntax; break; }
+					itemOut->hasTimings = true;
+					foundTimings = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Upload")))
+				{
+					if (itemOut->uploadPath.chars != nullptr) { result = Result_Duplicate; break; }
+					Str8 pathPart = token.value;
+					if (StrExactStartsWith(pathPart, StrLit("\""))) { pathPart = StrSliceFrom(pathPart, 1); }
+					if (StrExactEndsWith(pathPart, StrLit("\""))) { pathPart.length--; }
+					if (pathPart.length == 0) { result = Result_InvalidSyntax; break; }
+					itemOut->uploadPath = pathPart;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Download")))
+				{
+					if (foundDownload) { result = Result_Duplicate; break; }
+					Str8 pathPart = token.value;
+					if (StrExactStartsWith(pathPart, StrLit("\""))) { pathPart = StrSliceFrom(pathPart, 1); }
+					if (StrExactEndsWith(pathPart, StrLit("\""))) { pathPart.length--; }
+					if (pathPart.length == 0) { result = Result_InvalidSyntax; break; }
+					itemOut->downloadPath = pathPart;
+					foundDownload = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("DownloadSize")))
+				{
+					Result parseError = Result_None;
+					if (!TryParseUXX(token.value, &downloadSize, &parseError)) { result = parseError; break; }
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("DownloadHash")))
+				{
+					Result parseError = Result_None;
+					if (!TryParseU64(token.value, &itemOut->downloadHash, &parseError)) { result = parseError; break; }
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Blob")))
+				{
+					if (foundBlob) { result = Result_Duplicate; break; }
+					if (!TryParseHistoryNumberList(token.value, ArrayCount(blobValues), &blobValues[0])) { result = Result_InvalidSyntax; break; }
+					foundBlob = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("BodyBlob")))
+				{
+					if (foundBodyBlob) { result = Result_Duplicate; break; }
+					if (!TryParseHistoryNumberList(token.value, ArrayCount(bodyBlobValues), &bodyBlobValues[0])) { result = Result_InvalidSyntax; break; }
+					foundBodyBlob = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("BodyHash")))
+				{
+					if (foundBodyHash) { result = Result_Duplicate; break; }
+					Result parseError = Result_None;
+					if (!TryParseU64(token.value, &itemOut->bodyHash, &parseError)) { result = parseError; break; }
+					foundBodyHash = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("ContentEncoding")))
+				{
+					itemOut->responseEncoding = HttpContentEncoding_Count;
+					for (uxx eIndex = 0; eIndex < HttpContentEncoding_Count; eIndex++)
+					{
+						Str8 encodingStr = MakeStr8Nt(GetHttpContentEncodingStr((HttpContentEncoding)eIndex));
+						if (StrAnyCaseEquals(token.value, encodingStr)) { itemOut->responseEncoding = (HttpContentEncoding)eIndex; break; }
+					}
+					if (itemOut->responseEncoding == HttpContentEncoding_Count) { result = Result_UnknownString; break; }
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("EncodedSize")))
+				{
+					Result parseError = Result_None;
+					if (!TryParseUXX(token.value, &itemOut->encodedResponseLength, &parseError)) { result = parseError; break; }
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Aborted")))
+				{
+					itemOut->abortReason = HttpAbortReason_Count;
+					for (uxx aIndex = 0; aIndex < HttpAbortReason_Count; aIndex++)
+					{
+						Str8 reasonStr = MakeStr8Nt(GetHttpAbortReasonStr((HttpAbortReason)aIndex));
+						if (StrAnyCaseEquals(token.value, reasonStr)) { itemOut->abortReason = (HttpAbortReason)aIndex; break; }
+					}
+					if (itemOut->abortReason == HttpAbortReason_Count) { result = Result_UnknownString; break; }
+				}
 				else if (StrAnyCaseEquals(token.key, StrLit("FailureReason")))
 				{
 					if (foundFailureReason) { result = Result_Duplicate; break; }
@@ -212,7 +706,7 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 					if (!TryParseUXX(token.value, &itemOut->numHeaders, &parseError)) { result = parseError; break; }
 					if (itemOut->numHeaders > 0)
 					{
-						itemOut->headers = AllocArray(Str8Pair, arena, itemOut->numHeaders);
+						itemOut->headers = AllocArray(Str8Pair, scratch, itemOut->numHeaders);
 						NotNull(itemOut->headers);
 					}
 					foundNumHeaders = true;
@@ -225,7 +719,7 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 					if (!TryParseUXX(token.value, &itemOut->numContentItems, &parseError)) { result = parseError; break; }
 					if (itemOut->numContentItems > 0)
 					{
-						itemOut->contentItems = AllocArray(Str8Pair, arena, itemOut->numContentItems);
+						itemOut->contentItems = AllocArray(Str8Pair, scratch, itemOut->numContentItems);
 						NotNull(itemOut->contentItems);
 					}
 					foundNumContent = true;
@@ -253,102 +747,688 @@ Result TryDeserializeHistoryItem(Arena* arena, Str8 fileContents, HistoryItem* i
 		else if (!foundNumContent) { result = Result_MissingPart; }
 		else if (foundNumHeaders && headerIndex < itemOut->numHeaders) { result = Result_MissingItems; }
 		else if (foundNumContent && contentIndex < itemOut->numContentItems) { result = Result_MissingItems; }
+		else if (foundBodyBlob && !foundBlob) { result = Result_MissingPart; }
+	}
+	
+	if (result == Result_None && foundBlob)
+	{
+		//NOTE: The body stays on disk until the item is selected (see LoadHistoryBlob)
+		itemOut->hasBlob = true;
+		itemOut->blobOffset = blobValues[0];
+		itemOut->responseLength = (uxx)blobValues[1];
+		itemOut->blobHeadersSize = (uxx)blobValues[2];
+		if (foundBodyBlob)
+		{
+			itemOut->blobBodyShared = true;
+			itemOut->blobBodyOffset = bodyBlobValues[0];
+			itemOut->responseLength = (uxx)bodyBlobValues[1];
+		}
+	}
+	
+	if (result == Result_None && foundDownload)
+	{
+		//NOTE: Rather than the "not saved" placeholder, downloads show where the body went (see the Raw tab)
+		itemOut->responseLength = downloadSize;
+	}
+	else if (result == Result_None && !foundBlob)
+	{
+		//NOTE: Only items saved before bodies went to the HistoryBlobStore get here, everything newer leaves its response empty until LoadHistoryBlob
+		SetHistoryResponse(itemOut, StrLit("Responses are not currently saved between sessions..."));
+		RebuildHistoryResponseLargeText(itemOut);
 	}
 	
-	if (result == Result_None) { result = Result_Success; }
+	if (result == Result_None)
+	{
+		PackHistoryItemData(itemOut, itemOut->url, itemOut->uploadPath, itemOut->downloadPath, itemOut->numHeaders, itemOut->headers, itemOut->numContentItems, itemOut->contentItems);
+		result = Result_Success;
+	}
 	else if (foundItemStart && CanArenaFree(arena)) { FreeHistoryItem(itemOut); }
+	ScratchEnd(scratch);
 	return result;
 }
 
+// Items start on lines that begin with '#' (what TextParser calls ParsingTokenType_FilePrefix). Nothing else we write
+// starts a line with '#', so finding them doesn't need the tokenizer. Returns fileContents.length if there are no more
+uxx FindNextHistoryItemStart(Str8 fileContents, uxx startIndex)
+{
+	uxx lineStart = startIndex;
+	while (lineStart < fileContents.length)
+	{
+		if (fileContents.chars[lineStart] == '#' && (lineStart == 0 || fileContents.chars[lineStart-1] == '\n')) { return lineStart; }
+		const char* newLine = (const char*)memchr(&fileContents.chars[lineStart], '\n', fileContents.length - lineStart);
+		if (newLine == nullptr) { break; }
+		lineStart = (uxx)(newLine - fileContents.chars) + 1;
+	}
+	return fileContents.length;
+}
+
+// void ParseHistoryItemsJob(void* contextPntr, uxx workerIndex, uxx jobIndex)
+SYS_PARALLEL_JOB_DEF(ParseHistoryItemsJob)
+{
+	HistoryParseContext* context = (HistoryParseContext*)contextPntr;
+	uxx firstItemIndex = jobIndex * HISTORY_PARSE_JOB_SIZE;
+	uxx endItemIndex = MinUXX(firstItemIndex + HISTORY_PARSE_JOB_SIZE, context->numItems);
+	for (uxx iIndex = firstItemIndex; iIndex < endItemIndex; iIndex++)
+	{
+		Str8 itemSlice = StrSlice(context->fileContents, context->itemStarts[iIndex], context->itemStarts[iIndex+1]);
+		context->results[iIndex] = TryDeserializeHistoryItem(context->workerArenas[workerIndex], itemSlice, &context->items[iIndex]);
+	}
+}
+
+// Large files are parsed on a worker per core. Each worker allocates from its own heap (items keep it as their arena
+// for good) and writes into its item's slot, then the items are added to listOut in file order on this thread
 Result TryDeserializeHistoryList(Arena* arena, Str8 fileContents, VarArray* listOut, uxx* nextHistoryId)
 {
+	TracyCZoneN(Zone_Func, "TryDeserializeHistoryList", true);
+	ScratchBegin1(scratch, arena);
+	
+	VarArray itemStarts;
+	InitVarArray(uxx, &itemStarts, scratch);
+	for (uxx itemStart = FindNextHistoryItemStart(fileContents, 0); itemStart < fileContents.length; itemStart = FindNextHistoryItemStart(fileContents, itemStart+1))
+	{
+		uxx* startSpace = VarArrayAdd(uxx, &itemStarts);
+		NotNull(startSpace);
+		*startSpace = itemStart;
+	}
+	uxx numItems = itemStarts.length;
+	uxx* endSpace = VarArrayAdd(uxx, &itemStarts);
+	NotNull(endSpace);
+	*endSpace = fileContents.length;
+	
+	HistoryParseContext context = ZEROED;
+	context.fileContents = fileContents;
+	context.numItems = numItems;
+	context.itemStarts = (const uxx*)itemStarts.items;
+	context.items = (numItems > 0) ? AllocArray(HistoryItem, scratch, numItems) : nullptr;
+	context.results = (numItems > 0) ? AllocArray(Result, scratch, numItems) : nullptr;
+	uxx numJobs = (numItems + HISTORY_PARSE_JOB_SIZE-1) / HISTORY_PARSE_JOB_SIZE;
+	uxx numWorkers = (numItems >= HISTORY_PARALLEL_MIN_ITEMS) ? MinUXX(SysGetNumCores(), SYS_PARALLEL_MAX_WORKERS) : 1;
+	context.workerArenas[0] = arena;
+	for (uxx wIndex = 1; wIndex < numWorkers; wIndex++)
+	{
+		context.workerArenas[wIndex] = AllocType(Arena, arena);
+		NotNull(context.workerArenas[wIndex]);
+		InitArenaStdHeap(context.workerArenas[wIndex]);
+	}
+	if (numJobs > 0) { SysParallelFor(numWorkers, numJobs, ParseHistoryItemsJob, &context); }
+	
+	//NOTE: Like before, a bad item ends the list. Everything after it is thrown away even if it parsed fine
 	Result result = Result_None;
+	for (uxx iIndex = 0; iIndex < numItems; iIndex++)
+	{
+		HistoryItem* item = &context.items[iIndex];
+		if (result != Result_None)
+		{
+			if (context.results[iIndex] == Result_Success) { FreeHistoryItem(item); }
+		}
+		else if (context.results[iIndex] == Result_Success)
+		{
+			item->id = *nextHistoryId;
+			*nextHistoryId = (*nextHistoryId) + 1;
+			HistoryItem* newSpace = VarArrayAdd(HistoryItem, listOut);
+			NotNull(newSpace);
+			MyMemCopy(newSpace, item, sizeof(HistoryItem));
+		}
+		else
+		{
+			PrintLine_E("Failed to parse item[%llu]: %s", iIndex, GetResultStr(context.results[iIndex]));
+			result = context.results[iIndex];
+		}
+	}
+	
+	if (result == Result_None) { result = (numItems > 0) ? Result_Success : Result_EmptyFile; }
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                            Index                             |
+// +--------------------------------------------------------------+
+// Parses the rest of an item that was created from the history index. Its id (and so its place in the list) doesn't change
+void MaterializeHistoryItem(HistoryJournal* journal, HistoryItem* item)
+{
+	NotNull(journal);
+	NotNull(item);
+	if (!item->needsMaterialize) { return; }
+	TracyCZoneN(Zone_Func, "MaterializeHistoryItem", true);
+	Assert(journal->historyMapping.isMapped);
+	Assert(journal->numUnmaterialized > 0);
+	
+	HistoryItem parsedItem = ZEROED;
+	Result parseResult = TryDeserializeHistoryItem(item->arena, item->indexedText, &parsedItem);
+	if (parseResult == Result_Success)
+	{
+		parsedItem.id = item->id;
+		parsedItem.bodyChanged = item->bodyChanged;
+		parsedItem.lastViewedTime = item->lastViewedTime;
+		MyMemCopy(item, &parsedItem, sizeof(HistoryItem));
+	}
+	else
+	{
+		//NOTE: The index and history.txt disagree. Keep what the index told us and say so in place of the response
+		PrintLine_E("Failed to parse history item %llu at %llu in history.txt: %s", item->id, (u64)(item->indexedText.chars - journal->historyMapping.contents.chars), GetResultStr(parseResult));
+		PackHistoryItemData(item, item->url, Str8_Empty, Str8_Empty, 0, nullptr, 0, nullptr);
+		SetHistoryResponse(item, StrLit("This item couldn't be loaded from history.txt..."));
+		RebuildHistoryResponseLargeText(item);
+	}
+	item->needsMaterialize = false;
+	journal->numUnmaterialized--;
+	TracyCZoneEnd(Zone_Func);
+}
+
+void MaterializeAllHistoryItems(HistoryJournal* journal, VarArray* historyList)
+{
+	NotNull(journal);
+	if (journal->numUnmaterialized > 0)
+	{
+		VarArrayLoop(historyList, hIndex)
+		{
+			VarArrayLoopGet(HistoryItem, item, historyList, hIndex);
+			MaterializeHistoryItem(journal, item);
+		}
+	}
+	//NOTE: Nothing points into history.txt anymore, so it's free to be rewritten (Windows won't let us while it's mapped)
+	Assert(journal->numUnmaterialized == 0);
+	if (journal->historyMapping.isMapped) { platform->UnmapFile(&journal->historyMapping); }
+}
+
+// Everything from itemStart up to the next item, minus the blank line SerializeHistory puts between items
+uxx GetHistoryItemTextLength(Str8 serializedHistory, uxx itemStart, uxx nextItemStart)
+{
+	uxx itemEnd = nextItemStart;
+	if (itemEnd - itemStart >= 2 && serializedHistory.chars[itemEnd-1] == '\n' && serializedHistory.chars[itemEnd-2] == '\n') { itemEnd--; }
+	return itemEnd - itemStart;
+}
+
+// Builds the index for serializedHistory, which must be SerializeHistory of all of historyList. Items are split with
+// FindNextHistoryItemStart like TryDeserializeHistoryList does, and the Nth one found belongs to the Nth finished item
+Str8 BuildHistoryIndex(Arena* arena, const VarArray* historyList, Str8 serializedHistory, u64 generation)
+{
+	uxx numItems = 0;
+	VarArrayLoop(historyList, hIndex) { if (VarArrayGet(HistoryItem, historyList, hIndex)->finished) { numItems++; } }
+	HistoryIndexEntry* entries = (numItems > 0) ? AllocArray(HistoryIndexEntry, arena, numItems) : nullptr;
+	VarArray hosts; //Str8, slices of the items' urls
+	InitVarArray(Str8, &hosts, arena);
+	HistoryLookup hostLookup;
+	InitHistoryLookup(arena, &hostLookup);
 	
-	#define PARSE_HISTORY_ITEM(slice) do                                                        \
-	{                                                                                           \
-		HistoryItem item = ZEROED;                                                              \
-		Result itemResult = TryDeserializeHistoryItem(arena, slice, &item);                     \
-		if (itemResult == Result_Success)                                                       \
-		{                                                                                       \
-			item.id = *nextHistoryId;                                                           \
-			*nextHistoryId = (*nextHistoryId) + 1;                                              \
-			                                                                                    \
-			HistoryItem* newSpace = VarArrayAdd(HistoryItem, listOut);                          \
-			NotNull(newSpace);                                                                  \
-			MyMemCopy(newSpace, &item, sizeof(HistoryItem));                                    \
-		}                                                                                       \
-		else                                                                                    \
-		{                                                                                       \
-			PrintLine_E("Failed to parse item[%llu]: %s", itemIndex, GetResultStr(itemResult)); \
-			result = itemResult;                                                                \
-			break;                                                                              \
-		}                                                                                       \
-		itemIndex++;                                                                            \
-	} while(0)
-	
-	uxx itemStartIndex = 0;
-	bool insideItem = false;
+	uxx entryIndex = 0;
 	uxx itemIndex = 0;
-	TextParser parser = MakeTextParser(fileContents);
-	parser.noComments = true;
-	ParsingToken token = ZEROED;
-	while (TextParserGetToken(&parser, &token))
+	bool isValid = true;
+	for (uxx lineStartIndex = FindNextHistoryItemStart(serializedHistory, 0); lineStartIndex < serializedHistory.length; lineStartIndex = FindNextHistoryItemStart(serializedHistory, lineStartIndex+1))
 	{
-		switch (token.type)
+		if (entryIndex > 0) { entries[entryIndex-1].textLength = (u32)GetHistoryItemTextLength(serializedHistory, entries[entryIndex-1].textOffset, lineStartIndex); }
+		while (itemIndex < historyList->length && !VarArrayGet(HistoryItem, historyList, itemIndex)->finished) { itemIndex++; }
+		if (entryIndex >= numItems || itemIndex >= historyList->length) { isValid = false; break; }
+		HistoryItem* item = VarArrayGet(HistoryItem, historyList, itemIndex);
+		
+		//NOTE: The first line is "# Succeeded GET url" and neither of the first two words have spaces in them
+		uxx urlStart = lineStartIndex;
+		for (uxx numSpaces = 0; urlStart < serializedHistory.length && numSpaces < 3; urlStart++)
 		{
-			case ParsingTokenType_FilePrefix:
+			if (serializedHistory.chars[urlStart] == ' ') { numSpaces++; }
+		}
+		if (urlStart + item->url.length > serializedHistory.length || !StrExactEquals(StrSlice(serializedHistory, urlStart, urlStart + item->url.length), item->url)) { isValid = false; break; }
+		
+		HistoryIndexEntry* entry = &entries[entryIndex];
+		ClearPointer(entry);
+		entry->textOffset = lineStartIndex;
+		entry->urlOffset = (u32)(urlStart - lineStartIndex);
+		entry->urlLength = (u32)item->url.length;
+		entry->statusCode = item->responseStatusCode;
+		entry->verb = (u8)item->verb;
+		entry->flags = (item->failed ? HISTORY_INDEX_FLAG_FAILED : 0);
+		entry->hostIndex = InternHistoryHost(&hosts, &hostLookup, GetUrlHost(item->url), nullptr);
+		entry->urlHash = item->urlHash;
+		entry->bodyHash = item->bodyHash;
+		entry->responseLength = item->responseLength;
+		entry->latencyUs = GetHistoryItemLatencyUs(item);
+		entryIndex++;
+		itemIndex++;
+	}
+	if (entryIndex > 0) { entries[entryIndex-1].textLength = (u32)GetHistoryItemTextLength(serializedHistory, entries[entryIndex-1].textOffset, serializedHistory.length); }
+	
+	uxx hostCharsSize = 0;
+	VarArrayLoop(&hosts, hIndex) { hostCharsSize += VarArrayGet(Str8, &hosts, hIndex)->length; }
+	bool linesUp = (isValid && entryIndex == numItems && hostCharsSize <= UINT32_MAX);
+	if (!linesUp)
+	{
+		PrintLine_W("History index doesn't line up with the %llu serialized items, history.txt will be parsed in full next time", numItems);
+		numItems = 0;
+		VarArrayClear(&hosts);
+		hostCharsSize = 0;
+	}
+	
+	uxx indexSize = sizeof(HistoryIndexHeader) + numItems * sizeof(HistoryIndexEntry) + hosts.length * sizeof(HistoryIndexHost) + hostCharsSize;
+	char* indexBytes = AllocArray(char, arena, indexSize);
+	NotNull(indexBytes);
+	HistoryIndexHeader* header = (HistoryIndexHeader*)indexBytes;
+	ClearPointer(header);
+	header->magic = HISTORY_INDEX_MAGIC;
+	header->version = HISTORY_INDEX_VERSION;
+	header->numItems = numItems;
+	//NOTE: history.txt is never empty, so a historyFileSize of 0 keeps this index from ever being used
+	header->historyFileSize = linesUp ? serializedHistory.length : 0;
+	header->generation = generation;
+	header->numHosts = hosts.length;
+	header->hostCharsSize = hostCharsSize;
+	if (numItems > 0) { MyMemCopy(header + 1, entries, numItems * sizeof(HistoryIndexEntry)); }
+	HistoryIndexHost* indexHosts = (HistoryIndexHost*)(indexBytes + sizeof(HistoryIndexHeader) + numItems * sizeof(HistoryIndexEntry));
+	char* hostChars = (char*)(indexHosts + hosts.length);
+	uxx hostCharsOffset = 0;
+	VarArrayLoop(&hosts, hIndex)
+	{
+		VarArrayLoopGet(Str8, host, &hosts, hIndex);
+		indexHosts[hIndex].offset = (u32)hostCharsOffset;
+		indexHosts[hIndex].length = (u32)host->length;
+		if (host->length > 0) { MyMemCopy(&hostChars[hostCharsOffset], host->chars, host->length); }
+		hostCharsOffset += host->length;
+	}
+	return MakeStr8(indexSize, indexBytes);
+}
+
+// Creates an unmaterialized item for every entry, if the index exists and matches history.txt. Returns false if
+// history.txt needs to be parsed the slow way instead
+bool TryLoadHistoryIndex(Arena* arena, HistoryJournal* journal, FilePath indexFilePath, VarArray* historyList, uxx* nextHistoryId)
+{
+	FileMapping indexMapping = ZEROED;
+	if (!OsDoesFileExist(indexFilePath) || !platform->MapFile(indexFilePath, 0, 0, &indexMapping)) { return false; }
+	HistoryIndexHeader header = ZEROED;
+	bool isValid = (indexMapping.contents.length >= sizeof(HistoryIndexHeader));
+	if (isValid)
+	{
+		MyMemCopy(&header, indexMapping.contents.chars, sizeof(header));
+		isValid = (header.magic == HISTORY_INDEX_MAGIC && header.version == HISTORY_INDEX_VERSION &&
+			header.historyFileSize == journal->historyMapping.fileSize && header.generation == journal->generation && header.hostCharsSize <= UINT32_MAX &&
+			indexMapping.contents.length == sizeof(HistoryIndexHeader) + header.numItems * sizeof(HistoryIndexEntry) + header.numHosts * sizeof(HistoryIndexHost) + header.hostCharsSize);
+	}
+	
+	const HistoryIndexEntry* entries = (const HistoryIndexEntry*)(indexMapping.contents.chars + sizeof(HistoryIndexHeader));
+	const HistoryIndexHost* hosts = (const HistoryIndexHost*)(entries + header.numItems);
+	const char* hostChars = (const char*)(hosts + header.numHosts);
+	for (uxx eIndex = 0; isValid && eIndex < header.numItems; eIndex++)
+	{
+		const HistoryIndexEntry* entry = &entries[eIndex];
+		if (entry->textOffset + entry->textLength > journal->historyMapping.contents.length ||
+			entry->urlOffset + entry->urlLength > entry->textLength ||
+			entry->verb == HttpVerb_None || entry->verb >= HttpVerb_Count ||
+			entry->hostIndex >= header.numHosts)
+		{
+			isValid = false;
+		}
+	}
+	for (uxx hIndex = 0; isValid && hIndex < header.numHosts; hIndex++)
+	{
+		if ((u64)hosts[hIndex].offset + hosts[hIndex].length > header.hostCharsSize) { isValid = false; }
+	}
+	if (!isValid)
+	{
+		PrintLine_W("History index \"%.*s\" doesn't match history.txt, parsing the whole file instead", StrPrint(indexFilePath));
+		platform->UnmapFile(&indexMapping);
+		return false;
+	}
+	
+	//NOTE: The hosts get copied since the index is unmapped below. Everything else about the items comes out of the entries
+	journal->indexedHostChars = AllocStr8(arena, MakeStr8((uxx)header.hostCharsSize, (char*)hostChars));
+	for (uxx hIndex = 0; hIndex < header.numHosts; hIndex++)
+	{
+		Str8* hostSpace = VarArrayAdd(Str8, &journal->indexedHosts);
+		NotNull(hostSpace);
+		*hostSpace = StrSlice(journal->indexedHostChars, hosts[hIndex].offset, hosts[hIndex].offset + hosts[hIndex].length);
+	}
+	for (uxx eIndex = 0; eIndex < header.numItems; eIndex++)
+	{
+		const HistoryIndexEntry* entry = &entries[eIndex];
+		HistoryItem* item = VarArrayAdd(HistoryItem, historyList);
+		NotNull(item);
+		ClearPointer(item);
+		item->arena = arena;
+		item->id = *nextHistoryId;
+		*nextHistoryId = (*nextHistoryId) + 1;
+		item->needsMaterialize = true;
+		item->indexedText = StrSlice(journal->historyMapping.contents, (uxx)entry->textOffset, (uxx)(entry->textOffset + entry->textLength));
+		item->url = StrSlice(journal->historyMapping.contents, (uxx)(entry->textOffset + entry->urlOffset), (uxx)(entry->textOffset + entry->urlOffset + entry->urlLength));
+		item->urlHash = entry->urlHash;
+		item->bodyHash = entry->bodyHash;
+		item->verb = (HttpVerb)entry->verb;
+		item->finished = true;
+		item->failed = IsFlagSet(entry->flags, HISTORY_INDEX_FLAG_FAILED);
+		item->responseStatusCode = entry->statusCode;
+		//NOTE: Only here for the HistoryColumns, materializing parses these again from history.txt
+		item->responseLength = (uxx)entry->responseLength;
+		item->indexedLatencyUs = entry->latencyUs;
+		item->indexedHostIndex = entry->hostIndex;
+	}
+	journal->numUnmaterialized += header.numItems;
+	PrintLine_D("Indexed %llu history items from \"%.*s\"", header.numItems, StrPrint(indexFilePath));
+	platform->UnmapFile(&indexMapping);
+	return true;
+}
+
+// The host an item's HistoryColumns row goes under. Items that came from the index use the index's copy, so building
+// the columns at startup doesn't read any urls out of (and fault in) the mapped history.txt
+Str8 GetLoadedHistoryItemHost(const HistoryJournal* journal, const HistoryItem* item)
+{
+	NotNull(journal);
+	NotNull(item);
+	if (item->needsMaterialize && item->indexedHostIndex < journal->indexedHosts.length) { return *VarArrayGet(Str8, &journal->indexedHosts, item->indexedHostIndex); }
+	return GetUrlHost(item->url);
+}
+
+// Called once the HistoryColumns have been built, nothing needs the index's hosts after that
+void FreeHistoryIndexHosts(HistoryJournal* journal)
+{
+	NotNull(journal);
+	VarArrayClear(&journal->indexedHosts);
+	if (journal->indexedHostChars.chars != nullptr) { FreeStr8(journal->arena, &journal->indexedHostChars); }
+}
+
+// +--------------------------------------------------------------+
+// |                          Compaction                          |
+// +--------------------------------------------------------------+
+// Runs on the writer thread. Replaces history.txt (and its index) with the snapshot and empties the journal. Replacing
+// history.txt is what commits the compaction: it has the next generation, so if we crash before the index or journal
+// catch up, loading sees they're from an older generation and doesn't trust them
+bool WriteHistorySnapshot(HistoryWriter* writer, uxx* historyFileSizeOut, bool* emptiedJournalOut)
+{
+	TracyCZoneN(Zone_Func, "WriteHistorySnapshot", true);
+	ScratchBegin(scratch);
+	Str8 prefix = GetHistoryFilePrefix(scratch, true, writer->generation);
+	Str8 serializedHistory = SerializeHistory(scratch, &writer->snapshot, 0, nullptr, prefix, false);
+	//NOTE: Written without newline conversion so the offsets in the index are the offsets in the file. It's written even
+	// with no items, since the generation line is what tells the next load that the journal has been folded in
+	bool wroteHistory = SysWriteFileAtomic(writer->historyFilePath, serializedHistory);
+	if (!wroteHistory)
+	{
+		PrintLine_E("Failed to save %llu byte history to \"%.*s\"", serializedHistory.length, StrPrint(writer->historyFilePath));
+	}
+	
+	*emptiedJournalOut = false;
+	if (wroteHistory)
+	{
+		Str8 indexBytes = BuildHistoryIndex(scratch, &writer->snapshot, serializedHistory, writer->generation);
+		if (!SysWriteFileAtomic(writer->indexFilePath, indexBytes)) { PrintLine_W("Failed to write history index to \"%.*s\"", StrPrint(writer->indexFilePath)); }
+		
+		//NOTE: If history.txt didn't get written, the journal is still the only copy of its items so we leave it alone.
+		// Create mode truncates, so opening and closing is all it takes to empty the journal. The next append writes
+		// the new generation at the top of it
+		OsFile journalFile = ZEROED;
+		if (OsOpenFile(scratch, writer->journalFilePath, OsOpenFileMode_Create, false, &journalFile))
+		{
+			OsCloseFile(&journalFile);
+			*emptiedJournalOut = true;
+		}
+		else { PrintLine_E("Failed to empty history journal at \"%.*s\"", StrPrint(writer->journalFilePath)); }
+	}
+	
+	*historyFileSizeOut = serializedHistory.length;
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+	return wroteHistory;
+}
+
+// void HistoryWriterThreadMain(void* contextPntr)
+SYS_THREAD_FUNC_DEF(HistoryWriterThreadMain)
+{
+	HistoryWriter* writer = (HistoryWriter*)contextPntr;
+	InitScratchArenasVirtual(Gigabytes(4));
+	#if TARGET_HAS_THREADING
+	OsSetThreadName(nullptr, StrLit("HistoryWriter"));
+	#endif
+	
+	while (!SysIsWorkerStopping(&writer->worker))
+	{
+		LockMutex(&writer->mutex, TIMEOUT_FOREVER);
+		bool hasWork = writer->hasWork;
+		UnlockMutex(&writer->mutex);
+		
+		if (!hasWork) { SysWorkerWait(&writer->worker, SYS_WAIT_FOREVER); continue; }
+		
+		//NOTE: The UI thread doesn't touch the snapshot while hasWork is set, so it's safe to read without the lock
+		uxx historyFileSize = 0;
+		bool emptiedJournal = false;
+		bool succeeded = WriteHistorySnapshot(writer, &historyFileSize, &emptiedJournal);
+		
+		LockMutex(&writer->mutex, TIMEOUT_FOREVER);
+		writer->hasWork = false;
+		writer->isDone = true;
+		writer->succeeded = succeeded;
+		writer->emptiedJournal = emptiedJournal;
+		writer->historyFileSize = historyFileSize;
+		UnlockMutex(&writer->mutex);
+	}
+}
+
+void InitHistoryWriter(Arena* arena, HistoryWriter* writer)
+{
+	NotNull(writer);
+	ClearPointer(writer);
+	writer->arena = arena;
+	writer->historyFilePath = GetHistoryFilePath(arena, StrLit(HISTORY_FILENAME));
+	writer->journalFilePath = GetHistoryFilePath(arena, StrLit(HISTORY_JOURNAL_FILENAME));
+	writer->indexFilePath = GetHistoryFilePath(arena, StrLit(HISTORY_INDEX_FILENAME));
+	InitMutex(&writer->mutex);
+	InitVarArray(HistoryItem, &writer->snapshot, arena);
+	bool startedThread = SysStartWorker(&writer->worker, HistoryWriterThreadMain, (void*)writer);
+	Assert(startedThread);
+}
+
+// Picks up the result once the writer finishes. With waitForWriter this blocks until then, which is what anything
+// that's about to free history items (or the writer itself) needs to do first
+void PollHistoryWriter(HistoryJournal* journal, HistoryWriter* writer, bool waitForWriter)
+{
+	NotNull(journal);
+	NotNull(writer);
+	while (writer->isBusy)
+	{
+		LockMutex(&writer->mutex, TIMEOUT_FOREVER);
+		bool isDone = writer->isDone;
+		bool succeeded = writer->succeeded;
+		bool emptiedJournal = writer->emptiedJournal;
+		uxx historyFileSize = writer->historyFileSize;
+		writer->isDone = false;
+		UnlockMutex(&writer->mutex);
+		
+		if (isDone)
+		{
+			writer->isBusy = false;
+			VarArrayClear(&writer->snapshot);
+			if (succeeded)
 			{
-				uxx lineStartIndex = (uxx)(token.str.chars - fileContents.chars);
-				if (insideItem)
-				{
-					Str8 prevItemSlice = StrSlice(fileContents, itemStartIndex, lineStartIndex);
-					PARSE_HISTORY_ITEM(prevItemSlice);
-				}
-				itemStartIndex = lineStartIndex;
-				insideItem = true;
-			} break;
-			
-			default: break;
+				journal->historyFileSize = historyFileSize;
+				journal->generation = writer->generation;
+				journal->journalFileSize = 0;
+				//NOTE: The journal still has the last generation's items, anything appended after them would be skipped along with them when loading
+				if (!emptiedJournal) { journal->needsCompaction = true; }
+			}
+			else { journal->needsCompaction = true; } //everything in the snapshot was taken out of pending, so only a full rewrite gets it all back on disk
 		}
-		if (result != Result_None) { break; }
+		else if (waitForWriter) { SysSleepMs(1); }
+		else { break; }
+	}
+}
+
+void FreeHistoryWriter(HistoryJournal* journal, HistoryWriter* writer)
+{
+	NotNull(writer);
+	PollHistoryWriter(journal, writer, true);
+	SysStopWorker(&writer->worker);
+	DestroyMutex(&writer->mutex);
+	FreeVarArray(&writer->snapshot);
+	FreeStr8(writer->arena, &writer->historyFilePath);
+	FreeStr8(writer->arena, &writer->journalFilePath);
+	FreeStr8(writer->arena, &writer->indexFilePath);
+	ClearPointer(writer);
+}
+
+// Takes the snapshot and hands it to the writer. This is the only part of a compaction the UI thread pays for, a copy
+// of each finished item's struct. Every pending item is in the snapshot, so pending starts over from here
+void StartHistoryCompaction(HistoryJournal* journal, HistoryWriter* writer, VarArray* historyList)
+{
+	TracyCZoneN(Zone_Func, "StartHistoryCompaction", true);
+	Assert(!writer->isBusy);
+	#if TARGET_IS_WINDOWS
+	//NOTE: Windows won't let us rename over history.txt while it's mapped. Elsewhere the old file lives on (unlinked) for as long as we keep it mapped
+	MaterializeAllHistoryItems(journal, historyList);
+	#endif
+	
+	VarArrayClear(&writer->snapshot);
+	VarArrayLoop(historyList, hIndex)
+	{
+		VarArrayLoopGet(HistoryItem, item, historyList, hIndex);
+		if (!item->finished) { continue; }
+		HistoryItem* snapshotItem = VarArrayAdd(HistoryItem, &writer->snapshot);
+		NotNull(snapshotItem);
+		MyMemCopy(snapshotItem, item, sizeof(HistoryItem));
 	}
+	VarArrayClear(&journal->pending);
+	journal->needsCompaction = false;
+	writer->generation = journal->generation + 1;
+	
+	writer->isBusy = true;
+	LockMutex(&writer->mutex, TIMEOUT_FOREVER);
+	writer->hasWork = true;
+	writer->isDone = false;
+	UnlockMutex(&writer->mutex);
+	SysWakeWorker(&writer->worker);
+	TracyCZoneEnd(Zone_Func);
+}
+
+// Appends items that finished since the last save to the journal, so the cost is proportional to what changed.
+// Once the journal is at least half the size of history.txt we compact instead, which keeps the amortized cost the same.
+// While the writer is busy nothing gets appended (it's about to empty the journal). Returns false if something is
+// still waiting to be saved (including a compaction that's still being written), so the caller knows to try again later
+bool SaveHistory(HistoryJournal* journal, HistoryBlobStore* blobs, HistoryWriter* writer, VarArray* historyList)
+{
+	NotNull(journal);
+	NotNull(blobs);
+	NotNull(writer);
+	NotNull(historyList);
+	PollHistoryWriter(journal, writer, false);
+	//NOTE: Bodies go to disk before the items that point at them. The writer never looks at the blob file so this is fine while it's busy
+	WriteHistoryBlobs(blobs, historyList, journal->pending.length, (const uxx*)journal->pending.items);
+	if (writer->isBusy) { return false; }
 	
-	if (result == Result_None && insideItem && itemStartIndex < fileContents.length)
+	bool compact = (journal->needsCompaction || journal->journalFileSize >= MaxUXX(HISTORY_COMPACT_MIN_SIZE, journal->historyFileSize / 2));
+	if (compact)
 	{
-		Str8 lastItemSlice = StrSlice(fileContents, itemStartIndex, fileContents.length);
-		PARSE_HISTORY_ITEM(lastItemSlice);
+		//NOTE: After a Clear nothing references the old records, so rather than let the blob file grow forever it starts over
+		if (historyList->length == 0) { ResetHistoryBlobStore(blobs); }
+		StartHistoryCompaction(journal, writer, historyList);
+		return false;
 	}
+	if (journal->pending.length == 0) { return true; }
 	
-	if (result == Result_None) { result = (itemIndex > 0) ? Result_Success : Result_EmptyFile; }
-	return result;
+	ScratchBegin(scratch);
+	FilePath journalFilePath = GetHistoryFilePath(scratch, StrLit(HISTORY_JOURNAL_FILENAME));
+	//NOTE: Items are separated by a blank line, same as in history.txt, and an empty journal starts with the generation it goes on top of
+	Str8 prefix = GetHistoryFilePrefix(scratch, (journal->journalFileSize == 0), journal->generation);
+	Str8 serializedItems = SerializeHistory(scratch, historyList, journal->pending.length, (const uxx*)journal->pending.items, prefix, false);
+	OsFile journalFile = ZEROED;
+	if (OsOpenFile(scratch, journalFilePath, OsOpenFileMode_Append, false, &journalFile))
+	{
+		bool writeSuccess = OsWriteToOpenFile(&journalFile, serializedItems, false);
+		OsCloseFile(&journalFile);
+		if (writeSuccess)
+		{
+			journal->journalFileSize += serializedItems.length;
+			VarArrayClear(&journal->pending);
+		}
+		else
+		{
+			PrintLine_E("Failed to append %llu byte%s to history journal at \"%.*s\"", serializedItems.length, Plural(serializedItems.length, "s"), StrPrint(journalFilePath));
+			//NOTE: Part of it may have made it to disk, retrying the append could duplicate items so we rewrite everything instead
+			journal->needsCompaction = true;
+		}
+	}
+	else { PrintLine_E("Failed to open history journal at \"%.*s\"", StrPrint(journalFilePath)); }
+	ScratchEnd(scratch);
+	return (journal->pending.length == 0);
 }
 
-bool LoadHistory(Arena* arena, VarArray* historyList, uxx* nextHistoryId)
+// +--------------------------------------------------------------+
+// |                             Load                             |
+// +--------------------------------------------------------------+
+// generation is history.txt's. A file from an older generation was already folded into history.txt (we crashed before
+// the journal got emptied), so its items are skipped and we return false. A newer one raises generation to match, so
+// the next compaction is newer than both
+bool LoadHistoryFile(Arena* arena, FilePath historyFilePath, u64* generation, VarArray* historyList, uxx* nextHistoryId, uxx* fileSizeOut)
 {
 	ScratchBegin1(scratch, arena);
 	bool result = false;
 	
-	FilePath saveFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), true);
-	NotNull(saveFolderPath.chars);
-	FilePath historyFilePath = JoinStringsInArena3(scratch, saveFolderPath, StrLit("/"), StrLit(HISTORY_FILENAME), false);
-	
 	if (OsDoesFileExist(historyFilePath))
 	{
 		Str8 historyFileContents = Str8_Empty;
-		if (OsReadTextFile(historyFilePath, scratch, &historyFileContents))
+		bool readFile = OsReadTextFile(historyFilePath, scratch, &historyFileContents);
+		//NOTE: An empty file is what compacting leaves behind, it gets its generation once something is appended
+		u64 fileGeneration = (historyFileContents.length > 0) ? GetHistoryFileGeneration(historyFileContents) : *generation;
+		if (!readFile) { PrintLine_W("Failed to open and read history file at \"%.*s\"", StrPrint(historyFilePath)); }
+		else if (fileGeneration < *generation)
+		{
+			PrintLine_W("Skipping \"%.*s\", it's from generation %llu and history.txt already has its items (generation %llu)", StrPrint(historyFilePath), fileGeneration, *generation);
+		}
+		else
 		{
+			*generation = fileGeneration;
+			uxx numItemsBefore = historyList->length;
 			Result parseResult = TryDeserializeHistoryList(arena, historyFileContents, historyList, nextHistoryId);
 			if (parseResult == Result_Success || parseResult == Result_EmptyFile)
 			{
-				PrintLine_D("Loaded %llu history items from \"%.*s\"", historyList->length, StrPrint(historyFilePath));
+				PrintLine_D("Loaded %llu history items from \"%.*s\"", historyList->length - numItemsBefore, StrPrint(historyFilePath));
+				if (fileSizeOut != nullptr) { *fileSizeOut = historyFileContents.length; }
 				result = true;
 			}
 			else { PrintLine_E("Failed to parse %llu byte history file contents at \"%.*s\"! Error: %s", historyFileContents.length, StrPrint(historyFilePath), GetResultStr(parseResult)); }
 		}
-		else { PrintLine_W("Failed to open and read history file at \"%.*s\"", StrPrint(historyFilePath)); }
 	}
 	else { PrintLine_D("No history file at \"%.*s\"", StrPrint(historyFilePath)); }
 	
 	ScratchEnd(scratch);
 	return result;
 }
+
+// Reads history.txt (through its index when we can) and then whatever has been appended to the journal since it was last compacted
+bool LoadHistory(Arena* arena, HistoryJournal* journal, VarArray* historyList, uxx* nextHistoryId)
+{
+	TracyCZoneN(Zone_Func, "LoadHistory", true);
+	ScratchBegin1(scratch, arena);
+	FilePath historyFilePath = GetHistoryFilePath(scratch, StrLit(HISTORY_FILENAME));
+	FilePath journalFilePath = GetHistoryFilePath(scratch, StrLit(HISTORY_JOURNAL_FILENAME));
+	FilePath indexFilePath = GetHistoryFilePath(scratch, StrLit(HISTORY_INDEX_FILENAME));
+	bool result = false;
+	
+	//NOTE: history.txt stays mapped for as long as any item hasn't been materialized, their urls point straight into it
+	if (OsDoesFileExist(historyFilePath) && platform->MapFile(historyFilePath, 0, 0, &journal->historyMapping))
+	{
+		journal->historyFileSize = journal->historyMapping.fileSize;
+		journal->generation = GetHistoryFileGeneration(journal->historyMapping.contents);
+		if (TryLoadHistoryIndex(arena, journal, indexFilePath, historyList, nextHistoryId)) { result = true; }
+		else
+		{
+			uxx numItemsBefore = historyList->length;
+			Result parseResult = TryDeserializeHistoryList(arena, journal->historyMapping.contents, historyList, nextHistoryId);
+			if (parseResult == Result_Success || parseResult == Result_EmptyFile)
+			{
+				PrintLine_D("Loaded %llu history items from \"%.*s\"", historyList->length - numItemsBefore, StrPrint(historyFilePath));
+				result = true;
+			}
+			else { PrintLine_E("Failed to parse %llu byte history file contents at \"%.*s\"! Error: %s", journal->historyMapping.contents.length, StrPrint(historyFilePath), GetResultStr(parseResult)); }
+			platform->UnmapFile(&journal->historyMapping);
+			//NOTE: Compacting on the next save writes the index we were missing
+			if (historyList->length > numItemsBefore) { journal->needsCompaction = true; }
+		}
+	}
+	else { PrintLine_D("No history file at \"%.*s\"", StrPrint(historyFilePath)); }
+	
+	if (OsDoesFileExist(journalFilePath))
+	{
+		//NOTE: A crash mid-append can leave a partial item at the end of the journal. Everything before it still loads,
+		// and compacting on the next save gets rid of the broken tail (or a journal left over from before history.txt was last replaced)
+		if (!LoadHistoryFile(arena, journalFilePath, &journal->generation, historyList, nextHistoryId, &journal->journalFileSize)) { journal->needsCompaction = true; }
+	}
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+	return result;
+}
@@ -0,0 +1,337 @@
+/*
+File:   app_search.c
+Date:   10\16\2026
+Description:
+	** Holds the HistorySearch, a trigram index behind the search box above the history
+	** list. Every item's url, request headers and content items are indexed when it's
+	** made and its response headers and body when it finishes (items loaded from disk
+	** get backfilled a few at a time). Text is lowercased (ASCII only) before it's split,
+	** so searches are case insensitive. A query intersects the posting lists of its
+	** trigrams, smallest first, and then the candidates that have all their text in
+	** memory are checked for the actual substring
+*/
+
+#define HISTORY_SEARCH_NUM_TRIGRAMS (1 << 24) //every possible 3 byte sequence
+
+u8 ToHistorySearchChar(u8 c)
+{
+	return (c >= 'A' && c <= 'Z') ? (u8)(c + ('a' - 'A')) : c;
+}
+
+u32 GetHistorySearchTrigram(const char* chars)
+{
+	return ((u32)ToHistorySearchChar((u8)chars[0]) << 16) | ((u32)ToHistorySearchChar((u8)chars[1]) << 8) | (u32)ToHistorySearchChar((u8)chars[2]);
+}
+
+// lowerQuery has to be lowercased already (see SetHistorySearchQuery)
+bool HistoryTextContains(Str8 text, Str8 lowerQuery)
+{
+	if (lowerQuery.length == 0) { return true; }
+	if (text.length < lowerQuery.length) { return false; }
+	u8 firstChar = (u8)lowerQuery.chars[0];
+	for (uxx cIndex = 0; cIndex + lowerQuery.length <= text.length; cIndex++)
+	{
+		if (ToHistorySearchChar((u8)text.chars[cIndex]) != firstChar) { continue; }
+		uxx qIndex = 1;
+		while (qIndex < lowerQuery.length && ToHistorySearchChar((u8)text.chars[cIndex + qIndex]) == (u8)lowerQuery.chars[qIndex]) { qIndex++; }
+		if (qIndex == lowerQuery.length) { return true; }
+	}
+	return false;
+}
+
+void InitHistorySearch(Arena* arena, HistorySearch* search)
+{
+	NotNull(search);
+	ClearPointer(search);
+	search->arena = arena;
+	InitHistoryLookup(arena, &search->trigrams);
+	InitVarArray(HistorySearchPostings, &search->postings, arena);
+	InitVarArray(uxx, &search->results, arena);
+	search->seenTrigrams = AllocArray(u8, arena, HISTORY_SEARCH_NUM_TRIGRAMS / 8);
+	NotNull(search->seenTrigrams);
+	MyMemSet(search->seenTrigrams, 0x00, HISTORY_SEARCH_NUM_TRIGRAMS / 8);
+}
+
+// Forgets everything that was indexed (the query stays), for when history gets cleared
+void ResetHistorySearch(HistorySearch* search)
+{
+	NotNull(search);
+	VarArrayLoop(&search->postings, pIndex)
+	{
+		VarArrayLoopGet(HistorySearchPostings, postings, &search->postings, pIndex);
+		if (postings->itemIndices != nullptr) { FreeArray(u32, search->arena, postings->capacity, postings->itemIndices); }
+	}
+	VarArrayClear(&search->postings);
+	FreeHistoryLookup(&search->trigrams);
+	VarArrayClear(&search->results);
+	search->numToBackfill = 0;
+	search->numBackfilled = 0;
+	search->resultsDirty = (search->query.length > 0);
+}
+
+// Takes a copy of the query, lowercased
+void SetHistorySearchQuery(HistorySearch* search, Str8 query)
+{
+	NotNull(search);
+	FreeStr8(search->arena, &search->query);
+	search->query = AllocStr8(search->arena, query);
+	for (uxx cIndex = 0; cIndex < search->query.length; cIndex++) { search->query.chars[cIndex] = (char)ToHistorySearchChar((u8)search->query.chars[cIndex]); }
+	search->resultsDirty = true;
+}
+
+// Posting lists are kept sorted. Items are nearly always indexed in order, only a response finishing after a
+// newer item's request was indexed (or a backfilled item) has to walk back from the end
+void AddHistorySearchPosting(HistorySearch* search, u32 trigram, u32 itemIndex)
+{
+	u64 key = (u64)trigram + 1;
+	uxx postingsIndex = HistoryLookupFind(&search->trigrams, key);
+	if (postingsIndex == UINTXX_MAX)
+	{
+		postingsIndex = search->postings.length;
+		HistorySearchPostings* newPostings = VarArrayAdd(HistorySearchPostings, &search->postings);
+		NotNull(newPostings);
+		ClearPointer(newPostings);
+		HistoryLookupAdd(&search->trigrams, key, postingsIndex);
+	}
+	HistorySearchPostings* postings = VarArrayGet(HistorySearchPostings, &search->postings, postingsIndex);
+	
+	uxx insertIndex = postings->count;
+	while (insertIndex > 0 && postings->itemIndices[insertIndex-1] >= itemIndex)
+	{
+		if (postings->itemIndices[insertIndex-1] == itemIndex) { return; }
+		insertIndex--;
+	}
+	if (postings->count >= postings->capacity)
+	{
+		uxx newCapacity = (postings->capacity > 0) ? postings->capacity * 2 : 4;
+		u32* newIndices = AllocArray(u32, search->arena, newCapacity);
+		NotNull(newIndices);
+		if (postings->count > 0) { MyMemCopy(newIndices, postings->itemIndices, sizeof(u32) * postings->count); }
+		if (postings->itemIndices != nullptr) { FreeArray(u32, search->arena, postings->capacity, postings->itemIndices); }
+		postings->itemIndices = newIndices;
+		postings->capacity = newCapacity;
+	}
+	if (insertIndex < postings->count) { memmove(&postings->itemIndices[insertIndex+1], &postings->itemIndices[insertIndex], sizeof(u32) * (postings->count - insertIndex)); }
+	postings->itemIndices[insertIndex] = itemIndex;
+	postings->count++;
+}
+
+// Adds the item to the posting list of every trigram in texts. Each text is split on its own, no trigram spans two of them
+void IndexHistorySearchTexts(HistorySearch* search, uxx historyIndex, uxx numTexts, const Str8* texts)
+{
+	NotNull(search);
+	Assert(historyIndex <= UINT32_MAX);
+	uxx maxTrigrams = 0;
+	for (uxx tIndex = 0; tIndex < numTexts; tIndex++) { if (texts[tIndex].length >= 3) { maxTrigrams += texts[tIndex].length - 2; } }
+	if (maxTrigrams == 0) { return; }
+	TracyCZoneN(Zone_Func, "IndexHistorySearchTexts", true);
+	
+	//NOTE: seenTrigrams dedupes within the item, so each posting list gets the item once no matter how often the trigram shows up
+	ScratchBegin(scratch);
+	u32* trigrams = AllocArray(u32, scratch, maxTrigrams);
+	NotNull(trigrams);
+	uxx numTrigrams = 0;
+	for (uxx tIndex = 0; tIndex < numTexts; tIndex++)
+	{
+		Str8 text = texts[tIndex];
+		for (uxx cIndex = 0; cIndex + 3 <= text.length; cIndex++)
+		{
+			u32 trigram = GetHistorySearchTrigram(&text.chars[cIndex]);
+			u8 bit = (u8)(1 << (trigram & 7));
+			if ((search->seenTrigrams[trigram >> 3] & bit) != 0) { continue; }
+			search->seenTrigrams[trigram >> 3] |= bit;
+			trigrams[numTrigrams] = trigram;
+			numTrigrams++;
+		}
+	}
+	for (uxx tIndex = 0; tIndex < numTrigrams; tIndex++)
+	{
+		search->seenTrigrams[trigrams[tIndex] >> 3] = 0x00;
+		AddHistorySearchPosting(search, trigrams[tIndex], (u32)historyIndex);
+	}
+	ScratchEnd(scratch);
+	if (search->query.length > 0) { search->resultsDirty = true; }
+	TracyCZoneEnd(Zone_Func);
+}
+
+// The url, request headers and content items
+void IndexHistoryItemRequest(HistorySearch* search, uxx historyIndex, const HistoryItem* item)
+{
+	NotNull(item);
+	ScratchBegin(scratch);
+	uxx numTexts = 1 + (item->numHeaders * 2) + (item->numContentItems * 2);
+	Str8* texts = AllocArray(Str8, scratch, numTexts);
+	NotNull(texts);
+	uxx textIndex = 0;
+	texts[textIndex++] = item->url;
+	for (uxx hIndex = 0; hIndex < item->numHeaders; hIndex++) { texts[textIndex++] = item->headers[hIndex].key; texts[textIndex++] = item->headers[hIndex].value; }
+	for (uxx cIndex = 0; cIndex < item->numContentItems; cIndex++) { texts[textIndex++] = item->contentItems[cIndex].key; texts[textIndex++] = item->contentItems[cIndex].value; }
+	Assert(textIndex == numTexts);
+	IndexHistorySearchTexts(search, historyIndex, numTexts, texts);
+	ScratchEnd(scratch);
+}
+
+// The response headers and the first HISTORY_SEARCH_MAX_BODY_SIZE bytes of the body
+void IndexHistoryItemResponse(HistorySearch* search, uxx historyIndex, uxx numHeaders, const Str8Pair* headers, Str8 body)
+{
+	ScratchBegin(scratch);
+	uxx numTexts = 1 + (numHeaders * 2);
+	Str8* texts = AllocArray(Str8, scratch, numTexts);
+	NotNull(texts);
+	uxx textIndex = 0;
+	texts[textIndex++] = (body.length > HISTORY_SEARCH_MAX_BODY_SIZE) ? StrSlice(body, 0, HISTORY_SEARCH_MAX_BODY_SIZE) : body;
+	for (uxx hIndex = 0; hIndex < numHeaders; hIndex++) { texts[textIndex++] = headers[hIndex].key; texts[textIndex++] = headers[hIndex].value; }
+	IndexHistorySearchTexts(search, historyIndex, numTexts, texts);
+	ScratchEnd(scratch);
+}
+
+// Indexes items that were loaded from disk, oldest first, until timeBudgetUs runs out. Nothing is loaded into the items
+// themselves: ones that still needsMaterialize are parsed into scratch and saved responses are read straight from the
+// HistoryBlobStore, so backfilling doesn't undo the lazy loading or the memory budget
+void BackfillHistorySearch(HistorySearch* search, HistoryBlobStore* blobs, VarArray* historyList, u64 timeBudgetUs)
+{
+	NotNull(search);
+	if (search->numBackfilled >= search->numToBackfill) { return; }
+	TracyCZoneN(Zone_Func, "BackfillHistorySearch", true);
+	u64 startTimeUs = SysGetTimeUs();
+	while (search->numBackfilled < search->numToBackfill && SysGetTimeUs() - startTimeUs < timeBudgetUs)
+	{
+		uxx historyIndex = search->numBackfilled;
+		search->numBackfilled++;
+		HistoryItem* item = VarArrayGet(HistoryItem, historyList, historyIndex);
+		ScratchBegin(scratch);
+		
+		//NOTE: The index only gave an unmaterialized item its url, the rest (including where its blob is) comes from parsing
+		const HistoryItem* sourceItem = item;
+		HistoryItem parsedItem = ZEROED;
+		if (item->needsMaterialize && TryDeserializeHistoryItem(scratch, item->indexedText, &parsedItem) == Result_Success) { sourceItem = &parsedItem; }
+		IndexHistoryItemRequest(search, historyIndex, sourceItem);
+		
+		if (sourceItem->hasBlob && !item->blobLoaded)
+		{
+			FileMapping mapping = ZEROED;
+			FileMapping bodyMapping = ZEROED;
+			Str8 body = Str8_Empty;
+			Str8 headerBytes = Str8_Empty;
+			u32 numHeaders = 0;
+			Str8Pair* headers = nullptr;
+			if (MapHistoryBlob(blobs, sourceItem, &mapping, &bodyMapping, &body, &headerBytes, &numHeaders))
+			{
+				if (ParseHistoryBlobHeaders(scratch, headerBytes, numHeaders, &headers)) { IndexHistoryItemResponse(search, historyIndex, numHeaders, headers, body); }
+				platform->UnmapFile(&bodyMapping);
+				platform->UnmapFile(&mapping);
+			}
+		}
+		else if (item->finished) { IndexHistoryItemResponse(search, historyIndex, item->numResponseHeaders, item->responseHeaders, item->response); }
+		ScratchEnd(scratch);
+	}
+	TracyCZoneEnd(Zone_Func);
+}
+
+// Returns false only when all of the item's text is in memory and the query isn't in any of it. Items that haven't
+// been materialized or whose response isn't loaded (on disk, evicted or compressed) are left to the trigram check
+bool HistoryItemMatchesSearch(const HistoryItem* item, Str8 lowerQuery)
+{
+	if (HistoryTextContains(item->url, lowerQuery)) { return true; }
+	if (item->needsMaterialize) { return true; }
+	for (uxx hIndex = 0; hIndex < item->numHeaders; hIndex++)
+	{
+		if (HistoryTextContains(item->headers[hIndex].key, lowerQuery) || HistoryTextContains(item->headers[hIndex].value, lowerQuery)) { return true; }
+	}
+	for (uxx cIndex = 0; cIndex < item->numContentItems; cIndex++)
+	{
+		if (HistoryTextContains(item->contentItems[cIndex].key, lowerQuery) || HistoryTextContains(item->contentItems[cIndex].value, lowerQuery)) { return true; }
+	}
+	
+	if ((item->hasBlob && !item->blobLoaded) || item->responseDetached) { return true; }
+	for (uxx hIndex = 0; hIndex < item->numResponseHeaders; hIndex++)
+	{
+		if (HistoryTextContains(item->responseHeaders[hIndex].key, lowerQuery) || HistoryTextContains(item->responseHeaders[hIndex].value, lowerQuery)) { return true; }
+	}
+	Str8 body = (item->response.length > HISTORY_SEARCH_MAX_BODY_SIZE) ? StrSlice(item->response, 0, HISTORY_SEARCH_MAX_BODY_SIZE) : item->response;
+	return HistoryTextContains(body, lowerQuery);
+}
+
+// First index at or after startIndex whose item is >= itemIndex (count if there isn't one)
+uxx FindHistorySearchPosting(const HistorySearchPostings* postings, uxx startIndex, u32 itemIndex)
+{
+	uxx low = startIndex;
+	uxx high = postings->count;
+	while (low < high)
+	{
+		uxx middle = low + (high - low) / 2;
+		if (postings->itemIndices[middle] < itemIndex) { low = middle + 1; }
+		else { high = middle; }
+	}
+	return low;
+}
+
+// Rebuilds results for the current query. Queries shorter than a trigram can't use the index, those only look at urls
+void UpdateHistorySearchResults(HistorySearch* search, VarArray* historyList)
+{
+	NotNull(search);
+	VarArrayClear(&search->results);
+	search->resultsDirty = false;
+	if (search->query.length == 0) { return; }
+	TracyCZoneN(Zone_Func, "UpdateHistorySearchResults", true);
+	
+	if (search->query.length < 3)
+	{
+		VarArrayLoop(historyList, hIndex)
+		{
+			VarArrayLoopGet(HistoryItem, item, historyList, hIndex);
+			if (HistoryTextContains(item->url, search->query)) { uxx* resultSpace = VarArrayAdd(uxx, &search->results); NotNull(resultSpace); *resultSpace = hIndex; }
+		}
+		TracyCZoneEnd(Zone_Func);
+		return;
+	}
+	
+	ScratchBegin(scratch);
+	uxx maxLists = search->query.length - 2;
+	const HistorySearchPostings** lists = AllocArray(const HistorySearchPostings*, scratch, maxLists);
+	uxx* cursors = AllocArray(uxx, scratch, maxLists);
+	NotNull(lists);
+	NotNull(cursors);
+	uxx numLists = 0;
+	bool anyMissing = false;
+	for (uxx qIndex = 0; qIndex < maxLists && !anyMissing; qIndex++)
+	{
+		uxx postingsIndex = HistoryLookupFind(&search->trigrams, (u64)GetHistorySearchTrigram(&search->query.chars[qIndex]) + 1);
+		if (postingsIndex == UINTXX_MAX) { anyMissing = true; break; }
+		const HistorySearchPostings* postings = VarArrayGet(HistorySearchPostings, &search->postings, postingsIndex);
+		bool alreadyAdded = false;
+		for (uxx lIndex = 0; lIndex < numLists; lIndex++) { if (lists[lIndex] == postings) { alreadyAdded = true; break; } }
+		if (alreadyAdded) { continue; }
+		
+		//NOTE: Insertion sort by count, so we walk the rarest trigram and only binary search the others
+		uxx insertIndex = numLists;
+		while (insertIndex > 0 && lists[insertIndex-1]->count > postings->count) { lists[insertIndex] = lists[insertIndex-1]; insertIndex--; }
+		lists[insertIndex] = postings;
+		cursors[numLists] = 0;
+		numLists++;
+	}
+	
+	if (!anyMissing && numLists > 0)
+	{
+		const HistorySearchPostings* rarest = lists[0];
+		for (uxx rIndex = 0; rIndex < rarest->count; rIndex++)
+		{
+			u32 itemIndex = rarest->itemIndices[rIndex];
+			bool inAllLists = true;
+			bool listsExhausted = false;
+			for (uxx lIndex = 1; lIndex < numLists; lIndex++)
+			{
+				cursors[lIndex] = FindHistorySearchPosting(lists[lIndex], cursors[lIndex], itemIndex);
+				if (cursors[lIndex] >= lists[lIndex]->count) { listsExhausted = true; inAllLists = false; break; }
+				if (lists[lIndex]->itemIndices[cursors[lIndex]] != itemIndex) { inAllLists = false; break; }
+			}
+			if (listsExhausted) { break; }
+			if (!inAllLists || itemIndex >= historyList->length) { continue; }
+			
+			HistoryItem* item = VarArrayGet(HistoryItem, historyList, itemIndex);
+			if (HistoryItemMatchesSearch(item, search->query)) { uxx* resultSpace = VarArrayAdd(uxx, &search->results); NotNull(resultSpace); *resultSpace = itemIndex; }
+		}
+	}
+	ScratchEnd(scratch);
+	TracyCZoneEnd(Zone_Func);
+}
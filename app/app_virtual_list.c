@@ -0,0 +1,111 @@
+/*
+File:   app_virtual_list.c
+Date:   10\16\2026
+Description:
+	** Holds the VirtualListView, a stand-in for PigCore's UiListView for lists that can
+	** get too long to build every frame (i.e. history). Rows all have the same height and
+	** are only ever described by their index, the caller's render callback is asked for
+	** the ones that are on screen and two spacers stand in for everything above and below
+	** them, so Clay's scroll container still sees the full height of the list
+*/
+
+#if BUILD_WITH_SOKOL_GFX
+
+void InitVirtualListView(Arena* arena, Str8 idStr, VirtualListView* list)
+{
+	NotNull(arena);
+	NotNull(list);
+	ClearPointer(list);
+	list->arena = arena;
+	list->idStr = AllocStr8(arena, idStr);
+}
+
+void FreeVirtualListView(VirtualListView* list)
+{
+	NotNull(list);
+	if (list->arena != nullptr) { FreeStr8(list->arena, &list->idStr); }
+	ClearPointer(list);
+}
+
+// Per frame cost only depends on how many rows fit on screen, not numRows. The list lays itself out with last frame's
+// scroll position and size (before the first layout we just assume it's as tall as the window)
+void DoVirtualListView(VirtualListView* list, Clay_SizingAxis width, Clay_SizingAxis height, r32 rowHeight, uxx numRows, VirtualListRowRender_f* renderRow, void* userPntr)
+{
+	NotNull(list);
+	NotNull(renderRow);
+	Assert(rowHeight > 0.0f);
+	TracyCZoneN(Zone_Func, "DoVirtualListView", true);
+	ClayId listId = ToClayId(list->idStr);
+	
+	if (list->selectionActive && list->selectionIndex >= numRows) { list->selectionActive = false; }
+	
+	r32 viewHeight = (r32)appIn->screenSize.height;
+	r32 scrollOffset = 0.0f;
+	Clay_ScrollContainerData scrollData = Clay_GetScrollContainerData(listId);
+	if (scrollData.found)
+	{
+		viewHeight = scrollData.scrollContainerDimensions.height;
+		r32 maxScrollOffset = MaxR32(0.0f, (numRows * rowHeight) - viewHeight);
+		if (list->scrollToSelection && list->selectionActive)
+		{
+			r32 selectionTop = list->selectionIndex * rowHeight;
+			if (selectionTop < -scrollData.scrollPosition->y) { scrollData.scrollPosition->y = -selectionTop; }
+			else if (selectionTop + rowHeight > -scrollData.scrollPosition->y + viewHeight) { scrollData.scrollPosition->y = -(selectionTop + rowHeight - viewHeight); }
+		}
+		//NOTE: The list can shrink (a search, or Clear) before Clay gets a chance to clamp the scroll position
+		scrollData.scrollPosition->y = ClampR32(scrollData.scrollPosition->y, -maxScrollOffset, 0.0f);
+		scrollOffset = -scrollData.scrollPosition->y;
+	}
+	list->scrollToSelection = false;
+	
+	uxx firstRow = MinUXX((uxx)(scrollOffset / rowHeight), numRows);
+	uxx endRow = MinUXX(firstRow + (uxx)CeilR32i(viewHeight / rowHeight) + 1, numRows);
+	
+	CLAY({ .id = listId,
+		.layout = {
+			.sizing = { .width = width, .height = height },
+			.layoutDirection = CLAY_TOP_TO_BOTTOM,
+		},
+		.scroll = { .vertical = true },
+	})
+	{
+		if (firstRow > 0)
+		{
+			CLAY({ .layout = { .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(firstRow * rowHeight) } } }) {}
+		}
+		
+		for (uxx rowIndex = firstRow; rowIndex < endRow; rowIndex++)
+		{
+			ClayId rowId = ToClayIdPrint(uiArena, "%.*s_Row%llu", StrPrint(list->idStr), (u64)rowIndex);
+			bool isSelected = (list->selectionActive && list->selectionIndex == rowIndex);
+			bool isHovered = (!list->selectionDisabled && IsMouseOverClayInContainer(listId, rowId));
+			if (isHovered && IsMouseBtnPressed(&appIn->mouse, nullptr, MouseBtn_Left))
+			{
+				list->selectionActive = true;
+				list->selectionIndex = rowIndex;
+				list->selectionChanged = true;
+				isSelected = true;
+			}
+			
+			CLAY({ .id = rowId,
+				.layout = {
+					.sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED(rowHeight) },
+					.layoutDirection = CLAY_LEFT_TO_RIGHT,
+					.childAlignment = { .y = CLAY_ALIGN_Y_CENTER },
+				},
+				.backgroundColor = isSelected ? MonokaiLightGray : (isHovered ? MonokaiGray2 : Transparent),
+			})
+			{
+				renderRow(list, userPntr, rowIndex, isSelected, isHovered);
+			}
+		}
+		
+		if (endRow < numRows)
+		{
+			CLAY({ .layout = { .sizing = { .width = CLAY_SIZING_GROW(0), .height = CLAY_SIZING_FIXED((numRows - endRow) * rowHeight) } } }) {}
+		}
+	}
+	TracyCZoneEnd(Zone_Func);
+}
+
+#endif //BUILD_WITH_SOKOL_GFX
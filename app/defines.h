@@ -12,9 +12,65 @@ Date:   02\25\2025
 #define MIN_UI_FONT_SIZE       9
 #define DEFAULT_UI_FONT_SIZE   14
 
-#define HISTORY_FILENAME "history.txt"
+#define HISTORY_FILENAME         "history.txt"
+#define HISTORY_JOURNAL_FILENAME "history_journal.txt" //finished items are appended here, then folded into HISTORY_FILENAME when we compact
+#define HISTORY_BLOBS_FILENAME   "history_blobs.bin" //response bodies and headers, see HistoryBlobStore
+#define HISTORY_INDEX_FILENAME   "history_index.bin" //written alongside HISTORY_FILENAME when we compact, see HistoryIndexHeader
+#define HISTORY_GENERATION_KEY   "Generation" //first line of HISTORY_FILENAME and HISTORY_JOURNAL_FILENAME, see HistoryJournal.generation
 
 #define SAVE_HISTORY_DELAY 1000 //ms
+#define HISTORY_COMPACT_MIN_SIZE Kilobytes(256) //the journal is only compacted once it's at least this big (and half the size of the history file)
+#define HISTORY_PARALLEL_MIN_ITEMS 512 //fewer items than this are parsed on the calling thread, starting workers would cost more than it saves
+#define HISTORY_PARSE_JOB_SIZE     64 //items per job handed to a worker
+// Once the response bodies we're holding add up to more than this, the least recently viewed ones are dropped (they're
+// still in HISTORY_BLOBS_FILENAME and come back when selected). Can be overridden with --historyMemory=MB, 0 means no limit
+#define HISTORY_DEFAULT_MEMORY_BUDGET  Megabytes(512)
+#define HISTORY_MEMORY_CHECK_INTERVAL  500 //ms between EnforceHistoryMemoryBudget passes
+#define HISTORY_LARGE_TEXT_LINE_SIZE   48 //rough bytes a UiLargeText keeps per line, only used to estimate memory usage
+// Bodies that no item is showing are compressed in memory (see app_compress.c) once they've been saved to HISTORY_BLOBS_FILENAME
+#define HISTORY_COMPRESS_MIN_SIZE      Kilobytes(4) //smaller bodies are left alone
+#define HISTORY_COMPRESS_MIN_SAVINGS   8 //compression has to save at least 1/8th of the body or we keep it raw
+#define HISTORY_SEARCH_MAX_BODY_SIZE   Megabytes(1) //only the start of bigger bodies gets indexed for search
+#define HISTORY_SEARCH_BACKFILL_TIME   4 //ms per frame spent indexing items that were loaded from disk
+#define HISTORY_VIEW_REBUILD_INTERVAL  250 //ms, how long new or finished items can wait to show up in a filtered or sorted history list
+
+#define HTTP_SERVICE_SLEEP_TIME     1 //ms between HttpRequestManager updates on the service thread while requests are running (on Linux the most we'll wait in epoll_wait)
+#define HTTP_SERVICE_IDLE_WAIT_TIME 1000 //ms, on Linux the most an idle service thread waits before checking its keep-alive connections again
+// Can be overridden with --maxRequests=N and --maxPerHost=N
+// On Linux --httpIo=uring switches the HTTP backend from epoll to io_uring (falling back to epoll if the kernel can't do it)
+#define HTTP_DEFAULT_MAX_RUNNING          64
+#define HTTP_DEFAULT_MAX_RUNNING_PER_HOST 8
+
+#define LINUX_HTTP_MAX_EPOLL_EVENTS      1024 //sockets handled per epoll_wait
+#define LINUX_HTTP_READ_BUFFER_SIZE      Kilobytes(64)
+#define LINUX_HTTP_MAX_READS_PER_EVENT   16 //so one fast connection can't starve the rest
+#define LINUX_HTTP_MAX_HEADER_SIZE       Kilobytes(64)
+#define LINUX_HTTP_MAX_CHUNK_LINE_SIZE   1024
+#define LINUX_HTTP_IDLE_TIMEOUT          30000000 //us an unused keep-alive connection is kept open for
+#define LINUX_HTTP_DNS_CACHE_TIME        60000000 //us before a host gets resolved again
+#define LINUX_HTTP_URING_ENTRIES         4096 //submission queue size, the completion queue is twice this
+#define LINUX_HTTP_URING_MAX_REAP        1024 //completions copied out of the ring at a time
+#define LINUX_HTTP_URING_RECV_SIZE       Kilobytes(16) //per connection receive buffer in io_uring mode
+#define LINUX_HTTP_UPLOAD_SEND_SIZE      Megabytes(4) //most of an upload body we hand to a single sendfile/send
+#define HTTP_DOWNLOAD_PROGRESS_INTERVAL  100000 //us between the (byteless) progress events sent for a request that's downloading to a file
+#define HTTP_ACCEPT_ENCODING             "gzip, deflate" //sent unless the request already has an Accept-Encoding header (or won't keep the body anyways)
+#define HTTP_DECODE_OUTPUT_SIZE          Kilobytes(64) //the decode thread hands decoded bytes to the app in Data events of at most this size
+#define HTTP_DECODE_MAX_QUEUED_EVENTS    64 //the decode thread pauses once the app has this many events waiting, see PushDecodedHttpData
+
+#define RESPONSE_MIN_CHUNK_SIZE      Kilobytes(4)
+#define RESPONSE_MAX_CHUNK_SIZE      Megabytes(1)
+#define RESPONSE_PREVIEW_MAX_LINE_LENGTH  Kilobytes(4) //the streaming preview only shows the start of longer lines
+
+// Seconds, what the timeout textboxes start with. 0 means no limit
+#define HTTP_DEFAULT_CONNECT_TIMEOUT    "10"
+#define HTTP_DEFAULT_FIRST_BYTE_TIMEOUT "60"
+#define HTTP_DEFAULT_IDLE_TIMEOUT       "60"
+#define HTTP_DEFAULT_TOTAL_TIMEOUT      "0"
+
+#define LOAD_TEST_DEFAULT_RATE      "10" //requests/second
+#define LOAD_TEST_DEFAULT_DURATION  "10" //seconds
+#define LOAD_TEST_SCHEDULE_AHEAD    100000 //us, how far ahead of their start time we hand requests to the HttpService
+#define LOAD_TEST_DRAIN_TIMEOUT     30000000 //us after the last intended send time before we stop waiting on outstanding requests
 
 #define DEFAULT_WINDOW_SIZE   MakeV2(800, 600)
 #define MIN_WINDOW_SIZE       MakeV2(150, 100)
@@ -0,0 +1,154 @@
+/*
+File:   latency_histogram.h
+Date:   10\16\2026
+Description:
+	** A high-dynamic-range histogram for recording latencies (in microseconds) in
+	** the style of HdrHistogram. Values are bucketed into power-of-two buckets that
+	** are each split into linear sub-buckets, so every recorded value keeps ~3
+	** significant digits of precision all the way from 1us up to an hour while
+	** recording stays O(1) and memory stays fixed (~190kB)
+	** This is header-only so both the app and the headless platform runner can use it
+*/
+
+#ifndef _LATENCY_HISTOGRAM_H
+#define _LATENCY_HISTOGRAM_H
+
+#define LATENCY_HISTOGRAM_SUB_BUCKET_BITS  11 //2048 sub-buckets gives us 3 significant digits
+#define LATENCY_HISTOGRAM_SUB_BUCKET_COUNT (1ULL << LATENCY_HISTOGRAM_SUB_BUCKET_BITS)
+#define LATENCY_HISTOGRAM_SUB_BUCKET_HALF  (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT / 2)
+#define LATENCY_HISTOGRAM_SUB_BUCKET_MASK  (LATENCY_HISTOGRAM_SUB_BUCKET_COUNT - 1)
+#define LATENCY_HISTOGRAM_DEFAULT_HIGHEST  (60ULL * 60ULL * 1000000ULL) //1 hour in microseconds
+
+typedef plex LatencyHistogram LatencyHistogram;
+plex LatencyHistogram
+{
+	Arena* arena;
+	u64 highestTrackableValue;
+	uxx bucketCount;
+	uxx numCounts;
+	u64* counts;
+	
+	u64 totalCount;
+	u64 minValue;
+	u64 maxValue;
+	u64 sumValues;
+	u64 numClamped; //values above highestTrackableValue get recorded as highestTrackableValue
+};
+
+SYS_HELPER_DEF u8 LatencyHistogramLeadingZeros(u64 value)
+{
+	DebugAssert(value != 0);
+	u8 result = 0;
+	if ((value & 0xFFFFFFFF00000000ULL) == 0) { result += 32; value <<= 32; }
+	if ((value & 0xFFFF000000000000ULL) == 0) { result += 16; value <<= 16; }
+	if ((value & 0xFF00000000000000ULL) == 0) { result += 8;  value <<= 8;  }
+	if ((value & 0xF000000000000000ULL) == 0) { result += 4;  value <<= 4;  }
+	if ((value & 0xC000000000000000ULL) == 0) { result += 2;  value <<= 2;  }
+	if ((value & 0x8000000000000000ULL) == 0) { result += 1; }
+	return result;
+}
+
+SYS_HELPER_DEF uxx GetLatencyHistogramIndex(u64 value)
+{
+	uxx pow2Ceiling = 64 - (uxx)LatencyHistogramLeadingZeros(value | LATENCY_HISTOGRAM_SUB_BUCKET_MASK);
+	uxx bucketIndex = pow2Ceiling - LATENCY_HISTOGRAM_SUB_BUCKET_BITS;
+	uxx subBucketIndex = (uxx)(value >> bucketIndex);
+	return ((bucketIndex + 1) << (LATENCY_HISTOGRAM_SUB_BUCKET_BITS-1)) + (subBucketIndex - LATENCY_HISTOGRAM_SUB_BUCKET_HALF);
+}
+
+// Returns the highest value that would land in the same counts slot as index
+SYS_HELPER_DEF u64 GetLatencyHistogramValueAtIndex(uxx index)
+{
+	ixx bucketIndex = (ixx)(index >> (LATENCY_HISTOGRAM_SUB_BUCKET_BITS-1)) - 1;
+	u64 subBucketIndex = (u64)(index & (LATENCY_HISTOGRAM_SUB_BUCKET_HALF-1)) + LATENCY_HISTOGRAM_SUB_BUCKET_HALF;
+	if (bucketIndex < 0) { subBucketIndex -= LATENCY_HISTOGRAM_SUB_BUCKET_HALF; bucketIndex = 0; }
+	u64 lowestValue = subBucketIndex << bucketIndex;
+	u64 rangeSize = 1ULL << bucketIndex;
+	return lowestValue + rangeSize - 1;
+}
+
+SYS_HELPER_DEF void InitLatencyHistogram(Arena* arena, u64 highestTrackableValue, LatencyHistogram* histogramOut)
+{
+	NotNull(arena);
+	NotNull(histogramOut);
+	Assert(highestTrackableValue >= LATENCY_HISTOGRAM_SUB_BUCKET_COUNT);
+	ClearPointer(histogramOut);
+	histogramOut->arena = arena;
+	histogramOut->highestTrackableValue = highestTrackableValue;
+	
+	u64 smallestUntrackable = LATENCY_HISTOGRAM_SUB_BUCKET_COUNT;
+	histogramOut->bucketCount = 1;
+	while (smallestUntrackable <= highestTrackableValue && smallestUntrackable < (UINT64_MAX/2))
+	{
+		smallestUntrackable <<= 1;
+		histogramOut->bucketCount++;
+	}
+	histogramOut->numCounts = (histogramOut->bucketCount + 1) * LATENCY_HISTOGRAM_SUB_BUCKET_HALF;
+	histogramOut->counts = AllocArray(u64, arena, histogramOut->numCounts);
+	NotNull(histogramOut->counts);
+	MyMemSet(histogramOut->counts, 0x00, sizeof(u64) * histogramOut->numCounts);
+	histogramOut->minValue = UINT64_MAX;
+}
+
+SYS_HELPER_DEF void FreeLatencyHistogram(LatencyHistogram* histogram)
+{
+	NotNull(histogram);
+	if (histogram->counts != nullptr) { FreeArray(u64, histogram->arena, histogram->numCounts, histogram->counts); }
+	ClearPointer(histogram);
+}
+
+SYS_HELPER_DEF void ResetLatencyHistogram(LatencyHistogram* histogram)
+{
+	NotNull(histogram);
+	NotNull(histogram->counts);
+	MyMemSet(histogram->counts, 0x00, sizeof(u64) * histogram->numCounts);
+	histogram->totalCount = 0;
+	histogram->minValue = UINT64_MAX;
+	histogram->maxValue = 0;
+	histogram->sumValues = 0;
+	histogram->numClamped = 0;
+}
+
+SYS_HELPER_DEF void RecordLatency(LatencyHistogram* histogram, u64 value)
+{
+	NotNull(histogram);
+	NotNull(histogram->counts);
+	if (value > histogram->highestTrackableValue) { value = histogram->highestTrackableValue; histogram->numClamped++; }
+	uxx index = GetLatencyHistogramIndex(value);
+	DebugAssert(index < histogram->numCounts);
+	histogram->counts[index]++;
+	histogram->totalCount++;
+	histogram->sumValues += value;
+	if (value < histogram->minValue) { histogram->minValue = value; }
+	if (value > histogram->maxValue) { histogram->maxValue = value; }
+}
+
+// percentile is 0-100, so 99.9 means p99.9
+SYS_HELPER_DEF u64 GetLatencyPercentile(const LatencyHistogram* histogram, r64 percentile)
+{
+	NotNull(histogram);
+	if (histogram->totalCount == 0) { return 0; }
+	if (percentile >= 100.0) { return histogram->maxValue; }
+	u64 targetCount = (u64)((percentile / 100.0) * (r64)histogram->totalCount + 0.5);
+	if (targetCount < 1) { targetCount = 1; }
+	u64 runningCount = 0;
+	for (uxx cIndex = 0; cIndex < histogram->numCounts; cIndex++)
+	{
+		runningCount += histogram->counts[cIndex];
+		if (runningCount >= targetCount)
+		{
+			u64 result = GetLatencyHistogramValueAtIndex(cIndex);
+			return (result > histogram->maxValue) ? histogram->maxValue : result;
+		}
+	}
+	return histogram->maxValue;
+}
+
+SYS_HELPER_DEF r64 GetLatencyMean(const LatencyHistogram* histogram)
+{
+	NotNull(histogram);
+	if (histogram->totalCount == 0) { return 0.0; }
+	return (r64)histogram->sumValues / (r64)histogram->totalCount;
+}
+
+#endif //  _LATENCY_HISTOGRAM_H
@@ -6,6 +6,13 @@ Description:
 	** Holds implementations for the PlatformApi functions defined in platform_interface.h
 */
 
+#if TARGET_IS_LINUX || TARGET_IS_OSX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 // +==============================+
 // |  Plat_GetNativeWindowHandle  |
 // +==============================+
@@ -35,6 +42,110 @@ GET_NATIVE_WINDOW_HANDLE_DEF(Plat_GetNativeWindowHandle)
 	return result;
 }
 
+// +==============================+
+// |         Plat_MapFile         |
+// +==============================+
+// bool Plat_MapFile(FilePath path, u64 offset, uxx size, FileMapping* mappingOut)
+MAP_FILE_DEF(Plat_MapFile)
+{
+	NotNull(mappingOut);
+	ClearPointer(mappingOut);
+	ScratchBegin(scratch);
+	Str8 pathNt = AllocStrAndCopy(scratch, path.length, path.chars, true);
+	bool result = false;
+	
+	#if TARGET_IS_LINUX || TARGET_IS_OSX
+	{
+		int fd = open(pathNt.chars, O_RDONLY|O_CLOEXEC);
+		struct stat fileInfo = ZEROED;
+		if (fd >= 0 && fstat(fd, &fileInfo) == 0)
+		{
+			mappingOut->fileSize = (u64)fileInfo.st_size;
+			if (size == 0 && offset < mappingOut->fileSize) { size = (uxx)(mappingOut->fileSize - offset); }
+			if (offset + size > mappingOut->fileSize) { PrintLine_W("Can't map %llu bytes at %llu, \"%.*s\" is only %llu bytes", (u64)size, offset, StrPrint(path), mappingOut->fileSize); }
+			else if (size == 0) { result = true; }
+			else
+			{
+				u64 pageSize = (u64)sysconf(_SC_PAGESIZE);
+				u64 alignedOffset = offset - (offset % pageSize);
+				uxx mappedSize = (uxx)(offset - alignedOffset) + size;
+				void* mappedPntr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, (off_t)alignedOffset);
+				if (mappedPntr != MAP_FAILED)
+				{
+					mappingOut->isMapped = true;
+					mappingOut->mappedPntr = mappedPntr;
+					mappingOut->mappedSize = mappedSize;
+					mappingOut->contents = MakeStr8(size, (char*)mappedPntr + (offset - alignedOffset));
+					result = true;
+				}
+				else { PrintLine_W("Failed to map %llu bytes of \"%.*s\"", (u64)size, StrPrint(path)); }
+			}
+		}
+		if (fd >= 0) { close(fd); }
+	}
+	#elif TARGET_IS_WINDOWS
+	{
+		HANDLE fileHandle = CreateFileA(pathNt.chars, GENERIC_READ, FILE_SHARE_READ|FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		LARGE_INTEGER fileSize = ZEROED;
+		if (fileHandle != INVALID_HANDLE_VALUE && GetFileSizeEx(fileHandle, &fileSize))
+		{
+			mappingOut->fileSize = (u64)fileSize.QuadPart;
+			if (size == 0 && offset < mappingOut->fileSize) { size = (uxx)(mappingOut->fileSize - offset); }
+			if (offset + size > mappingOut->fileSize) { PrintLine_W("Can't map %llu bytes at %llu, \"%.*s\" is only %llu bytes", (u64)size, offset, StrPrint(path), mappingOut->fileSize); }
+			else if (size == 0) { result = true; }
+			else
+			{
+				SYSTEM_INFO systemInfo = ZEROED;
+				GetSystemInfo(&systemInfo);
+				u64 alignedOffset = offset - (offset % (u64)systemInfo.dwAllocationGranularity);
+				uxx mappedSize = (uxx)(offset - alignedOffset) + size;
+				//NOTE: The view keeps the mapping object alive, so both handles can be closed right away
+				HANDLE mappingHandle = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+				void* mappedPntr = nullptr;
+				if (mappingHandle != nullptr)
+				{
+					mappedPntr = MapViewOfFile(mappingHandle, FILE_MAP_READ, (DWORD)(alignedOffset >> 32), (DWORD)(alignedOffset & 0xFFFFFFFFULL), mappedSize);
+					CloseHandle(mappingHandle);
+				}
+				if (mappedPntr != nullptr)
+				{
+					mappingOut->isMapped = true;
+					mappingOut->mappedPntr = mappedPntr;
+					mappingOut->mappedSize = mappedSize;
+					mappingOut->contents = MakeStr8(size, (char*)mappedPntr + (offset - alignedOffset));
+					result = true;
+				}
+				else { PrintLine_W("Failed to map %llu bytes of \"%.*s\"", (u64)size, StrPrint(path)); }
+			}
+		}
+		if (fileHandle != INVALID_HANDLE_VALUE) { CloseHandle(fileHandle); }
+	}
+	#else
+	AssertMsg(false, "Plat_MapFile doesn't have an implementation for the current TARGET!");
+	#endif
+	
+	ScratchEnd(scratch);
+	return result;
+}
+
+// +==============================+
+// |        Plat_UnmapFile        |
+// +==============================+
+// void Plat_UnmapFile(FileMapping* mapping)
+UNMAP_FILE_DEF(Plat_UnmapFile)
+{
+	NotNull(mapping);
+	if (mapping->isMapped)
+	{
+		#if TARGET_IS_LINUX || TARGET_IS_OSX
+		munmap(mapping->mappedPntr, mapping->mappedSize);
+		#elif TARGET_IS_WINDOWS
+		UnmapViewOfFile(mapping->mappedPntr);
+		#endif
+	}
+	ClearPointer(mapping);
+}
+
 #if BUILD_WITH_SOKOL_APP
 
 // +==============================+
@@ -0,0 +1,328 @@
+/*
+File:   platform_headless.c
+Date:   10\16\2026
+Description:
+	** Holds the --headless entry point. sokol_main hands off to RunHeadless before any
+	** window, graphics context, font or app dll exists, so startup is just parsing a
+	** request file and spinning up the HttpService. Every request in the file (the
+	** history file format, which is also what we read when no file is given) is run
+	** through the HttpService, each result is printed as it finishes and a summary with
+	** latency percentiles follows. The exit code is non-zero if anything failed, which
+	** makes it easy to use as a gate in CI scripts
+*/
+
+#if BUILD_WITH_HTTP
+
+#include <stdio.h>
+
+// Strips the quotes SerializeHistory puts around content keys and values so leading/trailing whitespace survives
+Str8 StripHeadlessQuotes(Str8 str)
+{
+	if (str.length >= 2 && str.chars[0] == '"' && str.chars[str.length-1] == '"') { return StrSlice(str, 1, str.length-1); }
+	return str;
+}
+
+// Reads the same format SerializeHistory writes. Each item starts with "# Succeeded GET https://..." but the
+// Succeeded/Failed word is optional so a hand written request file can just say "# GET https://...".
+// Status, Timings, FailureReason, Aborted, Download, ContentEncoding and Blob lines are allowed (so the history file works as-is) but ignored
+Result TryParseHeadlessRequests(Arena* arena, Str8 fileContents, VarArray* requestsOut)
+{
+	HeadlessRequest* request = nullptr;
+	bool foundNumHeaders = false;
+	uxx headerIndex = 0;
+	bool foundNumContent = false;
+	uxx contentIndex = 0;
+	bool expectingContentKey = false;
+	
+	TextParser parser = MakeTextParser(fileContents);
+	parser.noComments = true;
+	ParsingToken token = ZEROED;
+	while (TextParserGetToken(&parser, &token))
+	{
+		switch (token.type)
+		{
+			case ParsingTokenType_FilePrefix:
+			{
+				if (request != nullptr && (headerIndex < request->numHeaders || contentIndex < request->numContentItems)) { return Result_MissingItems; }
+				Str8 remaining = token.value;
+				Str8 parts[3] = ZEROED;
+				uxx numParts = 0;
+				while (remaining.length > 0 && numParts < ArrayCount(parts))
+				{
+					uxx spaceIndex = remaining.length;
+					for (uxx cIndex = 0; cIndex < remaining.length; cIndex++) { if (remaining.chars[cIndex] == ' ') { spaceIndex = cIndex; break; } }
+					if (numParts == ArrayCount(parts)-1) { spaceIndex = remaining.length; } //the url is everything that's left
+					parts[numParts] = StrSlice(remaining, 0, spaceIndex);
+					numParts++;
+					remaining = (spaceIndex < remaining.length) ? StrSliceFrom(remaining, spaceIndex+1) : Str8_Empty;
+				}
+				uxx verbPartIndex = (numParts == 3 && (StrAnyCaseEquals(parts[0], StrLit("Succeeded")) || StrAnyCaseEquals(parts[0], StrLit("Failed")))) ? 1 : 0;
+				if (numParts != verbPartIndex+2) { return Result_WrongNumCharacters; }
+				Str8 verbPart = parts[verbPartIndex];
+				Str8 urlPart = parts[verbPartIndex+1];
+				
+				HttpVerb verb = HttpVerb_None;
+				for (uxx vIndex = 0; vIndex < HttpVerb_Count; vIndex++)
+				{
+					Str8 verbStr = MakeStr8Nt(GetHttpVerbStr((HttpVerb)vIndex));
+					if (StrAnyCaseEquals(verbPart, verbStr)) { verb = (HttpVerb)vIndex; break; }
+				}
+				if (verb == HttpVerb_None) { return Result_UnknownString; }
+				
+				request = VarArrayAdd(HeadlessRequest, requestsOut);
+				NotNull(request);
+				ClearPointer(request);
+				request->verb = verb;
+				request->url = AllocStr8(arena, urlPart);
+				foundNumHeaders = false;
+				headerIndex = 0;
+				foundNumContent = false;
+				contentIndex = 0;
+			} break;
+			
+			case ParsingTokenType_KeyValuePair:
+			{
+				if (request == nullptr)
+				{
+					//NOTE: history.txt starts with the generation it was compacted as, which has nothing to do with the requests
+					if (StrAnyCaseEquals(token.key, StrLit(HISTORY_GENERATION_KEY))) { break; }
+					return Result_MissingFileHeader;
+				}
+				if (foundNumHeaders && headerIndex < request->numHeaders)
+				{
+					request->headers[headerIndex].key = AllocStr8(arena, token.key);
+					request->headers[headerIndex].value = AllocStr8(arena, token.value);
+					headerIndex++;
+				}
+				else if (foundNumContent && contentIndex < request->numContentItems)
+				{
+					if (!StrAnyCaseEquals(token.key, expectingContentKey ? StrLit("Key") : StrLit("Value"))) { return Result_InvalidType; }
+					Str8 valuePart = AllocStr8(arena, StripHeadlessQuotes(token.value));
+					if (expectingContentKey) { request->contentItems[contentIndex].key = valuePart; }
+					else { request->contentItems[contentIndex].value = valuePart; contentIndex++; }
+					expectingContentKey = !expectingContentKey;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("NumHeaders")))
+				{
+					if (foundNumHeaders) { return Result_Duplicate; }
+					Result parseError = Result_None;
+					if (!TryParseUXX(token.value, &request->numHeaders, &parseError)) { return parseError; }
+					if (request->numHeaders > 0)
+					{
+						request->headers = AllocArray(Str8Pair, arena, request->numHeaders);
+						NotNull(request->headers);
+					}
+					foundNumHeaders = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("NumContent")))
+				{
+					if (foundNumContent) { return Result_Duplicate; }
+					Result parseError = Result_None;
+					if (!TryParseUXX(token.value, &request->numContentItems, &parseError)) { return parseError; }
+					if (request->numContentItems > 0)
+					{
+						request->contentItems = AllocArray(Str8Pair, arena, request->numContentItems);
+						NotNull(request->contentItems);
+					}
+					foundNumContent = true;
+					expectingContentKey = true;
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Upload")))
+				{
+					if (request->uploadPath.chars != nullptr) { return Result_Duplicate; }
+					request->uploadPath = AllocStr8(arena, StripHeadlessQuotes(token.value));
+				}
+				else if (StrAnyCaseEquals(token.key, StrLit("Status")) || StrAnyCaseEquals(token.key, StrLit("Timings")) || StrAnyCaseEquals(token.key, StrLit("FailureReason")) ||
+					StrAnyCaseEquals(token.key, StrLit("Download")) || StrAnyCaseEquals(token.key, StrLit("DownloadSize")) || StrAnyCaseEquals(token.key, StrLit("DownloadHash")) ||
+					StrAnyCaseEquals(token.key, StrLit("ContentEncoding")) || StrAnyCaseEquals(token.key, StrLit("EncodedSize")) || StrAnyCaseEquals(token.key, StrLit("Aborted")) ||
+					StrAnyCaseEquals(token.key, StrLit("Blob")))
+				{
+					//results from a previous run, nothing to do with making the request
+				}
+				else
+				{
+					PrintLine_E("Unknown key in request file: \"%.*s\"", StrPrint(token.key));
+					return Result_InvalidType;
+				}
+			} break;
+			
+			default: return Result_InvalidSyntax;
+		}
+	}
+	if (request != nullptr && (headerIndex < request->numHeaders || contentIndex < request->numContentItems)) { return Result_MissingItems; }
+	return (requestsOut->length > 0) ? Result_Success : Result_EmptyFile;
+}
+
+void StartHeadlessRequests(HeadlessRun* run)
+{
+	HttpRequestOptions options = ZEROED;
+	options.discardResponseBytes = true; //we only report sizes, no reason to copy bodies across threads
+	for (uxx repeatIndex = 0; repeatIndex < run->numRepeats; repeatIndex++)
+	{
+		VarArrayLoop(&run->requests, rIndex)
+		{
+			VarArrayLoopGet(HeadlessRequest, request, &run->requests, rIndex);
+			HttpRequestArgs args = ZEROED;
+			args.verb = request->verb;
+			args.urlStr = request->url;
+			args.numHeaders = request->numHeaders;
+			args.headers = request->headers;
+			args.contentEncoding = MimeType_FormUrlEncoded;
+			args.numContentItems = request->numContentItems;
+			args.contentItems = request->contentItems;
+			args.contextId = (u64)rIndex;
+			options.uploadPath = request->uploadPath;
+			Plat_MakeHttpRequest(&args, &options);
+			run->numStarted++;
+		}
+	}
+}
+
+void RecordHeadlessResult(HeadlessRun* run, const HttpEvent* event)
+{
+	run->numFinished++;
+	run->totalBytes += event->totalBytes;
+	bool gotResponse = (event->state == HttpRequestState_Success);
+	if (!gotResponse) { run->numFailed++; }
+	else if (event->statusCode >= 400) { run->numHttpErrors++; }
+	else { run->numSucceeded++; }
+	
+	const HttpTimings* timings = &event->timings;
+	u64 totalUs = (timings->finishUs > timings->queuedUs) ? (timings->finishUs - timings->queuedUs) : 0;
+	if (gotResponse)
+	{
+		RecordLatency(&run->totalLatency, totalUs);
+		if (timings->firstByteUs > timings->queuedUs) { RecordLatency(&run->firstByteLatency, timings->firstByteUs - timings->queuedUs); }
+		u64 phaseDurationsUs[HttpPhase_Count];
+		GetHttpPhaseDurations(timings, &phaseDurationsUs[0]);
+		for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+		{
+			if (phaseDurationsUs[pIndex] == HTTP_PHASE_UNKNOWN) { continue; }
+			run->phaseSumsUs[pIndex] += phaseDurationsUs[pIndex];
+			run->phaseCounts[pIndex]++;
+		}
+	}
+	
+	if (!run->quiet)
+	{
+		const HeadlessRequest* request = VarArrayGet(HeadlessRequest, &run->requests, (uxx)event->contextId);
+		if (gotResponse)
+		{
+			printf("[%llu/%llu] %u %s %.*s %.2fms %lluB\n",
+				(u64)run->numFinished, (u64)run->numStarted, (unsigned int)event->statusCode,
+				GetHttpVerbStr(request->verb), StrPrint(request->url), (r64)totalUs / 1000.0, (u64)event->totalBytes
+			);
+		}
+		else
+		{
+			printf("[%llu/%llu] FAILED %s %.*s %.2fms (%s)\n",
+				(u64)run->numFinished, (u64)run->numStarted,
+				GetHttpVerbStr(request->verb), StrPrint(request->url), (r64)totalUs / 1000.0, GetResultStr(event->error)
+			);
+		}
+	}
+}
+
+void PrintHeadlessLatencyLine(const char* name, const LatencyHistogram* histogram)
+{
+	if (histogram->totalCount == 0) { printf("%s: -\n", name); return; }
+	printf("%s: min=%.2fms mean=%.2fms p50=%.2fms p90=%.2fms p99=%.2fms p99.9=%.2fms max=%.2fms\n", name,
+		(r64)histogram->minValue / 1000.0,
+		GetLatencyMean(histogram) / 1000.0,
+		(r64)GetLatencyPercentile(histogram, 50.0) / 1000.0,
+		(r64)GetLatencyPercentile(histogram, 90.0) / 1000.0,
+		(r64)GetLatencyPercentile(histogram, 99.0) / 1000.0,
+		(r64)GetLatencyPercentile(histogram, 99.9) / 1000.0,
+		(r64)histogram->maxValue / 1000.0
+	);
+}
+
+//NOTE: Everything goes to stdout with plain printf (not the debug output router) so scripts can always read it, even in release builds
+void PrintHeadlessSummary(const HeadlessRun* run)
+{
+	r64 elapsedSeconds = (r64)(run->endTimeUs - run->startTimeUs) / 1000000.0;
+	printf("requests: %llu succeeded=%llu httpErrors=%llu failed=%llu\n", (u64)run->numFinished, (u64)run->numSucceeded, (u64)run->numHttpErrors, (u64)run->numFailed);
+	printf("elapsed: %.3fs\n", elapsedSeconds);
+	if (elapsedSeconds > 0.0)
+	{
+		printf("throughput: %.1f req/s %.1f kB/s\n", (r64)run->numFinished / elapsedSeconds, ((r64)run->totalBytes / 1024.0) / elapsedSeconds);
+	}
+	printf("bytes: %llu\n", run->totalBytes);
+	PrintHeadlessLatencyLine("latency", &run->totalLatency);
+	PrintHeadlessLatencyLine("firstByte", &run->firstByteLatency);
+	printf("phases (mean):");
+	for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+	{
+		if (run->phaseCounts[pIndex] == 0) { printf(" %s=-", GetHttpPhaseStr((HttpPhase)pIndex)); }
+		else { printf(" %s=%.2fms", GetHttpPhaseStr((HttpPhase)pIndex), ((r64)run->phaseSumsUs[pIndex] / (r64)run->phaseCounts[pIndex]) / 1000.0); }
+	}
+	printf("\n");
+}
+
+// Called from sokol_main (after the program args and HTTP settings are parsed) when --headless is passed. Returns the process exit code
+//   --requests=path  a request file in the history format (defaults to the saved history)
+//   --repeat=N       run every request N times (default 1)
+//   --quiet          only print the summary
+int RunHeadless()
+{
+	InitScratchArenasVirtual(Gigabytes(4));
+	ScratchBegin(scratch);
+	
+	HeadlessRun run = ZEROED;
+	run.arena = stdHeap;
+	run.numRepeats = 1;
+	InitVarArray(HeadlessRequest, &run.requests, run.arena);
+	Str8 repeatStr = FindNamedProgramArgStr(&programArgs, StrLit("repeat"), Str8_Empty, Str8_Empty);
+	if (!IsEmptyStr(repeatStr) && (!TryParseUXX(repeatStr, &run.numRepeats, nullptr) || run.numRepeats == 0))
+	{
+		PrintLine_E("Invalid repeat \"%.*s\"", StrPrint(repeatStr));
+		ScratchEnd(scratch);
+		return 2;
+	}
+	Str8 quietStr = FindNamedProgramArgStr(&programArgs, StrLit("quiet"), StrLit("q"), StrLit("false"));
+	run.quiet = !StrAnyCaseEquals(quietStr, StrLit("false"));
+	
+	run.requestFilePath = FindNamedProgramArgStr(&programArgs, StrLit("requests"), StrLit("r"), Str8_Empty);
+	if (IsEmptyStr(run.requestFilePath))
+	{
+		FilePath saveFolderPath = OsGetSettingsSavePath(scratch, Str8_Empty, StrLit(PROJECT_FOLDER_NAME_STR), false);
+		NotNull(saveFolderPath.chars);
+		run.requestFilePath = JoinStringsInArena3(scratch, saveFolderPath, StrLit("/"), StrLit(HISTORY_FILENAME), false);
+	}
+	Str8 fileContents = Str8_Empty;
+	if (!OsReadTextFile(run.requestFilePath, scratch, &fileContents))
+	{
+		PrintLine_E("Failed to read request file \"%.*s\"", StrPrint(run.requestFilePath));
+		ScratchEnd(scratch);
+		return 2;
+	}
+	Result parseResult = TryParseHeadlessRequests(run.arena, fileContents, &run.requests);
+	if (parseResult != Result_Success)
+	{
+		PrintLine_E("Failed to parse request file \"%.*s\": %s", StrPrint(run.requestFilePath), GetResultStr(parseResult));
+		ScratchEnd(scratch);
+		return 2;
+	}
+	InitLatencyHistogram(run.arena, LATENCY_HISTOGRAM_DEFAULT_HIGHEST, &run.totalLatency);
+	InitLatencyHistogram(run.arena, LATENCY_HISTOGRAM_DEFAULT_HIGHEST, &run.firstByteLatency);
+	
+	InitHttpService(&platformData->httpService, platformData->httpMaxRunning, platformData->httpMaxRunningPerHost, platformData->httpPreferIoUring);
+	run.startTimeUs = SysGetTimeUs();
+	StartHeadlessRequests(&run);
+	while (run.numFinished < run.numStarted)
+	{
+		HttpEvent event = ZEROED;
+		if (!Plat_PopHttpEvent(&event)) { SysSleepMs(1); continue; }
+		if (event.type == HttpEventType_Finished) { RecordHeadlessResult(&run, &event); }
+		Plat_FreeHttpEvent(&event);
+	}
+	run.endTimeUs = SysGetTimeUs();
+	FreeHttpService(&platformData->httpService);
+	
+	PrintHeadlessSummary(&run);
+	fflush(stdout);
+	ScratchEnd(scratch);
+	return (run.numSucceeded == run.numFinished) ? 0 : 1;
+}
+
+#endif //BUILD_WITH_HTTP
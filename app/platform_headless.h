@@ -0,0 +1,49 @@
+/*
+File:   platform_headless.h
+Date:   10\16\2026
+*/
+
+#ifndef _PLATFORM_HEADLESS_H
+#define _PLATFORM_HEADLESS_H
+
+#if BUILD_WITH_HTTP
+
+// One request parsed out of a request file. All memory comes from the HeadlessRun's arena
+typedef plex HeadlessRequest HeadlessRequest;
+plex HeadlessRequest
+{
+	HttpVerb verb;
+	Str8 url;
+	uxx numHeaders;
+	Str8Pair* headers;
+	uxx numContentItems;
+	Str8Pair* contentItems;
+	Str8 uploadPath; //"Upload:" line, sent as the body in place of the contentItems
+};
+
+typedef plex HeadlessRun HeadlessRun;
+plex HeadlessRun
+{
+	Arena* arena;
+	Str8 requestFilePath;
+	VarArray requests; //HeadlessRequest
+	uxx numRepeats; //--repeat=N, every request is made this many times
+	bool quiet; //--quiet, only the summary gets printed
+	
+	uxx numStarted;
+	uxx numFinished;
+	uxx numSucceeded; //finished with a status below 400
+	uxx numHttpErrors; //finished with a 4xx or 5xx status
+	uxx numFailed; //never got a response at all
+	u64 totalBytes;
+	u64 startTimeUs;
+	u64 endTimeUs;
+	LatencyHistogram totalLatency; //queued until finished
+	LatencyHistogram firstByteLatency; //queued until the first response byte
+	u64 phaseSumsUs[HttpPhase_Count];
+	uxx phaseCounts[HttpPhase_Count];
+};
+
+#endif //BUILD_WITH_HTTP
+
+#endif //  _PLATFORM_HEADLESS_H
@@ -0,0 +1,753 @@
+/*
+File:   platform_http.c
+Date:   10\16\2026
+Description:
+	** Holds the HttpService which owns the HttpRequestManager and pumps it on
+	** a dedicated thread so request progress and callback delivery aren't tied to
+	** the frame loop. Response bytes are moved out of running requests as they arrive
+	** and, along with each request's final result, queued up as HttpEvents for the
+	** app to drain at the top of AppUpdate (see Plat_PopHttpEvent)
+	** Requests are queued per host and only handed to the HttpRequestManager while
+	** we are under both the global and the per-host concurrency caps
+	** On Linux the LinuxHttpManager (platform_http_linux.c) takes the HttpRequestManager's
+	** place. It pushes body bytes to us as it reads them so there's nothing to poll, and
+	** the service thread sleeps in epoll_wait rather than a fixed SysSleepMs
+	** Elsewhere the service thread only polls the HttpRequestManager while it has requests,
+	** when it's idle it sleeps on its SysWorker until Plat_MakeHttpRequest (or a cancel) signals it
+	** Requests with a downloadPath have their body written to disk right here on the
+	** service thread (see WriteHttpJobDownload) so it never crosses over to the app at all
+	** We ask for gzip/deflate bodies (HTTP_ACCEPT_ENCODING) and, when one comes back, every event
+	** for that request is routed through the HttpDecoder (platform_http_decode.c) so decompression
+	** happens on its own thread rather than this one or the app's
+	** PigCore's HttpRequestManager only hands the body over in its finish callback, so on the
+	** WinHTTP path a response arrives as one Data event right before its Finished event
+	** Cancels (Plat_CancelHttpRequest) and the per-request HttpTimeouts are both handled at
+	** the top of each service update, see AbortHttpJob
+*/
+
+#if BUILD_WITH_HTTP
+
+HTTP_CALLBACK_DEF(HttpServiceCallback);
+#if HTTP_USE_LINUX_BACKEND
+LINUX_HTTP_DATA_CALLBACK_DEF(HttpServiceDataCallback);
+#endif
+
+u64 GetHttpServiceTime(const HttpService* service)
+{
+	return (SysGetTimeUs() - service->startTimeUs) / 1000;
+}
+
+bool StrAnyCaseStartsWithLit(Str8 str, Str8 prefix)
+{
+	if (str.length < prefix.length) { return false; }
+	return StrAnyCaseEquals(StrSlice(str, 0, prefix.length), prefix);
+}
+
+// Splits something like "https://user@example.com:8443/api/v1?x=2#top" into host "example.com", port 8443 and path "/api/v1?x=2"
+bool TryParseHttpUrl(Str8 url, HttpUrlParts* partsOut)
+{
+	NotNull(partsOut);
+	ClearPointer(partsOut);
+	Str8 remaining = url;
+	if (StrAnyCaseStartsWithLit(remaining, StrLit("https://"))) { partsOut->isHttps = true; remaining = StrSliceFrom(remaining, 8); }
+	else if (StrAnyCaseStartsWithLit(remaining, StrLit("http://"))) { partsOut->isHttps = false; remaining = StrSliceFrom(remaining, 7); }
+	partsOut->port = partsOut->isHttps ? 443 : 80;
+	
+	uxx authorityEnd = remaining.length;
+	for (uxx cIndex = 0; cIndex < remaining.length; cIndex++)
+	{
+		char c = remaining.chars[cIndex];
+		if (c == '/' || c == '?' || c == '#') { authorityEnd = cIndex; break; }
+	}
+	Str8 authority = StrSlice(remaining, 0, authorityEnd);
+	Str8 path = StrSliceFrom(remaining, authorityEnd);
+	for (uxx cIndex = 0; cIndex < path.length; cIndex++)
+	{
+		if (path.chars[cIndex] == '#') { path = StrSlice(path, 0, cIndex); break; }
+	}
+	partsOut->path = path; //may be empty or start with '?' (like "http://host?x=1"), see HttpUrlParts
+	
+	for (uxx cIndex = authority.length; cIndex > 0; cIndex--)
+	{
+		if (authority.chars[cIndex-1] == '@') { authority = StrSliceFrom(authority, cIndex); break; }
+	}
+	
+	Str8 portStr = Str8_Empty;
+	if (authority.length > 0 && authority.chars[0] == '[') //IPv6 literal like [::1]:8080
+	{
+		uxx closeIndex = authority.length;
+		for (uxx cIndex = 1; cIndex < authority.length; cIndex++) { if (authority.chars[cIndex] == ']') { closeIndex = cIndex; break; } }
+		if (closeIndex >= authority.length) { return false; }
+		partsOut->host = StrSlice(authority, 1, closeIndex);
+		if (closeIndex+1 < authority.length && authority.chars[closeIndex+1] == ':') { portStr = StrSliceFrom(authority, closeIndex+2); }
+	}
+	else
+	{
+		partsOut->host = authority;
+		for (uxx cIndex = 0; cIndex < authority.length; cIndex++)
+		{
+			if (authority.chars[cIndex] == ':')
+			{
+				partsOut->host = StrSlice(authority, 0, cIndex);
+				portStr = StrSliceFrom(authority, cIndex+1);
+				break;
+			}
+		}
+	}
+	if (portStr.length > 0 && !TryParseU16(portStr, &partsOut->port, nullptr)) { return false; }
+	return (partsOut->host.length > 0);
+}
+
+// +--------------------------------------------------------------+
+// |                        Jobs and Hosts                        |
+// +--------------------------------------------------------------+
+//NOTE: All of these functions expect the service mutex to be held
+uxx FindOrAddHttpHost(HttpService* service, Str8 url)
+{
+	HttpUrlParts urlParts = ZEROED;
+	Str8 hostName = Str8_Empty;
+	if (TryParseHttpUrl(url, &urlParts)) { hostName = PrintInArenaStr(&service->heap, "%.*s:%u", StrPrint(urlParts.host), urlParts.port); }
+	else { hostName = AllocStr8(&service->heap, StrLit("")); }
+	
+	VarArrayLoop(&service->hosts, hIndex)
+	{
+		VarArrayLoopGet(HttpHost, host, &service->hosts, hIndex);
+		if (StrAnyCaseEquals(host->name, hostName)) { FreeStr8(&service->heap, &hostName); return hIndex; }
+	}
+	
+	HttpHost* newHost = VarArrayAdd(HttpHost, &service->hosts);
+	NotNull(newHost);
+	ClearPointer(newHost);
+	newHost->name = hostName;
+	InitVarArray(HttpJob*, &newHost->queue, &service->heap);
+	return service->hosts.length-1;
+}
+
+HttpJob* AllocHttpJob(HttpService* service, const HttpRequestArgs* args, const HttpRequestOptions* options)
+{
+	HttpJob* job = AllocType(HttpJob, &service->heap);
+	NotNull(job);
+	ClearPointer(job);
+	job->id = service->nextJobId;
+	service->nextJobId++;
+	job->appContextId = args->contextId;
+	job->timings.queuedUs = SysGetTimeUs();
+	if (options != nullptr) { MyMemCopy(&job->options, options, sizeof(HttpRequestOptions)); }
+	if (!IsEmptyStr(job->options.downloadPath)) { job->options.downloadPath = AllocStr8(&service->heap, job->options.downloadPath); }
+	if (!IsEmptyStr(job->options.uploadPath)) { job->options.uploadPath = AllocStr8(&service->heap, job->options.uploadPath); }
+	
+	MyMemCopy(&job->args, args, sizeof(HttpRequestArgs));
+	job->args.urlStr = AllocStr8(&service->heap, args->urlStr);
+	//NOTE: Compressed bodies are only worth asking for when we're going to hand the body to the app. Downloads are written
+	// to disk exactly as they come over the wire and discarded bodies are only counted, so those stay uncompressed
+	bool addAcceptEncoding = (!job->options.discardResponseBytes && IsEmptyStr(job->options.downloadPath));
+	for (uxx hIndex = 0; hIndex < args->numHeaders; hIndex++)
+	{
+		if (StrAnyCaseEquals(args->headers[hIndex].key, StrLit("Accept-Encoding"))) { addAcceptEncoding = false; break; }
+	}
+	job->args.numHeaders = args->numHeaders + (addAcceptEncoding ? 1 : 0);
+	if (job->args.numHeaders > 0)
+	{
+		job->args.headers = AllocArray(Str8Pair, &service->heap, job->args.numHeaders);
+		NotNull(job->args.headers);
+		for (uxx hIndex = 0; hIndex < args->numHeaders; hIndex++)
+		{
+			job->args.headers[hIndex].key = AllocStr8(&service->heap, args->headers[hIndex].key);
+			job->args.headers[hIndex].value = AllocStr8(&service->heap, args->headers[hIndex].value);
+		}
+		if (addAcceptEncoding)
+		{
+			job->args.headers[args->numHeaders].key = AllocStr8(&service->heap, StrLit("Accept-Encoding"));
+			job->args.headers[args->numHeaders].value = AllocStr8(&service->heap, StrLit(HTTP_ACCEPT_ENCODING));
+		}
+	}
+	if (args->numContentItems > 0)
+	{
+		job->args.contentItems = AllocArray(Str8Pair, &service->heap, args->numContentItems);
+		NotNull(job->args.contentItems);
+		for (uxx cIndex = 0; cIndex < args->numContentItems; cIndex++)
+		{
+			job->args.contentItems[cIndex].key = AllocStr8(&service->heap, args->contentItems[cIndex].key);
+			job->args.contentItems[cIndex].value = AllocStr8(&service->heap, args->contentItems[cIndex].value);
+		}
+	}
+	//NOTE: The HttpRequestManager sees the job id as the contextId so the callback can find the job again
+	job->args.contextId = job->id;
+	job->args.callback = HttpServiceCallback;
+	
+	job->hostIndex = FindOrAddHttpHost(service, args->urlStr);
+	return job;
+}
+
+void FreeHttpJob(HttpService* service, HttpJob* job)
+{
+	if (job->downloadFile.isOpen) { OsCloseFile(&job->downloadFile); }
+	if (job->options.downloadPath.chars != nullptr) { FreeStr8(&service->heap, &job->options.downloadPath); }
+	if (job->options.uploadPath.chars != nullptr) { FreeStr8(&service->heap, &job->options.uploadPath); }
+	FreeStr8(&service->heap, &job->args.urlStr);
+	for (uxx hIndex = 0; hIndex < job->args.numHeaders; hIndex++)
+	{
+		FreeStr8(&service->heap, &job->args.headers[hIndex].key);
+		FreeStr8(&service->heap, &job->args.headers[hIndex].value);
+	}
+	if (job->args.headers != nullptr) { FreeArray(Str8Pair, &service->heap, job->args.numHeaders, job->args.headers); }
+	for (uxx cIndex = 0; cIndex < job->args.numContentItems; cIndex++)
+	{
+		FreeStr8(&service->heap, &job->args.contentItems[cIndex].key);
+		FreeStr8(&service->heap, &job->args.contentItems[cIndex].value);
+	}
+	if (job->args.contentItems != nullptr) { FreeArray(Str8Pair, &service->heap, job->args.numContentItems, job->args.contentItems); }
+	FreeType(HttpJob, &service->heap, job);
+}
+
+void StartHttpJob(HttpService* service, HttpJob* job)
+{
+	Assert(job->state == HttpJobState_Queued);
+	job->timings.startUs = SysGetTimeUs();
+	if (!IsEmptyStr(job->options.downloadPath))
+	{
+		//NOTE: Opened here rather than on the first byte so an empty body still leaves an (empty) file behind
+		job->downloadHash = HTTP_CONTENT_HASH_START;
+		if (!OsOpenFile(&service->heap, job->options.downloadPath, OsOpenFileMode_Create, false, &job->downloadFile))
+		{
+			PrintLine_E("Failed to open \"%.*s\" to download into", StrPrint(job->options.downloadPath));
+			job->downloadError = Result_FailedToWriteFile;
+		}
+	}
+	#if HTTP_USE_LINUX_BACKEND
+	job->requestId = LinuxMakeHttpRequest(&service->manager, &job->args, job->options.uploadPath, &job->timings, (void*)job);
+	#else
+	bool cantUpload = !IsEmptyStr(job->options.uploadPath); //HttpRequestArgs has no way to hand WinHTTP a body that isn't contentItems
+	if (!cantUpload)
+	{
+		HttpRequest* request = OsMakeHttpRequest(&service->manager, &job->args, GetHttpServiceTime(service));
+		NotNull(request);
+		job->requestId = request->id;
+	}
+	#endif
+	job->state = HttpJobState_Running;
+	HttpJob** runningSpace = VarArrayAdd(HttpJob*, &service->runningJobs);
+	NotNull(runningSpace);
+	*runningSpace = job;
+	VarArrayGet(HttpHost, &service->hosts, job->hostIndex)->numRunning++;
+	#if !HTTP_USE_LINUX_BACKEND
+	if (cantUpload)
+	{
+		PrintLine_W("Can't upload \"%.*s\", bodies from files are only supported by the Linux backend", StrPrint(job->options.uploadPath));
+		HttpRequest failedRequest = ZEROED;
+		failedRequest.args.contextId = job->id;
+		failedRequest.state = HttpRequestState_Failure;
+		failedRequest.error = Result_NotImplemented;
+		HttpServiceCallback(&failedRequest);
+	}
+	#endif
+}
+
+// Walks the hosts round-robin, starting one job at a time from each host's queue, until we hit the global cap or nothing else can start
+//NOTE: A job whose notBeforeUs is still in the future blocks the rest of its host's queue. Scheduled
+// jobs are added in time order so that's what we want, it just means a normal request to the same host
+// can wait behind the (short) window that the load test schedules ahead
+void DispatchHttpJobs(HttpService* service)
+{
+	u64 nowUs = SysGetTimeUs();
+	while (service->numQueued > 0 && service->runningJobs.length < service->maxRunning)
+	{
+		bool startedAny = false;
+		for (uxx offset = 0; offset < service->hosts.length && service->runningJobs.length < service->maxRunning; offset++)
+		{
+			uxx hIndex = (service->nextHostIndex + offset) % service->hosts.length;
+			HttpHost* host = VarArrayGet(HttpHost, &service->hosts, hIndex);
+			if (host->queueReadIndex < host->queue.length && host->numRunning < service->maxRunningPerHost)
+			{
+				HttpJob* job = *VarArrayGet(HttpJob*, &host->queue, host->queueReadIndex);
+				if (job->options.notBeforeUs > nowUs) { continue; }
+				host->queueReadIndex++;
+				if (host->queueReadIndex >= host->queue.length) { VarArrayClear(&host->queue); host->queueReadIndex = 0; }
+				service->numQueued--;
+				StartHttpJob(service, job);
+				startedAny = true;
+			}
+		}
+		if (service->hosts.length > 0) { service->nextHostIndex = (service->nextHostIndex + 1) % service->hosts.length; }
+		if (!startedAny) { break; }
+	}
+}
+
+HttpEvent* AddHttpEvent(HttpService* service, HttpEventType type, const HttpJob* job, u64 timeUs)
+{
+	HttpEvent* event = job->isDecoding ? AddHttpDecodeItem(service, job->contentEncoding) : VarArrayAdd(HttpEvent, &service->events);
+	NotNull(event);
+	ClearPointer(event);
+	event->type = type;
+	event->contextId = job->appContextId;
+	event->httpId = job->id;
+	event->timeUs = timeUs;
+	event->totalBytes = job->numBytesReceived;
+	return event;
+}
+
+// Writes straight through to the job's file, so the memory used stays the same no matter how big the body is
+void WriteHttpJobDownload(HttpJob* job, Str8 bytes)
+{
+	job->downloadHash = UpdateHttpContentHash(job->downloadHash, bytes);
+	if (!job->downloadFile.isOpen) { return; }
+	if (!OsWriteToOpenFile(&job->downloadFile, bytes, false))
+	{
+		PrintLine_E("Failed to write %llu bytes to \"%.*s\" at offset %llu", bytes.length, StrPrint(job->options.downloadPath), job->numBytesReceived);
+		OsCloseFile(&job->downloadFile);
+		job->downloadError = Result_FailedToWriteFile;
+	}
+}
+
+void CheckHttpJobContentEncoding(HttpJob* job, uxx numResponseHeaders, const Str8Pair* responseHeaders)
+{
+	if (job->checkedContentEncoding) { return; }
+	job->checkedContentEncoding = true;
+	for (uxx hIndex = 0; hIndex < numResponseHeaders; hIndex++)
+	{
+		if (StrAnyCaseEquals(responseHeaders[hIndex].key, StrLit("Content-Encoding")))
+		{
+			job->contentEncoding = ParseHttpContentEncoding(responseHeaders[hIndex].value);
+			break;
+		}
+	}
+	if (job->contentEncoding == HttpContentEncoding_Brotli || job->contentEncoding == HttpContentEncoding_Other)
+	{
+		PrintLine_W("Request %llu came back with a Content-Encoding we can't decode, the body will be left as-is", job->id);
+	}
+	job->isDecoding = (CanDecodeHttpContentEncoding(job->contentEncoding) && !job->options.discardResponseBytes && IsEmptyStr(job->options.downloadPath));
+}
+
+void ReceiveHttpJobData(HttpService* service, HttpJob* job, uxx numResponseHeaders, const Str8Pair* responseHeaders, Str8 bytes, u64 timeUs)
+{
+	if (job->timings.firstByteUs == 0) { job->timings.firstByteUs = timeUs; }
+	job->lastDataUs = timeUs;
+	CheckHttpJobContentEncoding(job, numResponseHeaders, responseHeaders);
+	if (!IsEmptyStr(job->options.downloadPath))
+	{
+		WriteHttpJobDownload(job, bytes);
+		job->numBytesReceived += bytes.length;
+		if (!job->options.discardResponseBytes && timeUs >= job->lastProgressEventUs + HTTP_DOWNLOAD_PROGRESS_INTERVAL)
+		{
+			AddHttpEvent(service, HttpEventType_Data, job, timeUs);
+			job->lastProgressEventUs = timeUs;
+		}
+		return;
+	}
+	job->numBytesReceived += bytes.length;
+	if (!job->options.discardResponseBytes)
+	{
+		HttpEvent* event = AddHttpEvent(service, HttpEventType_Data, job, timeUs);
+		event->bytes = AllocStr8(&service->heap, bytes);
+	}
+}
+
+#if HTTP_USE_LINUX_BACKEND
+// void HttpServiceDataCallback(void* userPntr, uxx numResponseHeaders, const Str8Pair* responseHeaders, Str8 bytes)
+LINUX_HTTP_DATA_CALLBACK_DEF(HttpServiceDataCallback)
+{
+	HttpService* service = &platformData->httpService;
+	ReceiveHttpJobData(service, (HttpJob*)userPntr, numResponseHeaders, responseHeaders, bytes, SysGetTimeUs());
+}
+#endif //HTTP_USE_LINUX_BACKEND
+
+// Queues the job's Finished event. The job itself is left for the caller to free
+void FinishHttpJob(HttpService* service, HttpJob* job, HttpRequestState state, Result error, u16 statusCode, uxx numResponseHeaders, const Str8Pair* responseHeaders, u64 finishTimeUs)
+{
+	job->timings.finishUs = finishTimeUs;
+	HttpEvent* event = AddHttpEvent(service, HttpEventType_Finished, job, finishTimeUs);
+	event->state = state;
+	event->error = error;
+	event->statusCode = statusCode;
+	event->contentEncoding = job->contentEncoding;
+	event->encodedBytes = job->numBytesReceived; //the decode thread fills in the decoded totalBytes for decoded bodies
+	event->abortReason = job->abortReason;
+	if (job->abortReason != HttpAbortReason_None)
+	{
+		//NOTE: The response may have raced the abort to the finish line, but we already told the app (or the timeout) that it was over
+		event->state = HttpRequestState_Failure;
+		event->error = Result_Failure;
+	}
+	MyMemCopy(&event->timings, &job->timings, sizeof(HttpTimings));
+	if (!IsEmptyStr(job->options.downloadPath))
+	{
+		if (job->downloadFile.isOpen) { OsCloseFile(&job->downloadFile); }
+		event->downloadHash = job->downloadHash;
+		//NOTE: A response that made it all the way here but couldn't be written out still counts as a failure
+		if (job->downloadError != Result_None && (event->error == Result_None || event->error == Result_Success)) { event->error = job->downloadError; }
+	}
+	if (numResponseHeaders > 0)
+	{
+		event->numResponseHeaders = numResponseHeaders;
+		event->responseHeaders = AllocArray(Str8Pair, &service->heap, numResponseHeaders);
+		NotNull(event->responseHeaders);
+		for (uxx hIndex = 0; hIndex < numResponseHeaders; hIndex++)
+		{
+			event->responseHeaders[hIndex].key = AllocStr8(&service->heap, responseHeaders[hIndex].key);
+			event->responseHeaders[hIndex].value = AllocStr8(&service->heap, responseHeaders[hIndex].value);
+		}
+	}
+}
+
+// +==============================+
+// |     HttpServiceCallback      |
+// +==============================+
+//NOTE: This runs on the service thread inside OsUpdateHttpRequestManager (or UpdateLinuxHttpManager), so the mutex is already held
+// void HttpServiceCallback(plex HttpRequest* request)
+HTTP_CALLBACK_DEF(HttpServiceCallback)
+{
+	NotNull(request);
+	HttpService* service = &platformData->httpService;
+	u64 finishTimeUs = SysGetTimeUs();
+	
+	HttpJob* job = nullptr;
+	VarArrayLoop(&service->runningJobs, jIndex)
+	{
+		HttpJob* runningJob = *VarArrayGet(HttpJob*, &service->runningJobs, jIndex);
+		if (runningJob->id == request->args.contextId)
+		{
+			job = runningJob;
+			VarArrayRemoveAt(HttpJob*, &service->runningJobs, jIndex);
+			break;
+		}
+	}
+	if (job == nullptr) { PrintLine_W("HttpService got a callback for unknown job %llu", request->args.contextId); return; }
+	HttpHost* host = VarArrayGet(HttpHost, &service->hosts, job->hostIndex);
+	Assert(host->numRunning > 0);
+	host->numRunning--;
+	#if !HTTP_USE_LINUX_BACKEND
+	if (job->isAbandoned) { FreeHttpJob(service, job); return; }
+	#endif
+	
+	//NOTE: The LinuxHttpManager has already pushed the body to us through HttpServiceDataCallback, so only the HttpRequestManager
+	// leaves bytes here. They go out as a Data event (or download write) so the Finished event never carries bytes that might need decoding
+	if (request->responseBytes.length > 0)
+	{
+		Str8 tailBytes = MakeStr8(request->responseBytes.length, (char*)request->responseBytes.items);
+		ReceiveHttpJobData(service, job, request->numResponseHeaders, request->responseHeaders, tailBytes, finishTimeUs);
+	}
+	//NOTE: A job that never got any body bytes has nothing to decode, we only want its Content-Encoding for the event
+	if (!job->checkedContentEncoding) { CheckHttpJobContentEncoding(job, request->numResponseHeaders, request->responseHeaders); job->isDecoding = false; }
+	FinishHttpJob(service, job, request->state, request->error, request->statusCode, request->numResponseHeaders, request->responseHeaders, finishTimeUs);
+	FreeHttpJob(service, job);
+}
+
+// +--------------------------------------------------------------+
+// |                    Cancels and Timeouts                      |
+// +--------------------------------------------------------------+
+//NOTE: All of these run on the service thread with the mutex held
+// A queued job is finished and freed right here. A running one has its connection torn down by the backend and
+// finishes through HttpServiceCallback like any other (with abortReason filled in)
+void AbortHttpJob(HttpService* service, HttpJob* job, HttpAbortReason reason)
+{
+	if (job->abortReason != HttpAbortReason_None) { return; }
+	if (job->state == HttpJobState_Queued)
+	{
+		HttpHost* host = VarArrayGet(HttpHost, &service->hosts, job->hostIndex);
+		for (uxx qIndex = host->queueReadIndex; qIndex < host->queue.length; qIndex++)
+		{
+			if (*VarArrayGet(HttpJob*, &host->queue, qIndex) == job) { VarArrayRemoveAt(HttpJob*, &host->queue, qIndex); break; }
+		}
+		if (host->queueReadIndex >= host->queue.length) { VarArrayClear(&host->queue); host->queueReadIndex = 0; }
+		Assert(service->numQueued > 0);
+		service->numQueued--;
+		job->abortReason = reason;
+		FinishHttpJob(service, job, HttpRequestState_Failure, Result_Failure, 0, 0, nullptr, SysGetTimeUs());
+		FreeHttpJob(service, job);
+		return;
+	}
+	
+	#if HTTP_USE_LINUX_BACKEND
+	//NOTE: If this fails the request already finished and its callback is coming at the end of this update anyways
+	if (LinuxAbortHttpRequest(&service->manager, job->requestId, Result_Failure)) { job->abortReason = reason; }
+	#else
+	//NOTE: PigCore's HttpRequestManager can't abort a WinHTTP request once it's made. The app gets its Finished event now and
+	// everything after that is dropped, but the request (and its socket) live on until WinHTTP is done with it
+	job->abortReason = reason;
+	job->isAbandoned = true;
+	FinishHttpJob(service, job, HttpRequestState_Failure, Result_Failure, 0, 0, nullptr, SysGetTimeUs());
+	#endif
+}
+
+// Safe to call from any thread, with or without the mutex held
+void WakeHttpService(HttpService* service)
+{
+	#if HTTP_USE_LINUX_BACKEND
+	LinuxWakeHttpManager(&service->manager);
+	#else
+	SysWakeWorker(&service->worker);
+	#endif
+}
+
+HttpJob* FindHttpJob(HttpService* service, u64 jobId)
+{
+	VarArrayLoop(&service->runningJobs, jIndex)
+	{
+		HttpJob* job = *VarArrayGet(HttpJob*, &service->runningJobs, jIndex);
+		if (job->id == jobId) { return job; }
+	}
+	VarArrayLoop(&service->hosts, hIndex)
+	{
+		VarArrayLoopGet(HttpHost, host, &service->hosts, hIndex);
+		for (uxx qIndex = host->queueReadIndex; qIndex < host->queue.length; qIndex++)
+		{
+			HttpJob* job = *VarArrayGet(HttpJob*, &host->queue, qIndex);
+			if (job->id == jobId) { return job; }
+		}
+	}
+	return nullptr;
+}
+
+void ProcessHttpCancels(HttpService* service)
+{
+	VarArrayLoop(&service->cancelIds, cIndex)
+	{
+		u64 jobId = *VarArrayGet(u64, &service->cancelIds, cIndex);
+		HttpJob* job = FindHttpJob(service, jobId);
+		if (job != nullptr) { AbortHttpJob(service, job, HttpAbortReason_Canceled); }
+	}
+	VarArrayClear(&service->cancelIds);
+}
+
+void CheckHttpJobTimeouts(HttpService* service)
+{
+	u64 nowUs = SysGetTimeUs();
+	VarArrayLoop(&service->runningJobs, jIndex)
+	{
+		HttpJob* job = *VarArrayGet(HttpJob*, &service->runningJobs, jIndex);
+		const HttpTimeouts* timeouts = &job->options.timeouts;
+		if (job->abortReason != HttpAbortReason_None) { continue; }
+		u64 elapsedUs = nowUs - job->timings.startUs;
+		HttpAbortReason reason = HttpAbortReason_None;
+		if (timeouts->totalUs > 0 && elapsedUs >= timeouts->totalUs) { reason = HttpAbortReason_TotalTimeout; }
+		//NOTE: The HttpRequestManager doesn't tell us anything between starting a request and its callback, so the
+		// connect, first byte and idle timeouts have nothing to go on there. Only the total timeout applies
+		#if HTTP_USE_LINUX_BACKEND
+		else if (timeouts->connectUs > 0 && job->timings.tlsEndUs == 0 && job->timings.firstByteUs == 0 && elapsedUs >= timeouts->connectUs) { reason = HttpAbortReason_ConnectTimeout; }
+		else if (timeouts->firstByteUs > 0 && job->timings.firstByteUs == 0 && elapsedUs >= timeouts->firstByteUs) { reason = HttpAbortReason_FirstByteTimeout; }
+		else if (timeouts->idleUs > 0 && job->lastDataUs != 0 && nowUs - job->lastDataUs >= timeouts->idleUs) { reason = HttpAbortReason_IdleTimeout; }
+		#endif
+		if (reason != HttpAbortReason_None)
+		{
+			PrintLine_W("Request %llu to \"%.*s\" hit its %s after %llums", job->id, StrPrint(job->args.urlStr), GetHttpAbortReasonStr(reason), elapsedUs / 1000);
+			//NOTE: Running jobs stay in runningJobs until their callback, so this doesn't disturb the loop
+			AbortHttpJob(service, job, reason);
+		}
+	}
+}
+
+void FreeHttpEventInService(HttpService* service, HttpEvent* event)
+{
+	if (event->bytes.chars != nullptr) { FreeStr8(&service->heap, &event->bytes); }
+	for (uxx hIndex = 0; hIndex < event->numResponseHeaders; hIndex++)
+	{
+		FreeStr8(&service->heap, &event->responseHeaders[hIndex].key);
+		FreeStr8(&service->heap, &event->responseHeaders[hIndex].value);
+	}
+	if (event->responseHeaders != nullptr) { FreeArray(Str8Pair, &service->heap, event->numResponseHeaders, event->responseHeaders); }
+	ClearPointer(event);
+}
+
+// +==============================+
+// |    HttpServiceThreadMain     |
+// +==============================+
+// void HttpServiceThreadMain(void* contextPntr)
+SYS_THREAD_FUNC_DEF(HttpServiceThreadMain)
+{
+	HttpService* service = (HttpService*)contextPntr;
+	InitScratchArenasVirtual(Gigabytes(4));
+	#if TARGET_HAS_THREADING
+	OsSetThreadName(nullptr, StrLit("HttpService"));
+	#endif
+	
+	while (!SysIsWorkerStopping(&service->worker))
+	{
+		LockMutex(&service->mutex, TIMEOUT_FOREVER);
+		TracyCZoneN(Zone_Update, "HttpServiceUpdate", true);
+		ProcessHttpCancels(service);
+		CheckHttpJobTimeouts(service);
+		DispatchHttpJobs(service);
+		#if HTTP_USE_LINUX_BACKEND
+		UpdateLinuxHttpManager(&service->manager);
+		#else
+		OsUpdateHttpRequestManager(&service->manager, GetHttpServiceTime(service));
+		#endif
+		//NOTE: Callbacks during the update free up slots, so fill them right away rather than waiting a whole sleep
+		DispatchHttpJobs(service);
+		//NOTE: With nothing queued or running there are no timeouts to check and nothing for the backend to poll
+		bool isIdle = (service->runningJobs.length == 0 && service->numQueued == 0 && service->cancelIds.length == 0);
+		TracyCZoneEnd(Zone_Update);
+		UnlockMutex(&service->mutex);
+		
+		#if HTTP_USE_LINUX_BACKEND
+		//NOTE: Wakes early for socket activity, finished DNS lookups, or Plat_MakeHttpRequest queueing something.
+		// Idle keep-alive connections still need closing once they expire, so even an idle wait isn't forever
+		WaitLinuxHttpManager(&service->manager, isIdle ? HTTP_SERVICE_IDLE_WAIT_TIME : HTTP_SERVICE_SLEEP_TIME);
+		#else
+		SysWorkerWait(&service->worker, isIdle ? SYS_WAIT_FOREVER : HTTP_SERVICE_SLEEP_TIME);
+		#endif
+	}
+}
+
+// NOTE: WinHTTP already keeps idle keep-alive connections pooled per host inside the
+// HttpRequestManager's session (and the LinuxHttpManager pools them the same way), so capping
+// how many requests run against one host at a time is what lets a batch reuse those warm connections
+void InitHttpService(HttpService* service, uxx maxRunning, uxx maxRunningPerHost, bool preferIoUring)
+{
+	NotNull(service);
+	Assert(maxRunning > 0 && maxRunningPerHost > 0);
+	ClearPointer(service);
+	service->startTimeUs = SysGetTimeUs();
+	service->maxRunning = maxRunning;
+	service->maxRunningPerHost = maxRunningPerHost;
+	InitMutex(&service->mutex);
+	InitArenaStdHeap(&service->heap);
+	#if HTTP_USE_LINUX_BACKEND
+	InitLinuxHttpManager(&service->heap, &service->manager, HttpServiceDataCallback, preferIoUring);
+	#else
+	UNUSED(preferIoUring);
+	OsInitHttpRequestManager(&service->heap, &service->manager);
+	#endif
+	service->nextJobId = 1;
+	InitVarArray(HttpJob*, &service->runningJobs, &service->heap);
+	InitVarArray(HttpHost, &service->hosts, &service->heap);
+	InitVarArray(HttpEvent, &service->events, &service->heap);
+	InitVarArray(u64, &service->cancelIds, &service->heap);
+	service->initialized = true;
+	
+	InitHttpDecoder(service);
+	bool startedThread = SysStartWorker(&service->worker, HttpServiceThreadMain, (void*)service);
+	Assert(startedThread);
+}
+
+void FreeHttpService(HttpService* service)
+{
+	NotNull(service);
+	if (!service->initialized) { return; }
+	
+	SysRequestWorkerStop(&service->worker);
+	WakeHttpService(service);
+	SysStopWorker(&service->worker);
+	FreeHttpDecoder(service);
+	
+	#if HTTP_USE_LINUX_BACKEND
+	FreeLinuxHttpManager(&service->manager);
+	#else
+	OsFreeHttpRequestManager(&service->manager);
+	#endif
+	VarArrayLoop(&service->runningJobs, jIndex)
+	{
+		FreeHttpJob(service, *VarArrayGet(HttpJob*, &service->runningJobs, jIndex));
+	}
+	FreeVarArray(&service->runningJobs);
+	VarArrayLoop(&service->hosts, hIndex)
+	{
+		VarArrayLoopGet(HttpHost, host, &service->hosts, hIndex);
+		for (uxx qIndex = host->queueReadIndex; qIndex < host->queue.length; qIndex++)
+		{
+			FreeHttpJob(service, *VarArrayGet(HttpJob*, &host->queue, qIndex));
+		}
+		FreeVarArray(&host->queue);
+		FreeStr8(&service->heap, &host->name);
+	}
+	FreeVarArray(&service->hosts);
+	for (uxx eIndex = service->eventsReadIndex; eIndex < service->events.length; eIndex++)
+	{
+		HttpEvent* event = VarArrayGet(HttpEvent, &service->events, eIndex);
+		FreeHttpEventInService(service, event);
+	}
+	FreeVarArray(&service->events);
+	FreeVarArray(&service->cancelIds);
+	DestroyMutex(&service->mutex);
+	ClearPointer(service);
+}
+
+// +--------------------------------------------------------------+
+// |                    Platform API Functions                    |
+// +--------------------------------------------------------------+
+// +==============================+
+// |     Plat_MakeHttpRequest     |
+// +==============================+
+// u64 Plat_MakeHttpRequest(const HttpRequestArgs* args, const HttpRequestOptions* options)
+MAKE_HTTP_REQUEST_DEF(Plat_MakeHttpRequest)
+{
+	NotNull(args);
+	HttpService* service = &platformData->httpService;
+	
+	LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	HttpJob* job = AllocHttpJob(service, args, options);
+	job->state = HttpJobState_Queued;
+	HttpHost* host = VarArrayGet(HttpHost, &service->hosts, job->hostIndex);
+	HttpJob** queueSpace = VarArrayAdd(HttpJob*, &host->queue);
+	NotNull(queueSpace);
+	*queueSpace = job;
+	service->numQueued++;
+	u64 result = job->id;
+	UnlockMutex(&service->mutex);
+	WakeHttpService(service);
+	
+	return result;
+}
+
+// +==============================+
+// |    Plat_CancelHttpRequest    |
+// +==============================+
+//NOTE: The actual teardown happens on the service thread (the backend's sockets are only ever touched there), this just queues it up
+// void Plat_CancelHttpRequest(u64 httpId)
+CANCEL_HTTP_REQUEST_DEF(Plat_CancelHttpRequest)
+{
+	HttpService* service = &platformData->httpService;
+	LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	u64* idSpace = VarArrayAdd(u64, &service->cancelIds);
+	NotNull(idSpace);
+	*idSpace = httpId;
+	UnlockMutex(&service->mutex);
+	WakeHttpService(service);
+}
+
+// +==============================+
+// |       Plat_PopHttpEvent      |
+// +==============================+
+// bool Plat_PopHttpEvent(HttpEvent* eventOut)
+POP_HTTP_EVENT_DEF(Plat_PopHttpEvent)
+{
+	NotNull(eventOut);
+	HttpService* service = &platformData->httpService;
+	bool result = false;
+	LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	if (service->eventsReadIndex < service->events.length)
+	{
+		HttpEvent* nextEvent = VarArrayGet(HttpEvent, &service->events, service->eventsReadIndex);
+		MyMemCopy(eventOut, nextEvent, sizeof(HttpEvent));
+		service->eventsReadIndex++;
+		if (service->decoder.isWaitingForRoom)
+		{
+			service->decoder.isWaitingForRoom = false;
+			SysWakeWorker(&service->decoder.worker);
+		}
+		//NOTE: Rather than shifting the array down on every pop we wait till it's fully drained and clear it
+		if (service->eventsReadIndex >= service->events.length)
+		{
+			VarArrayClear(&service->events);
+			service->eventsReadIndex = 0;
+		}
+		result = true;
+	}
+	UnlockMutex(&service->mutex);
+	return result;
+}
+
+// +==============================+
+// |      Plat_FreeHttpEvent      |
+// +==============================+
+// void Plat_FreeHttpEvent(HttpEvent* event)
+FREE_HTTP_EVENT_DEF(Plat_FreeHttpEvent)
+{
+	NotNull(event);
+	HttpService* service = &platformData->httpService;
+	LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	FreeHttpEventInService(service, event);
+	UnlockMutex(&service->mutex);
+}
+
+#endif //BUILD_WITH_HTTP
@@ -0,0 +1,113 @@
+/*
+File:   platform_http.h
+Date:   10\16\2026
+*/
+
+#ifndef _PLATFORM_HTTP_H
+#define _PLATFORM_HTTP_H
+
+#if BUILD_WITH_HTTP
+
+typedef plex HttpUrlParts HttpUrlParts;
+plex HttpUrlParts
+{
+	bool isHttps;
+	Str8 host;
+	u16 port;
+	Str8 path; //includes the query string. Can be empty or start with '?', whoever sends it has to put a '/' in front of those
+};
+
+typedef enum HttpJobState HttpJobState;
+enum HttpJobState
+{
+	HttpJobState_None = 0,
+	HttpJobState_Queued,
+	HttpJobState_Running,
+	HttpJobState_Count,
+};
+const char* GetHttpJobStateStr(HttpJobState enumValue)
+{
+	switch (enumValue)
+	{
+		case HttpJobState_None:    return "None";
+		case HttpJobState_Queued:  return "Queued";
+		case HttpJobState_Running: return "Running";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Every request the app makes becomes an HttpJob. Jobs wait in their host's queue
+// until both the global and per-host caps allow them to be handed to the HttpRequestManager
+typedef plex HttpJob HttpJob;
+plex HttpJob
+{
+	u64 id; //this is the httpId that the app sees
+	HttpJobState state;
+	u64 appContextId;
+	HttpRequestArgs args; //deep copy, all strings are allocated from the service heap
+	HttpRequestOptions options;
+	uxx hostIndex;
+	u64 requestId; //id of the HttpRequest in the HttpRequestManager once Running
+	HttpTimings timings;
+	uxx numBytesReceived;
+	
+	//NOTE: Only used when options.downloadPath is set (options.downloadPath and options.uploadPath are our own copies when set)
+	OsFile downloadFile; //opened when the job starts, closed when it finishes
+	u64 downloadHash;
+	Result downloadError; //the first open/write failure, we stop writing after that but let the request run out
+	u64 lastProgressEventUs;
+	
+	//NOTE: Filled in from the response headers when the first body bytes show up. Once isDecoding is set every
+	// event for this job goes through the decoder's queue rather than straight to service->events
+	bool checkedContentEncoding;
+	HttpContentEncoding contentEncoding;
+	bool isDecoding;
+	
+	u64 lastDataUs; //for options.timeouts.idleUs
+	HttpAbortReason abortReason; //set once we've started tearing the job down ourselves
+	#if !HTTP_USE_LINUX_BACKEND
+	bool isAbandoned; //its Finished event already went out, we're only waiting on WinHTTP's callback to free it (see AbortHttpJob)
+	#endif
+};
+
+typedef plex HttpHost HttpHost;
+plex HttpHost
+{
+	Str8 name; //"host:port"
+	uxx numRunning;
+	VarArray queue; //HttpJob*
+	uxx queueReadIndex;
+};
+
+typedef plex HttpService HttpService;
+plex HttpService
+{
+	bool initialized;
+	u64 startTimeUs;
+	uxx maxRunning;
+	uxx maxRunningPerHost;
+	
+	//NOTE: Everything below is only touched while holding the mutex
+	Mutex mutex;
+	Arena heap; //all HttpJob and HttpEvent memory comes from here
+	#if HTTP_USE_LINUX_BACKEND
+	LinuxHttpManager manager;
+	#else
+	HttpRequestManager manager;
+	#endif
+	u64 nextJobId;
+	uxx numQueued;
+	VarArray runningJobs; //HttpJob*
+	VarArray hosts; //HttpHost
+	uxx nextHostIndex; //round-robin start point when dispatching
+	VarArray events; //HttpEvent
+	uxx eventsReadIndex;
+	VarArray cancelIds; //u64, job ids from Plat_CancelHttpRequest waiting for the service thread
+	HttpDecoder decoder; //has its own thread, see platform_http_decode.c
+	
+	SysWorker worker; //see WakeHttpService, on Linux the thread sleeps on the LinuxHttpManager's wakeFd instead of worker.wakeEvent
+};
+
+#endif //BUILD_WITH_HTTP
+
+#endif //  _PLATFORM_HTTP_H
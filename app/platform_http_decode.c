@@ -0,0 +1,705 @@
+/*
+File:   platform_http_decode.c
+Date:   10\16\2026
+Description:
+	** Holds a small streaming inflater (gzip, zlib and raw deflate) and the HttpDecoder,
+	** a thread that sits between the HttpService and the app for responses that came
+	** back with "Content-Encoding: gzip" or "deflate". The service thread hands it the
+	** encoded Data events (and the Finished event, so ordering is kept) instead of
+	** queueing them for the app, and the decode thread turns them into ordinary Data
+	** events full of decoded bytes. Decoding a huge body never holds up the sockets on
+	** the service thread or AppUpdate. Output goes out a buffer (HTTP_DECODE_OUTPUT_SIZE) at a time and
+	** the decode thread pauses mid-stream whenever the app has HTTP_DECODE_MAX_QUEUED_EVENTS events
+	** waiting, so a small body that inflates to gigabytes can't pile up faster than the app takes it.
+	** The encoded input waiting in the decoder's queue isn't capped, it only grows as fast as the network delivers it
+	** The inflater is resumable at any byte boundary: everything it needs between calls
+	** lives in the InflateStream, and it never starts decoding a symbol it can't finish
+*/
+
+// +--------------------------------------------------------------+
+// |                          Checksums                           |
+// +--------------------------------------------------------------+
+u32 InflateCrc32Table[256];
+bool InflateCrc32TableBuilt = false;
+
+void BuildInflateCrc32Table()
+{
+	for (u32 bIndex = 0; bIndex < 256; bIndex++)
+	{
+		u32 value = bIndex;
+		for (u32 bitIndex = 0; bitIndex < 8; bitIndex++) { value = (value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1); }
+		InflateCrc32Table[bIndex] = value;
+	}
+	InflateCrc32TableBuilt = true;
+}
+
+u32 UpdateInflateCrc32(u32 crc, const u8* bytes, uxx numBytes)
+{
+	crc = ~crc;
+	for (uxx bIndex = 0; bIndex < numBytes; bIndex++) { crc = InflateCrc32Table[(crc ^ bytes[bIndex]) & 0xFF] ^ (crc >> 8); }
+	return ~crc;
+}
+
+u32 UpdateInflateAdler32(u32 adler, const u8* bytes, uxx numBytes)
+{
+	u32 a = (adler & 0xFFFF);
+	u32 b = (adler >> 16);
+	while (numBytes > 0)
+	{
+		//NOTE: 5552 is the most bytes we can sum before b could overflow 32 bits, so we only need to do the (slow) modulo that often
+		uxx blockSize = (numBytes < 5552) ? numBytes : 5552;
+		for (uxx bIndex = 0; bIndex < blockSize; bIndex++) { a += bytes[bIndex]; b += a; }
+		a %= 65521;
+		b %= 65521;
+		bytes += blockSize;
+		numBytes -= blockSize;
+	}
+	return (b << 16) | a;
+}
+
+// +--------------------------------------------------------------+
+// |                           Inflate                            |
+// +--------------------------------------------------------------+
+const u16 InflateLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+const u8 InflateLengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+const u16 InflateDistBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+const u8 InflateDistExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+const u8 InflateCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+#define INFLATE_NEED_MORE_BITS -1
+#define INFLATE_INVALID_CODE   -2
+
+void InitInflateStream(InflateStream* stream, InflateFormat format)
+{
+	NotNull(stream);
+	ClearPointer(stream);
+	if (!InflateCrc32TableBuilt) { BuildInflateCrc32Table(); }
+	stream->format = format;
+	switch (format)
+	{
+		case InflateFormat_Zlib:      stream->state = InflateState_ZlibHeader; break;
+		case InflateFormat_ZlibOrRaw: stream->state = InflateState_ZlibOrRawHeader; break;
+		case InflateFormat_Gzip:      stream->state = InflateState_GzipHeader; break;
+		default:                      stream->state = InflateState_BlockHeader; break;
+	}
+	stream->checksum = (format == InflateFormat_Gzip) ? 0 : 1;
+}
+
+// Returns false if the lengths don't describe a valid (possibly incomplete) prefix code
+bool BuildInflateHuffman(InflateHuffman* huffman, const u8* lengths, u32 numSymbols)
+{
+	MyMemSet(huffman, 0x00, sizeof(InflateHuffman));
+	for (u32 sIndex = 0; sIndex < numSymbols; sIndex++) { huffman->counts[lengths[sIndex]]++; }
+	huffman->counts[0] = 0;
+	i32 numLeft = 1;
+	for (u32 length = 1; length <= INFLATE_MAX_CODE_LENGTH; length++)
+	{
+		numLeft <<= 1;
+		numLeft -= huffman->counts[length];
+		if (numLeft < 0) { return false; } //over-subscribed
+	}
+	
+	u16 offsets[INFLATE_MAX_CODE_LENGTH+1];
+	u32 nextCodes[INFLATE_MAX_CODE_LENGTH+1];
+	offsets[1] = 0;
+	for (u32 length = 1; length < INFLATE_MAX_CODE_LENGTH; length++) { offsets[length+1] = offsets[length] + huffman->counts[length]; }
+	u32 code = 0;
+	nextCodes[0] = 0;
+	for (u32 length = 1; length <= INFLATE_MAX_CODE_LENGTH; length++)
+	{
+		code = (code + huffman->counts[length-1]) << 1;
+		nextCodes[length] = code;
+	}
+	for (u32 sIndex = 0; sIndex < numSymbols; sIndex++)
+	{
+		u32 length = lengths[sIndex];
+		if (length == 0) { continue; }
+		huffman->symbols[offsets[length]++] = (u16)sIndex;
+		u32 symbolCode = nextCodes[length]++;
+		if (length <= INFLATE_FAST_BITS)
+		{
+			//NOTE: Codes are packed MSB first but we read LSB first, so the table is indexed by the reversed code
+			u32 reversed = 0;
+			for (u32 bitIndex = 0; bitIndex < length; bitIndex++) { reversed |= ((symbolCode >> bitIndex) & 1) << (length-1 - bitIndex); }
+			for (u32 fIndex = reversed; fIndex < (1 << INFLATE_FAST_BITS); fIndex += (1 << length))
+			{
+				huffman->fast[fIndex] = (u16)((sIndex << 4) | length);
+			}
+		}
+	}
+	return true;
+}
+
+void RefillInflateBits(InflateStream* stream, Str8* input)
+{
+	while (stream->numBits <= 56 && input->length > 0)
+	{
+		stream->bitBuffer |= (u64)(u8)input->chars[0] << stream->numBits;
+		stream->numBits += 8;
+		input->chars++;
+		input->length--;
+	}
+}
+
+u32 TakeInflateBits(InflateStream* stream, u32 numBits)
+{
+	DebugAssert(numBits <= stream->numBits);
+	u32 result = (numBits > 0) ? (u32)(stream->bitBuffer & ((1ULL << numBits) - 1)) : 0;
+	stream->bitBuffer >>= numBits;
+	stream->numBits -= numBits;
+	return result;
+}
+
+void AlignInflateBits(InflateStream* stream)
+{
+	TakeInflateBits(stream, stream->numBits % 8);
+}
+
+// Returns the symbol or INFLATE_NEED_MORE_BITS/INFLATE_INVALID_CODE
+i32 DecodeInflateSymbol(InflateStream* stream, const InflateHuffman* huffman)
+{
+	u16 fastEntry = huffman->fast[stream->bitBuffer & ((1 << INFLATE_FAST_BITS) - 1)];
+	if (fastEntry != 0)
+	{
+		u32 length = (fastEntry & 0x0F);
+		if (length > stream->numBits) { return INFLATE_NEED_MORE_BITS; }
+		TakeInflateBits(stream, length);
+		return (i32)(fastEntry >> 4);
+	}
+	
+	//NOTE: Walk the canonical code one bit at a time (puff.c's decode)
+	u32 code = 0;
+	u32 first = 0;
+	u32 index = 0;
+	for (u32 length = 1; length <= INFLATE_MAX_CODE_LENGTH; length++)
+	{
+		if (length > stream->numBits) { return INFLATE_NEED_MORE_BITS; }
+		code |= (u32)((stream->bitBuffer >> (length-1)) & 1);
+		u32 count = huffman->counts[length];
+		if (code < first + count)
+		{
+			TakeInflateBits(stream, length);
+			return (i32)huffman->symbols[index + (code - first)];
+		}
+		index += count;
+		first += count;
+		first <<= 1;
+		code <<= 1;
+	}
+	return INFLATE_INVALID_CODE;
+}
+
+InflateResult FailInflateStream(InflateStream* stream, const char* errorStr)
+{
+	stream->state = InflateState_Error;
+	stream->errorStr = errorStr;
+	return InflateResult_Error;
+}
+
+void BuildInflateFixedTables(InflateStream* stream)
+{
+	u8 lengths[INFLATE_MAX_LITLEN_CODES];
+	for (u32 sIndex = 0; sIndex < 144; sIndex++) { lengths[sIndex] = 8; }
+	for (u32 sIndex = 144; sIndex < 256; sIndex++) { lengths[sIndex] = 9; }
+	for (u32 sIndex = 256; sIndex < 280; sIndex++) { lengths[sIndex] = 7; }
+	for (u32 sIndex = 280; sIndex < INFLATE_MAX_LITLEN_CODES; sIndex++) { lengths[sIndex] = 8; }
+	BuildInflateHuffman(&stream->litLenHuffman, &lengths[0], INFLATE_MAX_LITLEN_CODES);
+	for (u32 sIndex = 0; sIndex < 30; sIndex++) { lengths[sIndex] = 5; }
+	BuildInflateHuffman(&stream->distHuffman, &lengths[0], 30);
+}
+
+// Consumes as much of input as it can (input is advanced past whatever was used) and writes up to outputSize bytes.
+// Pass isLastInput once the caller knows no more bytes are coming, that's what lets the last few symbols (and a truncated stream) be resolved
+InflateResult InflateStreamDecode(InflateStream* stream, Str8* input, bool isLastInput, u8* output, uxx outputSize, uxx* numOutputOut)
+{
+	NotNull(stream);
+	NotNull(input);
+	NotNull(numOutputOut);
+	uxx outIndex = 0;
+	uxx checksumIndex = 0; //output before this has already been added to stream->checksum
+	InflateResult result = InflateResult_NeedInput;
+	
+	//NOTE: Every state either finishes its step or breaks out with result set. Each step first makes sure the bits it needs are buffered
+	#define INFLATE_NEED_BITS(count) do { RefillInflateBits(stream, input); if (stream->numBits < (count)) { if (isLastInput) { result = FailInflateStream(stream, "Truncated"); } else { result = InflateResult_NeedInput; } goto endOfDecode; } } while(0)
+	
+	while (true)
+	{
+		switch (stream->state)
+		{
+			case InflateState_ZlibHeader:
+			case InflateState_ZlibOrRawHeader:
+			{
+				INFLATE_NEED_BITS(16);
+				u32 cmf = (u32)(stream->bitBuffer & 0xFF);
+				u32 flg = (u32)((stream->bitBuffer >> 8) & 0xFF);
+				bool isValidZlib = ((cmf & 0x0F) == 8 && (cmf >> 4) <= 7 && ((cmf << 8) | flg) % 31 == 0 && (flg & 0x20) == 0);
+				if (isValidZlib)
+				{
+					TakeInflateBits(stream, 16);
+					stream->format = InflateFormat_Zlib;
+				}
+				else if (stream->state == InflateState_ZlibHeader) { result = FailInflateStream(stream, "Invalid zlib header"); goto endOfDecode; }
+				else { stream->format = InflateFormat_Raw; }
+				stream->state = InflateState_BlockHeader;
+			} break;
+			
+			case InflateState_GzipHeader:
+			{
+				INFLATE_NEED_BITS(32);
+				u32 id1 = TakeInflateBits(stream, 8);
+				u32 id2 = TakeInflateBits(stream, 8);
+				u32 method = TakeInflateBits(stream, 8);
+				stream->gzipFlags = (u8)TakeInflateBits(stream, 8);
+				if (id1 != 0x1F || id2 != 0x8B || method != 8) { result = FailInflateStream(stream, "Invalid gzip header"); goto endOfDecode; }
+				stream->state = InflateState_GzipHeaderRest;
+			} break;
+			case InflateState_GzipHeaderRest:
+			{
+				INFLATE_NEED_BITS(48); //MTIME, XFL and OS, none of which we care about
+				TakeInflateBits(stream, 32);
+				TakeInflateBits(stream, 16);
+				stream->state = InflateState_GzipExtraLength;
+			} break;
+			case InflateState_GzipExtraLength:
+			{
+				if (IsFlagSet(stream->gzipFlags, 0x04))
+				{
+					INFLATE_NEED_BITS(16);
+					stream->gzipExtraRemaining = TakeInflateBits(stream, 16);
+				}
+				stream->state = InflateState_GzipExtra;
+			} break;
+			case InflateState_GzipExtra:
+			{
+				while (stream->gzipExtraRemaining > 0) { INFLATE_NEED_BITS(8); TakeInflateBits(stream, 8); stream->gzipExtraRemaining--; }
+				stream->state = InflateState_GzipName;
+			} break;
+			case InflateState_GzipName:
+			case InflateState_GzipComment:
+			{
+				u8 flag = (stream->state == InflateState_GzipName) ? 0x08 : 0x10;
+				if (IsFlagSet(stream->gzipFlags, flag))
+				{
+					while (true) { INFLATE_NEED_BITS(8); if (TakeInflateBits(stream, 8) == 0) { break; } }
+				}
+				stream->state = (stream->state == InflateState_GzipName) ? InflateState_GzipComment : InflateState_GzipHeaderCrc;
+			} break;
+			case InflateState_GzipHeaderCrc:
+			{
+				if (IsFlagSet(stream->gzipFlags, 0x02)) { INFLATE_NEED_BITS(16); TakeInflateBits(stream, 16); }
+				stream->state = InflateState_BlockHeader;
+			} break;
+			
+			case InflateState_BlockHeader:
+			{
+				INFLATE_NEED_BITS(3);
+				stream->isFinalBlock = (TakeInflateBits(stream, 1) != 0);
+				u32 blockType = TakeInflateBits(stream, 2);
+				if (blockType == 0) { AlignInflateBits(stream); stream->state = InflateState_StoredLength; }
+				else if (blockType == 1) { BuildInflateFixedTables(stream); stream->state = InflateState_Codes; }
+				else if (blockType == 2) { stream->state = InflateState_DynamicHeader; }
+				else { result = FailInflateStream(stream, "Invalid block type"); goto endOfDecode; }
+			} break;
+			
+			case InflateState_StoredLength:
+			{
+				INFLATE_NEED_BITS(32);
+				u32 length = TakeInflateBits(stream, 16);
+				u32 lengthComplement = TakeInflateBits(stream, 16);
+				if (length != (~lengthComplement & 0xFFFF)) { result = FailInflateStream(stream, "Stored block length mismatch"); goto endOfDecode; }
+				stream->storedRemaining = length;
+				stream->state = InflateState_StoredCopy;
+			} break;
+			case InflateState_StoredCopy:
+			{
+				while (stream->storedRemaining > 0)
+				{
+					if (outIndex >= outputSize) { result = InflateResult_OutputFull; goto endOfDecode; }
+					u8 nextByte = 0;
+					//NOTE: We're byte aligned here, so whole bytes left in the bit buffer come first, then straight from the input
+					if (stream->numBits >= 8) { nextByte = (u8)TakeInflateBits(stream, 8); }
+					else if (input->length > 0) { nextByte = (u8)input->chars[0]; input->chars++; input->length--; }
+					else if (isLastInput) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					else { result = InflateResult_NeedInput; goto endOfDecode; }
+					stream->window[stream->windowPos & INFLATE_WINDOW_MASK] = nextByte;
+					stream->windowPos++;
+					output[outIndex] = nextByte;
+					outIndex++;
+					stream->storedRemaining--;
+				}
+				stream->state = stream->isFinalBlock ? InflateState_Trailer : InflateState_BlockHeader;
+			} break;
+			
+			case InflateState_DynamicHeader:
+			{
+				INFLATE_NEED_BITS(14);
+				stream->numLitLenCodes = TakeInflateBits(stream, 5) + 257;
+				stream->numDistCodes = TakeInflateBits(stream, 5) + 1;
+				stream->numCodeLengthCodes = TakeInflateBits(stream, 4) + 4;
+				if (stream->numLitLenCodes > 286 || stream->numDistCodes > 30) { result = FailInflateStream(stream, "Too many codes"); goto endOfDecode; }
+				MyMemSet(&stream->codeLengths[0], 0x00, sizeof(stream->codeLengths));
+				stream->codeLengthIndex = 0;
+				stream->state = InflateState_DynamicCodeLengthCodes;
+			} break;
+			case InflateState_DynamicCodeLengthCodes:
+			{
+				while (stream->codeLengthIndex < stream->numCodeLengthCodes)
+				{
+					INFLATE_NEED_BITS(3);
+					stream->codeLengths[InflateCodeLengthOrder[stream->codeLengthIndex]] = (u8)TakeInflateBits(stream, 3);
+					stream->codeLengthIndex++;
+				}
+				if (!BuildInflateHuffman(&stream->codeLengthHuffman, &stream->codeLengths[0], 19)) { result = FailInflateStream(stream, "Invalid code length code"); goto endOfDecode; }
+				MyMemSet(&stream->codeLengths[0], 0x00, sizeof(stream->codeLengths));
+				stream->codeLengthIndex = 0;
+				stream->state = InflateState_DynamicLengths;
+			} break;
+			case InflateState_DynamicLengths:
+			{
+				u32 numLengths = stream->numLitLenCodes + stream->numDistCodes;
+				while (stream->codeLengthIndex < numLengths)
+				{
+					RefillInflateBits(stream, input);
+					if (stream->numBits < 7 + 7 && !isLastInput) { result = InflateResult_NeedInput; goto endOfDecode; } //longest code length code plus the 7 extra bits of a long zero run
+					i32 symbol = DecodeInflateSymbol(stream, &stream->codeLengthHuffman);
+					if (symbol == INFLATE_NEED_MORE_BITS) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					if (symbol < 0) { result = FailInflateStream(stream, "Invalid code length"); goto endOfDecode; }
+					if (symbol >= 16 && stream->numBits < 7) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					if (symbol < 16) { stream->codeLengths[stream->codeLengthIndex] = (u8)symbol; stream->codeLengthIndex++; continue; }
+					u8 repeatValue = 0;
+					u32 repeatCount = 0;
+					if (symbol == 16)
+					{
+						if (stream->codeLengthIndex == 0) { result = FailInflateStream(stream, "Repeat with no previous length"); goto endOfDecode; }
+						repeatValue = stream->codeLengths[stream->codeLengthIndex-1];
+						repeatCount = 3 + TakeInflateBits(stream, 2);
+					}
+					else if (symbol == 17) { repeatCount = 3 + TakeInflateBits(stream, 3); }
+					else { repeatCount = 11 + TakeInflateBits(stream, 7); }
+					if (stream->codeLengthIndex + repeatCount > numLengths) { result = FailInflateStream(stream, "Too many code lengths"); goto endOfDecode; }
+					for (u32 rIndex = 0; rIndex < repeatCount; rIndex++) { stream->codeLengths[stream->codeLengthIndex] = repeatValue; stream->codeLengthIndex++; }
+				}
+				if (stream->codeLengths[256] == 0) { result = FailInflateStream(stream, "No end of block code"); goto endOfDecode; }
+				if (!BuildInflateHuffman(&stream->litLenHuffman, &stream->codeLengths[0], stream->numLitLenCodes) ||
+					!BuildInflateHuffman(&stream->distHuffman, &stream->codeLengths[stream->numLitLenCodes], stream->numDistCodes))
+				{
+					result = FailInflateStream(stream, "Invalid literal/length or distance code");
+					goto endOfDecode;
+				}
+				stream->state = InflateState_Codes;
+			} break;
+			
+			case InflateState_Codes:
+			{
+				while (true)
+				{
+					if (stream->matchRemaining > 0)
+					{
+						while (stream->matchRemaining > 0 && outIndex < outputSize)
+						{
+							u8 nextByte = stream->window[(stream->windowPos - stream->matchDistance) & INFLATE_WINDOW_MASK];
+							stream->window[stream->windowPos & INFLATE_WINDOW_MASK] = nextByte;
+							stream->windowPos++;
+							output[outIndex] = nextByte;
+							outIndex++;
+							stream->matchRemaining--;
+						}
+						if (stream->matchRemaining > 0) { result = InflateResult_OutputFull; goto endOfDecode; }
+					}
+					if (outIndex >= outputSize) { result = InflateResult_OutputFull; goto endOfDecode; }
+					
+					//NOTE: Unless this is the end of the input we wait until a whole symbol's worth of bits is buffered, so a symbol is never split across calls
+					RefillInflateBits(stream, input);
+					if (stream->numBits < INFLATE_MAX_SYMBOL_BITS && !isLastInput) { result = InflateResult_NeedInput; goto endOfDecode; }
+					
+					i32 symbol = DecodeInflateSymbol(stream, &stream->litLenHuffman);
+					if (symbol == INFLATE_NEED_MORE_BITS) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					if (symbol < 0) { result = FailInflateStream(stream, "Invalid literal/length code"); goto endOfDecode; }
+					if (symbol < 256)
+					{
+						stream->window[stream->windowPos & INFLATE_WINDOW_MASK] = (u8)symbol;
+						stream->windowPos++;
+						output[outIndex] = (u8)symbol;
+						outIndex++;
+						continue;
+					}
+					if (symbol == 256)
+					{
+						stream->state = stream->isFinalBlock ? InflateState_Trailer : InflateState_BlockHeader;
+						break;
+					}
+					
+					u32 lengthIndex = (u32)symbol - 257;
+					if (lengthIndex >= ArrayCount(InflateLengthBase)) { result = FailInflateStream(stream, "Invalid length code"); goto endOfDecode; }
+					if (stream->numBits < InflateLengthExtra[lengthIndex]) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					u32 length = InflateLengthBase[lengthIndex] + TakeInflateBits(stream, InflateLengthExtra[lengthIndex]);
+					i32 distSymbol = DecodeInflateSymbol(stream, &stream->distHuffman);
+					if (distSymbol == INFLATE_NEED_MORE_BITS) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					if (distSymbol < 0 || distSymbol >= 30) { result = FailInflateStream(stream, "Invalid distance code"); goto endOfDecode; }
+					if (stream->numBits < InflateDistExtra[distSymbol]) { result = FailInflateStream(stream, "Truncated"); goto endOfDecode; }
+					u32 distance = InflateDistBase[distSymbol] + TakeInflateBits(stream, InflateDistExtra[distSymbol]);
+					if ((u64)distance > stream->totalOut + outIndex) { result = FailInflateStream(stream, "Distance too far back"); goto endOfDecode; }
+					stream->matchRemaining = length;
+					stream->matchDistance = distance;
+				}
+			} break;
+			
+			case InflateState_Trailer:
+			{
+				AlignInflateBits(stream);
+				//NOTE: The checksum has to cover everything up to here, including this call's output
+				if (stream->format == InflateFormat_Gzip) { stream->checksum = UpdateInflateCrc32(stream->checksum, &output[checksumIndex], outIndex - checksumIndex); }
+				else if (stream->format == InflateFormat_Zlib) { stream->checksum = UpdateInflateAdler32(stream->checksum, &output[checksumIndex], outIndex - checksumIndex); }
+				checksumIndex = outIndex;
+				if (stream->format == InflateFormat_Gzip)
+				{
+					INFLATE_NEED_BITS(64);
+					u32 crc = TakeInflateBits(stream, 32);
+					u32 size = TakeInflateBits(stream, 32);
+					if (crc != stream->checksum) { result = FailInflateStream(stream, "CRC mismatch"); goto endOfDecode; }
+					if (size != (u32)(stream->totalOut + outIndex)) { result = FailInflateStream(stream, "Size mismatch"); goto endOfDecode; }
+				}
+				else if (stream->format == InflateFormat_Zlib)
+				{
+					INFLATE_NEED_BITS(32);
+					u32 adler = TakeInflateBits(stream, 32);
+					adler = ((adler & 0xFF) << 24) | ((adler & 0xFF00) << 8) | ((adler >> 8) & 0xFF00) | (adler >> 24); //stored big endian
+					if (adler != stream->checksum) { result = FailInflateStream(stream, "Adler32 mismatch"); goto endOfDecode; }
+				}
+				stream->state = InflateState_Done;
+			} break;
+			
+			case InflateState_Done: result = InflateResult_Done; goto endOfDecode;
+			case InflateState_Error: result = InflateResult_Error; goto endOfDecode;
+			default: result = FailInflateStream(stream, "Invalid state"); goto endOfDecode;
+		}
+	}
+	
+	endOfDecode:
+	#undef INFLATE_NEED_BITS
+	if (stream->format == InflateFormat_Gzip) { stream->checksum = UpdateInflateCrc32(stream->checksum, &output[checksumIndex], outIndex - checksumIndex); }
+	else if (stream->format == InflateFormat_Zlib) { stream->checksum = UpdateInflateAdler32(stream->checksum, &output[checksumIndex], outIndex - checksumIndex); }
+	stream->totalOut += outIndex;
+	*numOutputOut = outIndex;
+	return result;
+}
+
+// +--------------------------------------------------------------+
+// |                         HttpDecoder                          |
+// +--------------------------------------------------------------+
+#if BUILD_WITH_HTTP
+
+HttpContentEncoding ParseHttpContentEncoding(Str8 value)
+{
+	//NOTE: Technically this can be a list ("gzip, br") of encodings applied in order, but we only ever ask for one and nobody stacks them in practice
+	if (IsEmptyStr(value) || StrAnyCaseEquals(value, StrLit("identity"))) { return HttpContentEncoding_None; }
+	if (StrAnyCaseEquals(value, StrLit("gzip")) || StrAnyCaseEquals(value, StrLit("x-gzip"))) { return HttpContentEncoding_Gzip; }
+	if (StrAnyCaseEquals(value, StrLit("deflate"))) { return HttpContentEncoding_Deflate; }
+	if (StrAnyCaseEquals(value, StrLit("br"))) { return HttpContentEncoding_Brotli; }
+	return HttpContentEncoding_Other;
+}
+
+bool CanDecodeHttpContentEncoding(HttpContentEncoding encoding)
+{
+	return (encoding == HttpContentEncoding_Gzip || encoding == HttpContentEncoding_Deflate);
+}
+
+//NOTE: Expects the service mutex to be held. The returned event lives in the queue until the decode thread gets to it
+// (which can't happen before the caller fills it in and lets go of the mutex, so waking the decoder here is fine)
+HttpEvent* AddHttpDecodeItem(HttpService* service, HttpContentEncoding encoding)
+{
+	HttpDecodeItem* item = VarArrayAdd(HttpDecodeItem, &service->decoder.queue);
+	NotNull(item);
+	ClearPointer(item);
+	item->encoding = encoding;
+	SysWakeWorker(&service->decoder.worker);
+	return &item->event;
+}
+
+HttpDecodeStream* FindOrAddHttpDecodeStream(HttpDecoder* decoder, u64 httpId, HttpContentEncoding encoding)
+{
+	VarArrayLoop(&decoder->streams, sIndex)
+	{
+		HttpDecodeStream* stream = *VarArrayGet(HttpDecodeStream*, &decoder->streams, sIndex);
+		if (stream->httpId == httpId) { return stream; }
+	}
+	HttpDecodeStream* newStream = AllocType(HttpDecodeStream, &decoder->heap);
+	NotNull(newStream);
+	ClearPointer(newStream);
+	newStream->httpId = httpId;
+	newStream->encoding = encoding;
+	InitInflateStream(&newStream->inflate, (encoding == HttpContentEncoding_Gzip) ? InflateFormat_Gzip : InflateFormat_ZlibOrRaw);
+	HttpDecodeStream** streamSpace = VarArrayAdd(HttpDecodeStream*, &decoder->streams);
+	NotNull(streamSpace);
+	*streamSpace = newStream;
+	return newStream;
+}
+
+void RemoveHttpDecodeStream(HttpDecoder* decoder, HttpDecodeStream* stream)
+{
+	VarArrayLoop(&decoder->streams, sIndex)
+	{
+		if (*VarArrayGet(HttpDecodeStream*, &decoder->streams, sIndex) == stream) { VarArrayRemoveAt(HttpDecodeStream*, &decoder->streams, sIndex); break; }
+	}
+	FreeType(HttpDecodeStream, &decoder->heap, stream);
+}
+
+// Returns false (without pushing anything) if the decoder was stopped while it waited for the app to make room
+bool PushDecodedHttpData(HttpService* service, const HttpEvent* sourceEvent, HttpDecodeStream* stream, Str8 decodedBytes)
+{
+	HttpDecoder* decoder = &service->decoder;
+	LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	//NOTE: The app is behind, so the InflateStream stays paused where it is until Plat_PopHttpEvent makes room and wakes us
+	while (service->events.length - service->eventsReadIndex >= HTTP_DECODE_MAX_QUEUED_EVENTS)
+	{
+		decoder->isWaitingForRoom = true;
+		UnlockMutex(&service->mutex);
+		if (SysIsWorkerStopping(&decoder->worker)) { return false; }
+		SysWorkerWait(&decoder->worker, SYS_WAIT_FOREVER);
+		LockMutex(&service->mutex, TIMEOUT_FOREVER);
+	}
+	decoder->isWaitingForRoom = false;
+	HttpEvent* event = VarArrayAdd(HttpEvent, &service->events);
+	NotNull(event);
+	ClearPointer(event);
+	event->type = HttpEventType_Data;
+	event->contextId = sourceEvent->contextId;
+	event->httpId = sourceEvent->httpId;
+	event->timeUs = sourceEvent->timeUs;
+	event->totalBytes = stream->numDecodedBytes;
+	event->bytes = AllocStr8(&service->heap, decodedBytes);
+	UnlockMutex(&service->mutex);
+	return true;
+}
+
+// Runs everything in item through the request's InflateStream, handing the output off as Data events as each buffer fills up
+void DecodeHttpItem(HttpService* service, HttpDecodeItem* item)
+{
+	HttpDecoder* decoder = &service->decoder;
+	HttpEvent* sourceEvent = &item->event;
+	bool isFinished = (sourceEvent->type == HttpEventType_Finished);
+	HttpDecodeStream* stream = FindOrAddHttpDecodeStream(decoder, sourceEvent->httpId, item->encoding);
+	stream->numEncodedBytes += sourceEvent->bytes.length;
+	
+	Str8 input = sourceEvent->bytes;
+	while (!stream->failed && stream->inflate.state != InflateState_Done)
+	{
+		uxx numDecoded = 0;
+		InflateResult result = InflateStreamDecode(&stream->inflate, &input, isFinished, decoder->outputBuffer, HTTP_DECODE_OUTPUT_SIZE, &numDecoded);
+		if (numDecoded > 0)
+		{
+			stream->numDecodedBytes += numDecoded;
+			//NOTE: We're shutting down, the Finished event below still goes out so its headers get freed with the rest of the events
+			if (!PushDecodedHttpData(service, sourceEvent, stream, MakeStr8(numDecoded, (char*)decoder->outputBuffer))) { break; }
+		}
+		if (result == InflateResult_Error)
+		{
+			PrintLine_W("Failed to decode %s response for request %llu after %llu bytes: %s", GetHttpContentEncodingStr(stream->encoding), stream->httpId, stream->numEncodedBytes, stream->inflate.errorStr);
+			stream->failed = true;
+		}
+		if (result != InflateResult_OutputFull) { break; }
+	}
+	
+	if (isFinished)
+	{
+		LockMutex(&service->mutex, TIMEOUT_FOREVER);
+		HttpEvent* event = VarArrayAdd(HttpEvent, &service->events);
+		NotNull(event);
+		MyMemCopy(event, sourceEvent, sizeof(HttpEvent)); //the responseHeaders move over with it
+		event->bytes = Str8_Empty;
+		event->totalBytes = stream->numDecodedBytes;
+		event->encodedBytes = stream->numEncodedBytes;
+		event->contentEncoding = stream->encoding;
+		//NOTE: A body we couldn't decode counts as a failed request, but the request's own error (if any) is the more interesting one
+		if (stream->failed && (event->error == Result_None || event->error == Result_Success)) { event->error = Result_InvalidSyntax; event->state = HttpRequestState_Failure; }
+		UnlockMutex(&service->mutex);
+		RemoveHttpDecodeStream(decoder, stream);
+	}
+}
+
+// +==============================+
+// |    HttpDecodeThreadMain      |
+// +==============================+
+// void HttpDecodeThreadMain(void* contextPntr)
+SYS_THREAD_FUNC_DEF(HttpDecodeThreadMain)
+{
+	HttpService* service = (HttpService*)contextPntr;
+	HttpDecoder* decoder = &service->decoder;
+	InitScratchArenasVirtual(Gigabytes(4));
+	#if TARGET_HAS_THREADING
+	OsSetThreadName(nullptr, StrLit("HttpDecode"));
+	#endif
+	
+	while (!SysIsWorkerStopping(&decoder->worker))
+	{
+		LockMutex(&service->mutex, TIMEOUT_FOREVER);
+		VarArray swapTemp = decoder->processing;
+		decoder->processing = decoder->queue;
+		decoder->queue = swapTemp;
+		UnlockMutex(&service->mutex);
+		
+		if (decoder->processing.length == 0) { SysWorkerWait(&decoder->worker, SYS_WAIT_FOREVER); continue; }
+		
+		TracyCZoneN(Zone_Decode, "HttpDecode", true);
+		VarArrayLoop(&decoder->processing, iIndex)
+		{
+			VarArrayLoopGet(HttpDecodeItem, item, &decoder->processing, iIndex);
+			DecodeHttpItem(service, item);
+		}
+		TracyCZoneEnd(Zone_Decode);
+		
+		LockMutex(&service->mutex, TIMEOUT_FOREVER);
+		VarArrayLoop(&decoder->processing, iIndex)
+		{
+			VarArrayLoopGet(HttpDecodeItem, item, &decoder->processing, iIndex);
+			if (item->event.bytes.chars != nullptr) { FreeStr8(&service->heap, &item->event.bytes); }
+		}
+		VarArrayClear(&decoder->processing);
+		UnlockMutex(&service->mutex);
+	}
+}
+
+void InitHttpDecoder(HttpService* service)
+{
+	HttpDecoder* decoder = &service->decoder;
+	ClearPointer(decoder);
+	InitArenaStdHeap(&decoder->heap);
+	InitVarArray(HttpDecodeStream*, &decoder->streams, &decoder->heap);
+	decoder->outputBuffer = (u8*)AllocMem(&decoder->heap, HTTP_DECODE_OUTPUT_SIZE);
+	NotNull(decoder->outputBuffer);
+	InitVarArray(HttpDecodeItem, &decoder->queue, &service->heap);
+	InitVarArray(HttpDecodeItem, &decoder->processing, &service->heap);
+	bool startedThread = SysStartWorker(&decoder->worker, HttpDecodeThreadMain, (void*)service);
+	Assert(startedThread);
+}
+
+// Should be called after the service thread is stopped, so nothing else is adding to the queue
+void FreeHttpDecoder(HttpService* service)
+{
+	HttpDecoder* decoder = &service->decoder;
+	SysStopWorker(&decoder->worker);
+	
+	VarArrayLoop(&decoder->queue, iIndex)
+	{
+		VarArrayLoopGet(HttpDecodeItem, item, &decoder->queue, iIndex);
+		HttpEvent* event = &item->event;
+		if (event->bytes.chars != nullptr) { FreeStr8(&service->heap, &event->bytes); }
+		for (uxx hIndex = 0; hIndex < event->numResponseHeaders; hIndex++)
+		{
+			FreeStr8(&service->heap, &event->responseHeaders[hIndex].key);
+			FreeStr8(&service->heap, &event->responseHeaders[hIndex].value);
+		}
+		if (event->responseHeaders != nullptr) { FreeArray(Str8Pair, &service->heap, event->numResponseHeaders, event->responseHeaders); }
+	}
+	FreeVarArray(&decoder->queue);
+	FreeVarArray(&decoder->processing);
+	VarArrayLoop(&decoder->streams, sIndex)
+	{
+		FreeType(HttpDecodeStream, &decoder->heap, *VarArrayGet(HttpDecodeStream*, &decoder->streams, sIndex));
+	}
+	FreeVarArray(&decoder->streams);
+	FreeMem(&decoder->heap, decoder->outputBuffer, HTTP_DECODE_OUTPUT_SIZE);
+	ClearPointer(decoder);
+}
+
+#endif //BUILD_WITH_HTTP
@@ -0,0 +1,145 @@
+/*
+File:   platform_http_decode.h
+Date:   10\16\2026
+*/
+
+#ifndef _PLATFORM_HTTP_DECODE_H
+#define _PLATFORM_HTTP_DECODE_H
+
+#define INFLATE_WINDOW_SIZE     32768 //deflate distances never reach back further than this
+#define INFLATE_WINDOW_MASK     (INFLATE_WINDOW_SIZE-1)
+#define INFLATE_MAX_CODE_LENGTH 15
+#define INFLATE_FAST_BITS       9 //codes this short (almost all of them) are decoded with a single table lookup
+#define INFLATE_MAX_LITLEN_CODES 288
+#define INFLATE_MAX_DIST_CODES  32
+#define INFLATE_MAX_SYMBOL_BITS 48 //litlen code + length extra bits + dist code + dist extra bits, the most one symbol can need
+
+typedef enum InflateFormat InflateFormat;
+enum InflateFormat
+{
+	InflateFormat_Raw = 0, //bare deflate blocks
+	InflateFormat_Zlib,
+	InflateFormat_Gzip,
+	InflateFormat_ZlibOrRaw, //"Content-Encoding: deflate" is supposed to be zlib but plenty of servers send raw deflate, so we sniff the first 2 bytes
+	InflateFormat_Count,
+};
+
+typedef enum InflateState InflateState;
+enum InflateState
+{
+	InflateState_ZlibHeader = 0,
+	InflateState_ZlibOrRawHeader,
+	InflateState_GzipHeader,
+	InflateState_GzipHeaderRest,
+	InflateState_GzipExtraLength,
+	InflateState_GzipExtra,
+	InflateState_GzipName,
+	InflateState_GzipComment,
+	InflateState_GzipHeaderCrc,
+	InflateState_BlockHeader,
+	InflateState_StoredLength,
+	InflateState_StoredCopy,
+	InflateState_DynamicHeader,
+	InflateState_DynamicCodeLengthCodes,
+	InflateState_DynamicLengths,
+	InflateState_Codes,
+	InflateState_Trailer,
+	InflateState_Done,
+	InflateState_Error,
+	InflateState_Count,
+};
+
+typedef enum InflateResult InflateResult;
+enum InflateResult
+{
+	InflateResult_NeedInput = 0, //everything passed in was consumed, call again with more
+	InflateResult_OutputFull, //call again (with whatever input is left) once the output has been taken
+	InflateResult_Done,
+	InflateResult_Error,
+	InflateResult_Count,
+};
+
+// Canonical huffman decoding table. counts/symbols are the puff.c style (slow but always correct) representation,
+// fast[] maps the next INFLATE_FAST_BITS bits straight to (symbol << 4) | codeLength for any code that short
+typedef plex InflateHuffman InflateHuffman;
+plex InflateHuffman
+{
+	u16 counts[INFLATE_MAX_CODE_LENGTH+1];
+	u16 symbols[INFLATE_MAX_LITLEN_CODES];
+	u16 fast[1 << INFLATE_FAST_BITS];
+};
+
+// A resumable inflater: input can be handed over in pieces of any size and output comes out in
+// pieces of whatever size the caller has room for. ~40kB, most of that is the window
+typedef plex InflateStream InflateStream;
+plex InflateStream
+{
+	InflateFormat format;
+	InflateState state;
+	const char* errorStr; //set when we move to InflateState_Error
+	u64 bitBuffer; //LSB first, like deflate itself
+	u32 numBits;
+	bool isFinalBlock;
+	
+	u8 gzipFlags;
+	u32 gzipExtraRemaining;
+	u32 storedRemaining;
+	u32 numLitLenCodes;
+	u32 numDistCodes;
+	u32 numCodeLengthCodes;
+	u32 codeLengthIndex;
+	u8 codeLengths[INFLATE_MAX_LITLEN_CODES + INFLATE_MAX_DIST_CODES];
+	InflateHuffman codeLengthHuffman;
+	InflateHuffman litLenHuffman;
+	InflateHuffman distHuffman;
+	u32 matchRemaining; //a length/distance copy that didn't fit in the last output buffer
+	u32 matchDistance;
+	
+	u64 totalOut;
+	u32 checksum; //crc32 for gzip, adler32 for zlib
+	u32 windowPos;
+	u8 window[INFLATE_WINDOW_SIZE];
+};
+
+#if BUILD_WITH_HTTP
+
+// One Data or Finished event for a content-encoded response, waiting on the decode thread.
+// Data events still hold the encoded bytes (allocated from the service heap)
+typedef plex HttpDecodeItem HttpDecodeItem;
+plex HttpDecodeItem
+{
+	HttpContentEncoding encoding;
+	HttpEvent event;
+};
+
+//NOTE: Only ever touched by the decode thread
+typedef plex HttpDecodeStream HttpDecodeStream;
+plex HttpDecodeStream
+{
+	u64 httpId;
+	HttpContentEncoding encoding;
+	bool failed;
+	uxx numEncodedBytes;
+	uxx numDecodedBytes;
+	InflateStream inflate;
+};
+
+typedef plex HttpDecoder HttpDecoder;
+plex HttpDecoder
+{
+	//NOTE: These are only touched by the decode thread
+	Arena heap;
+	VarArray streams; //HttpDecodeStream*
+	u8* outputBuffer; //HTTP_DECODE_OUTPUT_SIZE
+	VarArray processing; //HttpDecodeItem, swapped with queue so we can work through it without holding the mutex
+	
+	//NOTE: These are protected by the HttpService's mutex
+	bool isWaitingForRoom; //PushDecodedHttpData is paused until the app pops an event
+	VarArray queue; //HttpDecodeItem, in the order the service thread saw them. The memory comes from the service heap
+	
+	SysWorker worker; //woken by AddHttpDecodeItem, and by Plat_PopHttpEvent when isWaitingForRoom
+};
+
+#endif //BUILD_WITH_HTTP
+
+#endif //  _PLATFORM_HTTP_DECODE_H
@@ -0,0 +1,1536 @@
+/*
+File:   platform_http_linux.c
+Date:   10\16\2026
+Description:
+	** Holds the LinuxHttpManager, a small HTTP/1.1 client built on non-blocking sockets
+	** and a single epoll instance. It stands in for PigCore's HttpRequestManager on Linux:
+	** requests are made from the same HttpRequestArgs and completion is reported through
+	** args.callback (HTTP_CALLBACK_DEF) with a filled out HttpRequest, so HttpServiceCallback
+	** doesn't care which one it's driving. Body bytes are handed to dataCallback straight
+	** out of the read buffer instead of being collected in the request.
+	** Each connection is a little state machine that only moves forward when epoll says
+	** its socket is ready, so one thread can keep as many connections going as we have
+	** file descriptors for. Keep-alive connections are pooled per host and reused.
+	** With --httpIo=uring plain http connections are driven through io_uring instead
+	** (see platform_http_uring.c): connect, send and recv are submitted as ops and their
+	** completions move the same state machine forward. TLS connections and the wakeFd
+	** stay in the epoll set, and the epoll fd itself gets polled through the ring
+	** Upload bodies (HttpRequestOptions.uploadPath) are mmapped and sent straight from the
+	** file with sendfile, or out of the mapping for TLS and io_uring sends
+	** TLS is done by libssl, which we dlopen at startup so https works on any machine that
+	** has OpenSSL installed without the build having to link against it
+*/
+
+#if HTTP_USE_LINUX_BACKEND
+
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <poll.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <netdb.h>
+#include <errno.h>
+#include <string.h>
+#include <stdio.h>
+
+bool TryParseHttpUrl(Str8 url, HttpUrlParts* partsOut); //defined in platform_http.c
+
+#define LINUX_HTTP_IO_WOULD_BLOCK -1
+#define LINUX_HTTP_IO_ERROR       -2
+
+void StartLinuxHttpRequest(LinuxHttpManager* manager, LinuxHttpRequest* request);
+void QueueLinuxHttpUringSend(LinuxHttpManager* manager, LinuxHttpConn* conn);
+void ArmLinuxHttpUringRecv(LinuxHttpManager* manager, LinuxHttpConn* conn);
+
+// +--------------------------------------------------------------+
+// |                           Buffers                            |
+// +--------------------------------------------------------------+
+void FreeLinuxHttpBuffer(Arena* arena, LinuxHttpBuffer* buffer)
+{
+	if (buffer->chars != nullptr) { FreeMem(arena, buffer->chars, buffer->capacity); }
+	ClearPointer(buffer);
+}
+
+void LinuxHttpBufferAppend(Arena* arena, LinuxHttpBuffer* buffer, const void* bytes, uxx numBytes)
+{
+	if (buffer->length + numBytes > buffer->capacity)
+	{
+		uxx newCapacity = (buffer->capacity > 0) ? buffer->capacity : 256;
+		while (newCapacity < buffer->length + numBytes) { newCapacity *= 2; }
+		char* newChars = (char*)AllocMem(arena, newCapacity);
+		NotNull(newChars);
+		if (buffer->length > 0) { MyMemCopy(newChars, buffer->chars, buffer->length); }
+		if (buffer->chars != nullptr) { FreeMem(arena, buffer->chars, buffer->capacity); }
+		buffer->chars = newChars;
+		buffer->capacity = newCapacity;
+	}
+	if (numBytes > 0) { MyMemCopy(&buffer->chars[buffer->length], bytes, numBytes); }
+	buffer->length += numBytes;
+}
+void LinuxHttpBufferAppendStr(Arena* arena, LinuxHttpBuffer* buffer, Str8 str)
+{
+	LinuxHttpBufferAppend(arena, buffer, str.chars, str.length);
+}
+
+// application/x-www-form-urlencoded: unreserved characters pass through, spaces become '+' and everything else gets %XX'd
+void LinuxHttpBufferAppendFormEncoded(Arena* arena, LinuxHttpBuffer* buffer, Str8 str)
+{
+	const char* hexChars = "0123456789ABCDEF";
+	for (uxx cIndex = 0; cIndex < str.length; cIndex++)
+	{
+		u8 c = (u8)str.chars[cIndex];
+		bool isUnreserved = ((c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '-' || c == '_' || c == '.' || c == '~');
+		if (isUnreserved) { LinuxHttpBufferAppend(arena, buffer, &c, 1); }
+		else if (c == ' ') { LinuxHttpBufferAppend(arena, buffer, "+", 1); }
+		else
+		{
+			char encoded[3] = { '%', hexChars[c >> 4], hexChars[c & 0x0F] };
+			LinuxHttpBufferAppend(arena, buffer, &encoded[0], ArrayCount(encoded));
+		}
+	}
+}
+
+Str8 LinuxHttpTrimSpaces(Str8 str)
+{
+	while (str.length > 0 && (str.chars[0] == ' ' || str.chars[0] == '\t')) { str = StrSliceFrom(str, 1); }
+	while (str.length > 0 && (str.chars[str.length-1] == ' ' || str.chars[str.length-1] == '\t')) { str = StrSlice(str, 0, str.length-1); }
+	return str;
+}
+
+bool LinuxHttpHasHeader(const HttpRequestArgs* args, Str8 key)
+{
+	for (uxx hIndex = 0; hIndex < args->numHeaders; hIndex++)
+	{
+		if (StrAnyCaseEquals(args->headers[hIndex].key, key)) { return true; }
+	}
+	return false;
+}
+
+void BuildLinuxHttpRequestBytes(LinuxHttpManager* manager, LinuxHttpRequest* request, const HttpUrlParts* urlParts)
+{
+	ScratchBegin(scratch);
+	Arena* arena = manager->arena;
+	const HttpRequestArgs* args = &request->args;
+	LinuxHttpBuffer* buffer = &request->requestBytes;
+	
+	LinuxHttpBuffer body = ZEROED;
+	for (uxx cIndex = 0; !request->hasUpload && cIndex < args->numContentItems; cIndex++)
+	{
+		if (cIndex > 0) { LinuxHttpBufferAppend(arena, &body, "&", 1); }
+		LinuxHttpBufferAppendFormEncoded(arena, &body, args->contentItems[cIndex].key);
+		LinuxHttpBufferAppend(arena, &body, "=", 1);
+		LinuxHttpBufferAppendFormEncoded(arena, &body, args->contentItems[cIndex].value);
+	}
+	
+	//NOTE: "http://host" and "http://host?x=1" have no '/' of their own, the request target still has to start with one
+	bool needsSlash = (urlParts->path.length == 0 || urlParts->path.chars[0] != '/');
+	LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, "%s %s%.*s HTTP/1.1\r\n", GetHttpVerbStr(args->verb), needsSlash ? "/" : "", StrPrint(urlParts->path)));
+	if (!LinuxHttpHasHeader(args, StrLit("Host")))
+	{
+		bool isIpv6 = false;
+		for (uxx cIndex = 0; cIndex < urlParts->host.length; cIndex++) { if (urlParts->host.chars[cIndex] == ':') { isIpv6 = true; break; } }
+		bool isDefaultPort = (urlParts->port == (urlParts->isHttps ? 443 : 80));
+		LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, "Host: %s%.*s%s", isIpv6 ? "[" : "", StrPrint(urlParts->host), isIpv6 ? "]" : ""));
+		if (!isDefaultPort) { LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, ":%u", urlParts->port)); }
+		LinuxHttpBufferAppendStr(arena, buffer, StrLit("\r\n"));
+	}
+	if (!LinuxHttpHasHeader(args, StrLit("User-Agent"))) { LinuxHttpBufferAppendStr(arena, buffer, StrLit("User-Agent: " PROJECT_READABLE_NAME_STR "\r\n")); }
+	for (uxx hIndex = 0; hIndex < args->numHeaders; hIndex++)
+	{
+		LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, "%.*s: %.*s\r\n", StrPrint(args->headers[hIndex].key), StrPrint(args->headers[hIndex].value)));
+	}
+	if (request->hasUpload)
+	{
+		//NOTE: The file's bytes follow requestBytes on the wire but are never copied into it (see DoLinuxHttpSend)
+		if (!LinuxHttpHasHeader(args, StrLit("Content-Type"))) { LinuxHttpBufferAppendStr(arena, buffer, StrLit("Content-Type: application/octet-stream\r\n")); }
+		LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, "Content-Length: %llu\r\n", (u64)request->uploadSize));
+	}
+	else if (body.length > 0 || args->verb == HttpVerb_POST)
+	{
+		if (body.length > 0 && args->contentEncoding == MimeType_FormUrlEncoded && !LinuxHttpHasHeader(args, StrLit("Content-Type")))
+		{
+			LinuxHttpBufferAppendStr(arena, buffer, StrLit("Content-Type: application/x-www-form-urlencoded\r\n"));
+		}
+		LinuxHttpBufferAppendStr(arena, buffer, PrintInArenaStr(scratch, "Content-Length: %llu\r\n", (u64)body.length));
+	}
+	LinuxHttpBufferAppendStr(arena, buffer, StrLit("\r\n"));
+	LinuxHttpBufferAppend(arena, buffer, body.chars, body.length);
+	
+	FreeLinuxHttpBuffer(arena, &body);
+	ScratchEnd(scratch);
+}
+
+// +--------------------------------------------------------------+
+// |                       Hosts and DNS                          |
+// +--------------------------------------------------------------+
+uxx FindOrAddLinuxHttpHost(LinuxHttpManager* manager, const HttpUrlParts* urlParts)
+{
+	VarArrayLoop(&manager->hosts, hIndex)
+	{
+		VarArrayLoopGet(LinuxHttpHost, host, &manager->hosts, hIndex);
+		if (host->port == urlParts->port && host->isHttps == urlParts->isHttps && StrAnyCaseEquals(host->name, urlParts->host)) { return hIndex; }
+	}
+	LinuxHttpHost* newHost = VarArrayAdd(LinuxHttpHost, &manager->hosts);
+	NotNull(newHost);
+	ClearPointer(newHost);
+	newHost->name = AllocStr8(manager->arena, urlParts->host);
+	newHost->port = urlParts->port;
+	newHost->isHttps = urlParts->isHttps;
+	InitVarArray(LinuxHttpConn*, &newHost->idleConns, manager->arena);
+	InitVarArray(LinuxHttpRequest*, &newHost->waitingRequests, manager->arena);
+	return manager->hosts.length-1;
+}
+
+void QueueLinuxHttpDnsQuery(LinuxHttpManager* manager, uxx hostIndex)
+{
+	LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, hostIndex);
+	Assert(host->dnsState != LinuxHttpDnsState_Resolving);
+	host->dnsState = LinuxHttpDnsState_Resolving;
+	
+	LinuxHttpDnsQuery* query = AllocType(LinuxHttpDnsQuery, manager->arena);
+	NotNull(query);
+	ClearPointer(query);
+	query->hostIndex = hostIndex;
+	query->port = host->port;
+	uxx nameLength = (host->name.length < ArrayCount(query->nameNt)) ? host->name.length : ArrayCount(query->nameNt)-1;
+	MyMemCopy(&query->nameNt[0], host->name.chars, nameLength);
+	query->nameNt[nameLength] = '\0';
+	
+	LockMutex(&manager->dnsMutex, TIMEOUT_FOREVER);
+	LinuxHttpDnsQuery** querySpace = VarArrayAdd(LinuxHttpDnsQuery*, &manager->dnsQueries);
+	NotNull(querySpace);
+	*querySpace = query;
+	UnlockMutex(&manager->dnsMutex);
+	
+	u64 increment = 1;
+	ssize_t writeResult = write(manager->dnsWorkFd, &increment, sizeof(increment));
+	UNUSED(writeResult);
+}
+
+// +==============================+
+// |    LinuxHttpDnsThreadMain    |
+// +==============================+
+// void LinuxHttpDnsThreadMain(void* contextPntr)
+SYS_THREAD_FUNC_DEF(LinuxHttpDnsThreadMain)
+{
+	LinuxHttpManager* manager = (LinuxHttpManager*)contextPntr;
+	#if TARGET_HAS_THREADING
+	OsSetThreadName(nullptr, StrLit("HttpDns"));
+	#endif
+	
+	while (true)
+	{
+		LinuxHttpDnsQuery* query = nullptr;
+		LockMutex(&manager->dnsMutex, TIMEOUT_FOREVER);
+		bool stopRequested = manager->dnsStopRequested;
+		if (!stopRequested && manager->dnsQueriesReadIndex < manager->dnsQueries.length)
+		{
+			query = *VarArrayGet(LinuxHttpDnsQuery*, &manager->dnsQueries, manager->dnsQueriesReadIndex);
+			manager->dnsQueriesReadIndex++;
+			if (manager->dnsQueriesReadIndex >= manager->dnsQueries.length) { VarArrayClear(&manager->dnsQueries); manager->dnsQueriesReadIndex = 0; }
+		}
+		UnlockMutex(&manager->dnsMutex);
+		if (stopRequested) { break; }
+		if (query == nullptr)
+		{
+			//NOTE: Blocks until QueueLinuxHttpDnsQuery (or FreeLinuxHttpManager) bumps the counter. Anything queued after we checked above already did, so we can't miss it
+			u64 counter = 0;
+			ssize_t readResult = read(manager->dnsWorkFd, &counter, sizeof(counter));
+			UNUSED(readResult);
+			continue;
+		}
+		
+		char portNt[8];
+		snprintf(&portNt[0], sizeof(portNt), "%u", (unsigned int)query->port);
+		struct addrinfo hints = ZEROED;
+		hints.ai_family = AF_UNSPEC;
+		hints.ai_socktype = SOCK_STREAM;
+		hints.ai_flags = AI_ADDRCONFIG;
+		struct addrinfo* addresses = nullptr;
+		int resolveResult = getaddrinfo(&query->nameNt[0], &portNt[0], &hints, &addresses);
+		if (resolveResult == 0 && addresses != nullptr && addresses->ai_addrlen <= sizeof(query->address))
+		{
+			MyMemCopy(&query->address, addresses->ai_addr, addresses->ai_addrlen);
+			query->addressLength = (socklen_t)addresses->ai_addrlen;
+			query->succeeded = true;
+		}
+		else { PrintLine_W("Failed to resolve \"%s\": %s", &query->nameNt[0], gai_strerror(resolveResult)); }
+		if (addresses != nullptr) { freeaddrinfo(addresses); }
+		
+		LockMutex(&manager->dnsMutex, TIMEOUT_FOREVER);
+		LinuxHttpDnsQuery** resultSpace = VarArrayAdd(LinuxHttpDnsQuery*, &manager->dnsResults);
+		NotNull(resultSpace);
+		*resultSpace = query;
+		UnlockMutex(&manager->dnsMutex);
+		
+		u64 increment = 1;
+		ssize_t writeResult = write(manager->wakeFd, &increment, sizeof(increment));
+		UNUSED(writeResult);
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                   Requests and Connections                   |
+// +--------------------------------------------------------------+
+// Maps the whole file up front, so every later send (including a resend after a stale keep-alive) just reads from the mapping
+bool TryOpenLinuxHttpUpload(LinuxHttpRequest* request, Str8 path)
+{
+	ScratchBegin(scratch);
+	Str8 pathNt = AllocStrAndCopy(scratch, path.length, path.chars, true);
+	int fd = open(pathNt.chars, O_RDONLY|O_CLOEXEC);
+	ScratchEnd(scratch);
+	if (fd < 0) { PrintLine_W("Failed to open upload file \"%.*s\": %s", StrPrint(path), strerror(errno)); return false; }
+	struct stat fileInfo = ZEROED;
+	if (fstat(fd, &fileInfo) != 0 || !S_ISREG(fileInfo.st_mode))
+	{
+		PrintLine_W("Upload \"%.*s\" isn't a regular file", StrPrint(path));
+		close(fd);
+		return false;
+	}
+	request->uploadSize = (uxx)fileInfo.st_size;
+	if (request->uploadSize > 0)
+	{
+		void* mapping = mmap(nullptr, request->uploadSize, PROT_READ, MAP_SHARED, fd, 0);
+		if (mapping == MAP_FAILED)
+		{
+			PrintLine_W("Failed to map %llu byte upload \"%.*s\": %s", (u64)request->uploadSize, StrPrint(path), strerror(errno));
+			close(fd);
+			return false;
+		}
+		madvise(mapping, request->uploadSize, MADV_SEQUENTIAL);
+		request->uploadMapping = (u8*)mapping;
+	}
+	request->uploadFd = fd;
+	request->hasUpload = true;
+	return true;
+}
+
+uxx GetLinuxHttpRequestSendLength(const LinuxHttpRequest* request)
+{
+	return request->requestBytes.length + request->uploadSize;
+}
+
+//NOTE: Callers hold off on this (see releasedRequests) while a uring send is in flight, the kernel may still be reading uploadMapping
+void FreeLinuxHttpRequest(LinuxHttpManager* manager, LinuxHttpRequest* request)
+{
+	Assert(request->numUringSends == 0);
+	if (request->uploadMapping != nullptr) { munmap(request->uploadMapping, request->uploadSize); }
+	if (request->hasUpload) { close(request->uploadFd); }
+	FreeLinuxHttpBuffer(manager->arena, &request->requestBytes);
+	FreeLinuxHttpBuffer(manager->arena, &request->headerBytes);
+	FreeLinuxHttpBuffer(manager->arena, &request->chunkLine);
+	FreeVarArray(&request->responseHeaders);
+	FreeType(LinuxHttpRequest, manager->arena, request);
+}
+
+void CompleteLinuxHttpRequest(LinuxHttpManager* manager, LinuxHttpRequest* request, Result error)
+{
+	request->error = error;
+	LinuxHttpRequest** finishedSpace = VarArrayAdd(LinuxHttpRequest*, &manager->finishedRequests);
+	NotNull(finishedSpace);
+	*finishedSpace = request;
+}
+
+void SetLinuxHttpConnInterest(LinuxHttpManager* manager, LinuxHttpConn* conn, u32 events)
+{
+	if (conn->usesUring || conn->epollEvents == events) { return; }
+	struct epoll_event event = ZEROED;
+	event.events = events;
+	event.data.ptr = (void*)conn;
+	int ctlResult = epoll_ctl(manager->epollFd, EPOLL_CTL_MOD, conn->fd, &event);
+	DebugAssert(ctlResult == 0);
+	UNUSED(ctlResult);
+	conn->epollEvents = events;
+}
+
+void FreeLinuxHttpConn(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	Assert(conn->numUringOps == 0);
+	if (conn->uringRecvBuffer != nullptr) { FreeArray(char, manager->arena, LINUX_HTTP_URING_RECV_SIZE, conn->uringRecvBuffer); }
+	FreeType(LinuxHttpConn, manager->arena, conn);
+}
+
+//NOTE: The conn memory sticks around (in closedConns) until the end of this update since readyEvents may still point at it,
+//      and for uring conns until every op that was in flight has come back
+void CloseLinuxHttpConn(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	Assert(conn->fd >= 0);
+	Assert(conn->request == nullptr);
+	if (conn->state == LinuxHttpConnState_Idle)
+	{
+		LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+		VarArrayLoop(&host->idleConns, iIndex)
+		{
+			if (*VarArrayGet(LinuxHttpConn*, &host->idleConns, iIndex) == conn) { VarArrayRemoveAt(LinuxHttpConn*, &host->idleConns, iIndex); break; }
+		}
+	}
+	#if LINUX_HTTP_USE_OPENSSL
+	if (conn->ssl != nullptr) { manager->openSsl.SSL_free(conn->ssl); conn->ssl = nullptr; }
+	#endif
+	//NOTE: In-flight ops hold their own reference to the socket so close alone won't finish them. shutdown makes them all complete (with an error) promptly
+	if (conn->numUringOps > 0) { shutdown(conn->fd, SHUT_RDWR); }
+	close(conn->fd);
+	conn->fd = -1;
+	conn->state = LinuxHttpConnState_None;
+	
+	uxx lastIndex = manager->conns.length-1;
+	if (conn->connIndex != lastIndex)
+	{
+		LinuxHttpConn* lastConn = *VarArrayGet(LinuxHttpConn*, &manager->conns, lastIndex);
+		*VarArrayGet(LinuxHttpConn*, &manager->conns, conn->connIndex) = lastConn;
+		lastConn->connIndex = conn->connIndex;
+	}
+	VarArrayRemoveAt(LinuxHttpConn*, &manager->conns, lastIndex);
+	LinuxHttpConn** closedSpace = VarArrayAdd(LinuxHttpConn*, &manager->closedConns);
+	NotNull(closedSpace);
+	*closedSpace = conn;
+}
+
+void FailLinuxHttpConn(LinuxHttpManager* manager, LinuxHttpConn* conn, Result error)
+{
+	LinuxHttpRequest* request = conn->request;
+	conn->request = nullptr;
+	bool canRetry = (request != nullptr && conn->isReused && !request->retriedStaleConnection && request->headerBytes.length == 0);
+	CloseLinuxHttpConn(manager, conn);
+	if (request == nullptr) { return; }
+	if (canRetry)
+	{
+		//NOTE: The server dropped an idle keep-alive connection right as we picked it up. Nothing came back so it's safe to send the request again on a fresh connection
+		request->retriedStaleConnection = true;
+		request->numBytesSent = 0;
+		StartLinuxHttpRequest(manager, request);
+	}
+	else { CompleteLinuxHttpRequest(manager, request, error); }
+}
+
+// The response is done, the request gets reported and the connection goes back to its host's pool (unless the server asked us to close it)
+void FinishLinuxHttpResponse(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	LinuxHttpRequest* request = conn->request;
+	NotNull(request);
+	conn->request = nullptr;
+	conn->numRequestsServed++;
+	//NOTE: The server answered before our send completed. That send still points at this request's bytes, so the conn can't take another request
+	if (conn->usesUring && conn->state == LinuxHttpConnState_Sending) { request->connectionClose = true; }
+	CompleteLinuxHttpRequest(manager, request, Result_Success);
+	if (request->connectionClose) { CloseLinuxHttpConn(manager, conn); return; }
+	
+	LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+	conn->state = LinuxHttpConnState_Idle;
+	conn->idleSinceUs = SysGetTimeUs();
+	SetLinuxHttpConnInterest(manager, conn, EPOLLIN);
+	LinuxHttpConn** idleSpace = VarArrayAdd(LinuxHttpConn*, &host->idleConns);
+	NotNull(idleSpace);
+	*idleSpace = conn;
+}
+
+#if LINUX_HTTP_USE_OPENSSL
+// +--------------------------------------------------------------+
+// |                           OpenSSL                            |
+// +--------------------------------------------------------------+
+// Tries the sonames of every OpenSSL version that has TLS_client_method, newest first. libcrypto comes along as a dependency
+// of libssl and dlsym on libssl's handle searches it too, so the ERR_ functions are found the same way
+bool LoadLinuxHttpOpenSsl(LinuxHttpOpenSsl* openSsl)
+{
+	NotNull(openSsl);
+	ClearPointer(openSsl);
+	const char* libraryNames[] = { "libssl.so.3", "libssl.so.1.1", "libssl.so" };
+	for (uxx nIndex = 0; nIndex < ArrayCount(libraryNames) && openSsl->libraryHandle == nullptr; nIndex++)
+	{
+		openSsl->libraryHandle = dlopen(libraryNames[nIndex], RTLD_NOW|RTLD_LOCAL);
+	}
+	if (openSsl->libraryHandle == nullptr) { return false; }
+	
+	bool foundAll = true;
+	#define LoadOpenSslFunc(functionName) do                                                        \
+	{                                                                                               \
+		*(void**)&openSsl->functionName = dlsym(openSsl->libraryHandle, #functionName);             \
+		if (openSsl->functionName == nullptr) { PrintLine_W("libssl is missing %s", #functionName); foundAll = false; } \
+	} while (0)
+	LoadOpenSslFunc(TLS_client_method);
+	LoadOpenSslFunc(SSL_CTX_new);
+	LoadOpenSslFunc(SSL_CTX_free);
+	LoadOpenSslFunc(SSL_CTX_set_default_verify_paths);
+	LoadOpenSslFunc(SSL_CTX_set_verify);
+	LoadOpenSslFunc(SSL_new);
+	LoadOpenSslFunc(SSL_free);
+	LoadOpenSslFunc(SSL_set_fd);
+	LoadOpenSslFunc(SSL_ctrl);
+	LoadOpenSslFunc(SSL_set1_host);
+	LoadOpenSslFunc(SSL_connect);
+	LoadOpenSslFunc(SSL_read);
+	LoadOpenSslFunc(SSL_write);
+	LoadOpenSslFunc(SSL_get_error);
+	LoadOpenSslFunc(SSL_pending);
+	LoadOpenSslFunc(ERR_get_error);
+	LoadOpenSslFunc(ERR_reason_error_string);
+	#undef LoadOpenSslFunc
+	
+	if (!foundAll)
+	{
+		dlclose(openSsl->libraryHandle);
+		ClearPointer(openSsl);
+		return false;
+	}
+	openSsl->isLoaded = true;
+	return true;
+}
+#endif //LINUX_HTTP_USE_OPENSSL
+
+// +--------------------------------------------------------------+
+// |                         Socket I/O                           |
+// +--------------------------------------------------------------+
+ixx LinuxHttpConnWrite(LinuxHttpManager* manager, LinuxHttpConn* conn, const char* bytes, uxx numBytes)
+{
+	#if LINUX_HTTP_USE_OPENSSL
+	if (conn->ssl != nullptr)
+	{
+		int writeResult = manager->openSsl.SSL_write(conn->ssl, bytes, (int)numBytes);
+		if (writeResult > 0) { return (ixx)writeResult; }
+		int sslError = manager->openSsl.SSL_get_error(conn->ssl, writeResult);
+		if (sslError == LINUX_SSL_ERROR_WANT_WRITE || sslError == LINUX_SSL_ERROR_WANT_READ) { return LINUX_HTTP_IO_WOULD_BLOCK; }
+		return LINUX_HTTP_IO_ERROR;
+	}
+	#endif
+	ssize_t writeResult = send(conn->fd, bytes, numBytes, MSG_NOSIGNAL);
+	if (writeResult >= 0) { return (ixx)writeResult; }
+	if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) { return LINUX_HTTP_IO_WOULD_BLOCK; }
+	return LINUX_HTTP_IO_ERROR;
+}
+
+// Returns 0 when the other end closed the connection
+ixx LinuxHttpConnRead(LinuxHttpManager* manager, LinuxHttpConn* conn, char* buffer, uxx bufferSize)
+{
+	#if LINUX_HTTP_USE_OPENSSL
+	if (conn->ssl != nullptr)
+	{
+		int readResult = manager->openSsl.SSL_read(conn->ssl, buffer, (int)bufferSize);
+		if (readResult > 0) { return (ixx)readResult; }
+		int sslError = manager->openSsl.SSL_get_error(conn->ssl, readResult);
+		if (sslError == LINUX_SSL_ERROR_ZERO_RETURN) { return 0; }
+		if (sslError == LINUX_SSL_ERROR_WANT_READ || sslError == LINUX_SSL_ERROR_WANT_WRITE) { return LINUX_HTTP_IO_WOULD_BLOCK; }
+		return LINUX_HTTP_IO_ERROR;
+	}
+	#endif
+	ssize_t readResult = recv(conn->fd, buffer, bufferSize, 0);
+	if (readResult >= 0) { return (ixx)readResult; }
+	if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) { return LINUX_HTTP_IO_WOULD_BLOCK; }
+	return LINUX_HTTP_IO_ERROR;
+}
+
+//NOTE: OpenSSL can be holding decrypted bytes that epoll knows nothing about, those have to be read before we go back to waiting
+bool LinuxHttpConnHasPendingBytes(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	#if LINUX_HTTP_USE_OPENSSL
+	if (conn->ssl != nullptr) { return (manager->openSsl.SSL_pending(conn->ssl) > 0); }
+	#endif
+	UNUSED(manager);
+	UNUSED(conn);
+	return false;
+}
+
+// Sends the next piece of the upload body starting at bodyOffset. Same return values as LinuxHttpConnWrite
+ixx LinuxHttpConnWriteUpload(LinuxHttpManager* manager, LinuxHttpConn* conn, LinuxHttpRequest* request, uxx bodyOffset)
+{
+	uxx numBytes = request->uploadSize - bodyOffset;
+	if (numBytes > LINUX_HTTP_UPLOAD_SEND_SIZE) { numBytes = LINUX_HTTP_UPLOAD_SEND_SIZE; }
+	#if LINUX_HTTP_USE_OPENSSL
+	if (conn->ssl != nullptr) { return LinuxHttpConnWrite(manager, conn, (const char*)&request->uploadMapping[bodyOffset], numBytes); }
+	#else
+	UNUSED(manager);
+	#endif
+	//NOTE: Plain sockets let the kernel move pages from the page cache straight to the socket, nothing passes through our memory
+	off_t fileOffset = (off_t)bodyOffset;
+	ssize_t writeResult = sendfile(conn->fd, request->uploadFd, &fileOffset, numBytes);
+	if (writeResult > 0) { return (ixx)writeResult; }
+	if (writeResult == 0) { return LINUX_HTTP_IO_ERROR; } //the file got shorter since we mapped it
+	if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) { return LINUX_HTTP_IO_WOULD_BLOCK; }
+	return LINUX_HTTP_IO_ERROR;
+}
+
+void DoLinuxHttpSend(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	LinuxHttpRequest* request = conn->request;
+	NotNull(request);
+	uxx sendLength = GetLinuxHttpRequestSendLength(request);
+	while (request->numBytesSent < sendLength)
+	{
+		ixx numWritten = 0;
+		if (request->numBytesSent < request->requestBytes.length) { numWritten = LinuxHttpConnWrite(manager, conn, &request->requestBytes.chars[request->numBytesSent], request->requestBytes.length - request->numBytesSent); }
+		else { numWritten = LinuxHttpConnWriteUpload(manager, conn, request, request->numBytesSent - request->requestBytes.length); }
+		if (numWritten == LINUX_HTTP_IO_WOULD_BLOCK) { return; }
+		if (numWritten < 0) { FailLinuxHttpConn(manager, conn, Result_Failure); return; }
+		request->numBytesSent += (uxx)numWritten;
+	}
+	if (request->timings != nullptr) { request->timings->requestSentUs = SysGetTimeUs(); }
+	conn->state = LinuxHttpConnState_Receiving;
+	SetLinuxHttpConnInterest(manager, conn, EPOLLIN);
+}
+
+void BeginLinuxHttpSend(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	conn->state = LinuxHttpConnState_Sending;
+	conn->request->numBytesSent = 0;
+	if (conn->usesUring) { QueueLinuxHttpUringSend(manager, conn); return; }
+	SetLinuxHttpConnInterest(manager, conn, EPOLLOUT);
+	//NOTE: The socket is almost always writable right after connecting (or sitting idle), so try now rather than waiting another trip through epoll
+	DoLinuxHttpSend(manager, conn);
+}
+
+#if LINUX_HTTP_USE_OPENSSL
+void ContinueLinuxHttpTlsHandshake(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	int connectResult = manager->openSsl.SSL_connect(conn->ssl);
+	if (connectResult == 1)
+	{
+		if (conn->request->timings != nullptr) { conn->request->timings->tlsEndUs = SysGetTimeUs(); }
+		BeginLinuxHttpSend(manager, conn);
+		return;
+	}
+	int sslError = manager->openSsl.SSL_get_error(conn->ssl, connectResult);
+	if (sslError == LINUX_SSL_ERROR_WANT_READ) { SetLinuxHttpConnInterest(manager, conn, EPOLLIN); }
+	else if (sslError == LINUX_SSL_ERROR_WANT_WRITE) { SetLinuxHttpConnInterest(manager, conn, EPOLLOUT); }
+	else
+	{
+		LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+		const char* errorStr = manager->openSsl.ERR_reason_error_string(manager->openSsl.ERR_get_error());
+		PrintLine_W("TLS handshake with %.*s failed: %s", StrPrint(host->name), (errorStr != nullptr) ? errorStr : "unknown error");
+		FailLinuxHttpConn(manager, conn, Result_Failure);
+	}
+}
+#endif //LINUX_HTTP_USE_OPENSSL
+
+void OnLinuxHttpConnected(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	u64 nowUs = SysGetTimeUs();
+	LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+	if (conn->request->timings != nullptr) { conn->request->timings->connectEndUs = nowUs; }
+	#if LINUX_HTTP_USE_OPENSSL
+	if (host->isHttps)
+	{
+		ScratchBegin(scratch);
+		Str8 hostNameNt = PrintInArenaStr(scratch, "%.*s", StrPrint(host->name));
+		conn->ssl = manager->openSsl.SSL_new(manager->sslContext);
+		NotNull(conn->ssl);
+		manager->openSsl.SSL_set_fd(conn->ssl, conn->fd);
+		manager->openSsl.SSL_ctrl(conn->ssl, LINUX_SSL_CTRL_SET_TLSEXT_HOSTNAME, LINUX_SSL_TLSEXT_NAMETYPE_HOST_NAME, (void*)hostNameNt.chars);
+		manager->openSsl.SSL_set1_host(conn->ssl, hostNameNt.chars);
+		ScratchEnd(scratch);
+		conn->state = LinuxHttpConnState_TlsHandshake;
+		ContinueLinuxHttpTlsHandshake(manager, conn);
+		return;
+	}
+	#else
+	UNUSED(host);
+	#endif
+	if (conn->request->timings != nullptr) { conn->request->timings->tlsEndUs = nowUs; } //no handshake for plain http, so that phase takes no time
+	if (conn->usesUring) { ArmLinuxHttpUringRecv(manager, conn); }
+	BeginLinuxHttpSend(manager, conn);
+}
+
+void OpenLinuxHttpConn(LinuxHttpManager* manager, LinuxHttpRequest* request)
+{
+	LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, request->hostIndex);
+	//NOTE: io_uring never blocks us on a socket, and on some kernels it hands back -EAGAIN for O_NONBLOCK ones instead of waiting, so uring sockets stay blocking
+	bool useUring = (manager->uring.enabled && !host->isHttps);
+	int fd = socket(host->address.ss_family, SOCK_STREAM|SOCK_CLOEXEC|(useUring ? 0 : SOCK_NONBLOCK), IPPROTO_TCP);
+	if (fd < 0)
+	{
+		PrintLine_W("Failed to open socket for %.*s: %s", StrPrint(host->name), strerror(errno));
+		CompleteLinuxHttpRequest(manager, request, Result_Failure);
+		return;
+	}
+	int noDelay = 1;
+	setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+	
+	LinuxHttpConn* conn = AllocType(LinuxHttpConn, manager->arena);
+	NotNull(conn);
+	ClearPointer(conn);
+	conn->fd = fd;
+	conn->hostIndex = request->hostIndex;
+	conn->state = LinuxHttpConnState_Connecting;
+	conn->request = request;
+	conn->connIndex = manager->conns.length;
+	LinuxHttpConn** connSpace = VarArrayAdd(LinuxHttpConn*, &manager->conns);
+	NotNull(connSpace);
+	*connSpace = conn;
+	
+	if (useUring)
+	{
+		conn->usesUring = true;
+		conn->uringRecvBuffer = AllocArray(char, manager->arena, LINUX_HTTP_URING_RECV_SIZE);
+		NotNull(conn->uringRecvBuffer);
+		MyMemCopy(&conn->address, &host->address, sizeof(conn->address));
+		conn->addressLength = host->addressLength;
+		QueueLinuxHttpUringOp(&manager->uring, IORING_OP_CONNECT, fd, (u64)(uxx)&conn->address, 0, (u64)conn->addressLength, (u64)(uxx)conn | LinuxHttpUringOp_Connect);
+		conn->numUringOps++;
+		return;
+	}
+	
+	struct epoll_event event = ZEROED;
+	event.events = EPOLLOUT;
+	event.data.ptr = (void*)conn;
+	if (epoll_ctl(manager->epollFd, EPOLL_CTL_ADD, fd, &event) != 0)
+	{
+		PrintLine_W("epoll_ctl failed for %.*s: %s", StrPrint(host->name), strerror(errno));
+		FailLinuxHttpConn(manager, conn, Result_Failure);
+		return;
+	}
+	conn->epollEvents = EPOLLOUT;
+	
+	int connectResult = connect(fd, (struct sockaddr*)&host->address, host->addressLength);
+	if (connectResult == 0) { OnLinuxHttpConnected(manager, conn); } //loopback connects can finish right away
+	else if (errno != EINPROGRESS)
+	{
+		PrintLine_W("Failed to connect to %.*s: %s", StrPrint(host->name), strerror(errno));
+		FailLinuxHttpConn(manager, conn, Result_Failure);
+	}
+	//otherwise EPOLLOUT tells us when the connect finished (see HandleLinuxHttpConnEvent)
+}
+
+void StartLinuxHttpRequest(LinuxHttpManager* manager, LinuxHttpRequest* request)
+{
+	u64 nowUs = SysGetTimeUs();
+	LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, request->hostIndex);
+	
+	if (host->idleConns.length > 0)
+	{
+		//NOTE: The most recently used connection is the least likely to have been closed by the server
+		LinuxHttpConn* conn = *VarArrayGet(LinuxHttpConn*, &host->idleConns, host->idleConns.length-1);
+		VarArrayRemoveAt(LinuxHttpConn*, &host->idleConns, host->idleConns.length-1);
+		conn->isReused = true;
+		conn->request = request;
+		if (request->timings != nullptr)
+		{
+			//NOTE: A warm connection has nothing to wait on, so the DNS, connect and TLS phases all take no time
+			request->timings->dnsEndUs = nowUs;
+			request->timings->connectEndUs = nowUs;
+			request->timings->tlsEndUs = nowUs;
+		}
+		BeginLinuxHttpSend(manager, conn);
+		return;
+	}
+	
+	bool dnsIsStale = (host->dnsState == LinuxHttpDnsState_Resolved && nowUs - host->resolvedTimeUs >= LINUX_HTTP_DNS_CACHE_TIME);
+	if (host->dnsState != LinuxHttpDnsState_Resolved || dnsIsStale)
+	{
+		LinuxHttpRequest** waitingSpace = VarArrayAdd(LinuxHttpRequest*, &host->waitingRequests);
+		NotNull(waitingSpace);
+		*waitingSpace = request;
+		if (host->dnsState != LinuxHttpDnsState_Resolving) { QueueLinuxHttpDnsQuery(manager, request->hostIndex); }
+		return;
+	}
+	
+	if (request->timings != nullptr && request->timings->dnsEndUs == 0) { request->timings->dnsEndUs = nowUs; } //cached lookup
+	OpenLinuxHttpConn(manager, request);
+}
+
+void ProcessLinuxHttpDnsResults(LinuxHttpManager* manager)
+{
+	ScratchBegin(scratch);
+	LockMutex(&manager->dnsMutex, TIMEOUT_FOREVER);
+	uxx numResults = manager->dnsResults.length;
+	LinuxHttpDnsQuery** results = nullptr;
+	if (numResults > 0)
+	{
+		results = AllocArray(LinuxHttpDnsQuery*, scratch, numResults);
+		NotNull(results);
+		MyMemCopy(results, manager->dnsResults.items, sizeof(LinuxHttpDnsQuery*) * numResults);
+		VarArrayClear(&manager->dnsResults);
+	}
+	UnlockMutex(&manager->dnsMutex);
+	
+	u64 nowUs = SysGetTimeUs();
+	for (uxx rIndex = 0; rIndex < numResults; rIndex++)
+	{
+		LinuxHttpDnsQuery* query = results[rIndex];
+		LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, query->hostIndex);
+		bool succeeded = query->succeeded;
+		if (succeeded)
+		{
+			host->dnsState = LinuxHttpDnsState_Resolved;
+			host->resolvedTimeUs = nowUs;
+			MyMemCopy(&host->address, &query->address, sizeof(host->address));
+			host->addressLength = query->addressLength;
+		}
+		else { host->dnsState = LinuxHttpDnsState_Failed; } //the next request to this host will try again
+		FreeType(LinuxHttpDnsQuery, manager->arena, query);
+		
+		VarArrayLoop(&host->waitingRequests, wIndex)
+		{
+			LinuxHttpRequest* request = *VarArrayGet(LinuxHttpRequest*, &host->waitingRequests, wIndex);
+			if (request->timings != nullptr) { request->timings->dnsEndUs = nowUs; }
+			if (succeeded) { OpenLinuxHttpConn(manager, request); }
+			else { CompleteLinuxHttpRequest(manager, request, Result_Failure); }
+		}
+		VarArrayClear(&host->waitingRequests);
+	}
+	ScratchEnd(scratch);
+}
+
+// +--------------------------------------------------------------+
+// |                      Response Parsing                        |
+// +--------------------------------------------------------------+
+// Parses the status line and headers out of request->headerBytes and decides how the body is framed
+Result ParseLinuxHttpResponseHead(LinuxHttpRequest* request)
+{
+	Str8 head = MakeStr8(request->headerBytes.length, request->headerBytes.chars);
+	VarArrayClear(&request->responseHeaders);
+	bool isFirstLine = true;
+	bool isHttp10 = false;
+	bool hasContentLength = false;
+	bool isChunked = false;
+	bool sawKeepAlive = false;
+	uxx contentLength = 0;
+	request->connectionClose = false;
+	
+	uxx lineStart = 0;
+	for (uxx cIndex = 0; cIndex+1 < head.length; cIndex++)
+	{
+		if (head.chars[cIndex] != '\r' || head.chars[cIndex+1] != '\n') { continue; }
+		Str8 line = StrSlice(head, lineStart, cIndex);
+		lineStart = cIndex+2;
+		cIndex++;
+		if (line.length == 0) { break; }
+		
+		if (isFirstLine)
+		{
+			//"HTTP/1.1 200 OK"
+			isFirstLine = false;
+			if (line.length < 12 || !StrExactEquals(StrSlice(line, 0, 7), StrLit("HTTP/1."))) { return Result_InvalidSyntax; }
+			isHttp10 = (line.chars[7] == '0');
+			u16 statusCode = 0;
+			for (uxx dIndex = 9; dIndex < 12; dIndex++)
+			{
+				char digit = line.chars[dIndex];
+				if (digit < '0' || digit > '9') { return Result_InvalidSyntax; }
+				statusCode = (u16)(statusCode*10 + (digit - '0'));
+			}
+			request->statusCode = statusCode;
+			continue;
+		}
+		
+		uxx colonIndex = line.length;
+		for (uxx lIndex = 0; lIndex < line.length; lIndex++) { if (line.chars[lIndex] == ':') { colonIndex = lIndex; break; } }
+		if (colonIndex >= line.length) { return Result_InvalidSyntax; }
+		Str8Pair* header = VarArrayAdd(Str8Pair, &request->responseHeaders);
+		NotNull(header);
+		header->key = LinuxHttpTrimSpaces(StrSlice(line, 0, colonIndex));
+		header->value = LinuxHttpTrimSpaces(StrSliceFrom(line, colonIndex+1));
+		
+		if (StrAnyCaseEquals(header->key, StrLit("Content-Length")))
+		{
+			if (!TryParseUXX(header->value, &contentLength, nullptr)) { return Result_InvalidSyntax; }
+			hasContentLength = true;
+		}
+		else if (StrAnyCaseEquals(header->key, StrLit("Transfer-Encoding")))
+		{
+			//NOTE: chunked is always the last coding when present, anything before it (gzip etc.) is left for whoever reads the body
+			Str8 lastCoding = StrLit("chunked");
+			isChunked = (header->value.length >= lastCoding.length && StrAnyCaseEquals(StrSliceFrom(header->value, header->value.length - lastCoding.length), lastCoding));
+		}
+		else if (StrAnyCaseEquals(header->key, StrLit("Connection")))
+		{
+			if (StrAnyCaseEquals(header->value, StrLit("close"))) { request->connectionClose = true; }
+			else if (StrAnyCaseEquals(header->value, StrLit("keep-alive"))) { sawKeepAlive = true; }
+		}
+	}
+	if (isFirstLine) { return Result_InvalidSyntax; }
+	if (isHttp10 && !sawKeepAlive) { request->connectionClose = true; }
+	
+	bool hasNoBody = (request->isHeadRequest || request->statusCode < 200 || request->statusCode == 204 || request->statusCode == 304);
+	if (hasNoBody) { request->bodyMode = LinuxHttpBodyMode_None; }
+	else if (isChunked) { request->bodyMode = LinuxHttpBodyMode_Chunked; request->chunkState = LinuxHttpChunkState_Size; }
+	else if (hasContentLength) { request->bodyMode = (contentLength > 0) ? LinuxHttpBodyMode_ContentLength : LinuxHttpBodyMode_None; request->bodyRemaining = contentLength; }
+	else { request->bodyMode = LinuxHttpBodyMode_UntilClose; request->connectionClose = true; }
+	return Result_Success;
+}
+
+void DeliverLinuxHttpBodyBytes(LinuxHttpManager* manager, LinuxHttpRequest* request, Str8 bytes)
+{
+	if (bytes.length == 0) { return; }
+	request->numBodyBytes += bytes.length;
+	if (manager->dataCallback != nullptr) { manager->dataCallback(request->userPntr, request->responseHeaders.length, (const Str8Pair*)request->responseHeaders.items, bytes); }
+}
+
+bool TryParseLinuxHttpChunkSize(Str8 line, u64* sizeOut)
+{
+	u64 size = 0;
+	uxx numDigits = 0;
+	for (uxx cIndex = 0; cIndex < line.length; cIndex++)
+	{
+		char c = line.chars[cIndex];
+		u64 digitValue = 0;
+		if (c >= '0' && c <= '9') { digitValue = (u64)(c - '0'); }
+		else if (c >= 'a' && c <= 'f') { digitValue = (u64)(c - 'a' + 10); }
+		else if (c >= 'A' && c <= 'F') { digitValue = (u64)(c - 'A' + 10); }
+		else if (c == ';' || c == ' ' || c == '\t') { break; } //chunk extensions, which we ignore
+		else { return false; }
+		if (numDigits >= 15) { return false; }
+		size = (size << 4) | digitValue;
+		numDigits++;
+	}
+	if (numDigits == 0) { return false; }
+	*sizeOut = size;
+	return true;
+}
+
+// Returns the number of bytes consumed, or UINTXX_MAX if the chunk framing is broken
+uxx ConsumeLinuxHttpChunked(LinuxHttpManager* manager, LinuxHttpRequest* request, Str8 bytes)
+{
+	uxx index = 0;
+	while (index < bytes.length && request->chunkState != LinuxHttpChunkState_Done)
+	{
+		if (request->chunkState == LinuxHttpChunkState_Data)
+		{
+			uxx numDataBytes = bytes.length - index;
+			if (numDataBytes > request->bodyRemaining) { numDataBytes = (uxx)request->bodyRemaining; }
+			DeliverLinuxHttpBodyBytes(manager, request, StrSlice(bytes, index, index + numDataBytes));
+			request->bodyRemaining -= numDataBytes;
+			index += numDataBytes;
+			if (request->bodyRemaining == 0) { request->chunkState = LinuxHttpChunkState_DataEnd; }
+			continue;
+		}
+		
+		//Size, DataEnd and Trailers are all whole lines, which may be split across reads
+		char c = bytes.chars[index];
+		index++;
+		if (c != '\n')
+		{
+			if (request->chunkLine.length >= LINUX_HTTP_MAX_CHUNK_LINE_SIZE) { return UINTXX_MAX; }
+			LinuxHttpBufferAppend(manager->arena, &request->chunkLine, &c, 1);
+			continue;
+		}
+		Str8 line = MakeStr8(request->chunkLine.length, request->chunkLine.chars);
+		if (line.length > 0 && line.chars[line.length-1] == '\r') { line.length--; }
+		request->chunkLine.length = 0;
+		
+		if (request->chunkState == LinuxHttpChunkState_Size)
+		{
+			u64 chunkSize = 0;
+			if (!TryParseLinuxHttpChunkSize(line, &chunkSize)) { return UINTXX_MAX; }
+			request->bodyRemaining = chunkSize;
+			request->chunkState = (chunkSize > 0) ? LinuxHttpChunkState_Data : LinuxHttpChunkState_Trailers;
+		}
+		else if (request->chunkState == LinuxHttpChunkState_DataEnd)
+		{
+			if (line.length != 0) { return UINTXX_MAX; }
+			request->chunkState = LinuxHttpChunkState_Size;
+		}
+		else if (request->chunkState == LinuxHttpChunkState_Trailers)
+		{
+			if (line.length == 0) { request->chunkState = LinuxHttpChunkState_Done; }
+		}
+	}
+	return index;
+}
+
+// Returns false once the conn is done with this batch of bytes (the response finished or failed)
+bool HandleLinuxHttpReceivedBytes(LinuxHttpManager* manager, LinuxHttpConn* conn, Str8 bytes)
+{
+	LinuxHttpRequest* request = conn->request;
+	NotNull(request);
+	if (request->timings != nullptr && request->timings->firstByteUs == 0) { request->timings->firstByteUs = SysGetTimeUs(); }
+	
+	Str8 remaining = bytes;
+	while (!request->headersDone)
+	{
+		uxx searchStart = (request->headerBytes.length >= 3) ? request->headerBytes.length-3 : 0;
+		LinuxHttpBufferAppendStr(manager->arena, &request->headerBytes, remaining);
+		uxx headerEnd = 0; //index just past the blank line
+		for (uxx cIndex = searchStart; cIndex+4 <= request->headerBytes.length; cIndex++)
+		{
+			if (MyMemEquals(&request->headerBytes.chars[cIndex], "\r\n\r\n", 4)) { headerEnd = cIndex+4; break; }
+		}
+		if (headerEnd == 0)
+		{
+			if (request->headerBytes.length > LINUX_HTTP_MAX_HEADER_SIZE) { FailLinuxHttpConn(manager, conn, Result_InvalidSyntax); return false; }
+			return true;
+		}
+		
+		uxx numBodyBytes = request->headerBytes.length - headerEnd;
+		remaining = StrSliceFrom(remaining, remaining.length - numBodyBytes);
+		request->headerBytes.length = headerEnd;
+		Result parseResult = ParseLinuxHttpResponseHead(request);
+		if (parseResult != Result_Success) { FailLinuxHttpConn(manager, conn, parseResult); return false; }
+		if (request->statusCode >= 100 && request->statusCode < 200)
+		{
+			//NOTE: 100 Continue and friends are interim, the real response follows on the same connection
+			request->headerBytes.length = 0;
+			request->statusCode = 0;
+			VarArrayClear(&request->responseHeaders);
+			if (remaining.length == 0) { return true; }
+			continue;
+		}
+		request->headersDone = true;
+	}
+	
+	bool isComplete = false;
+	switch (request->bodyMode)
+	{
+		case LinuxHttpBodyMode_None: isComplete = true; break;
+		case LinuxHttpBodyMode_ContentLength:
+		{
+			uxx numBodyBytes = remaining.length;
+			if (numBodyBytes > request->bodyRemaining) { numBodyBytes = (uxx)request->bodyRemaining; }
+			DeliverLinuxHttpBodyBytes(manager, request, StrSlice(remaining, 0, numBodyBytes));
+			request->bodyRemaining -= numBodyBytes;
+			isComplete = (request->bodyRemaining == 0);
+			if (isComplete && numBodyBytes < remaining.length) { request->connectionClose = true; } //the server sent more than it said it would, don't trust this connection again
+		} break;
+		case LinuxHttpBodyMode_Chunked:
+		{
+			uxx numConsumed = ConsumeLinuxHttpChunked(manager, request, remaining);
+			if (numConsumed == UINTXX_MAX) { FailLinuxHttpConn(manager, conn, Result_InvalidSyntax); return false; }
+			isComplete = (request->chunkState == LinuxHttpChunkState_Done);
+			if (isComplete && numConsumed < remaining.length) { request->connectionClose = true; }
+		} break;
+		case LinuxHttpBodyMode_UntilClose: DeliverLinuxHttpBodyBytes(manager, request, remaining); break;
+		default: Assert(false); break;
+	}
+	
+	if (isComplete) { FinishLinuxHttpResponse(manager, conn); return false; }
+	return true;
+}
+
+// The server closed its end. That's only a clean finish for bodies that run until close
+void HandleLinuxHttpConnEof(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	LinuxHttpRequest* request = conn->request;
+	if (request == nullptr) { CloseLinuxHttpConn(manager, conn); }
+	else if (request->headersDone && request->bodyMode == LinuxHttpBodyMode_UntilClose) { FinishLinuxHttpResponse(manager, conn); }
+	else { FailLinuxHttpConn(manager, conn, Result_Failure); }
+}
+
+void DoLinuxHttpReceive(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	for (uxx readIndex = 0; readIndex < LINUX_HTTP_MAX_READS_PER_EVENT || LinuxHttpConnHasPendingBytes(manager, conn); readIndex++)
+	{
+		ixx numRead = LinuxHttpConnRead(manager, conn, manager->readBuffer, LINUX_HTTP_READ_BUFFER_SIZE);
+		if (numRead == LINUX_HTTP_IO_WOULD_BLOCK) { return; }
+		if (numRead < 0) { FailLinuxHttpConn(manager, conn, Result_Failure); return; }
+		if (numRead == 0) { HandleLinuxHttpConnEof(manager, conn); return; }
+		if (!HandleLinuxHttpReceivedBytes(manager, conn, MakeStr8((uxx)numRead, manager->readBuffer))) { return; }
+	}
+}
+
+void HandleLinuxHttpConnEvent(LinuxHttpManager* manager, LinuxHttpConn* conn, u32 events)
+{
+	switch (conn->state)
+	{
+		case LinuxHttpConnState_Connecting:
+		{
+			int socketError = 0;
+			socklen_t socketErrorSize = sizeof(socketError);
+			getsockopt(conn->fd, SOL_SOCKET, SO_ERROR, &socketError, &socketErrorSize);
+			if (socketError != 0)
+			{
+				LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+				PrintLine_W("Failed to connect to %.*s: %s", StrPrint(host->name), strerror(socketError));
+				FailLinuxHttpConn(manager, conn, Result_Failure);
+			}
+			else if (IsFlagSet(events, EPOLLOUT)) { OnLinuxHttpConnected(manager, conn); }
+		} break;
+		#if LINUX_HTTP_USE_OPENSSL
+		case LinuxHttpConnState_TlsHandshake: ContinueLinuxHttpTlsHandshake(manager, conn); break;
+		#endif
+		case LinuxHttpConnState_Sending: DoLinuxHttpSend(manager, conn); break;
+		case LinuxHttpConnState_Receiving: DoLinuxHttpReceive(manager, conn); break;
+		//NOTE: We never ask an idle connection for anything, so it only becomes readable when the server closes it
+		case LinuxHttpConnState_Idle: CloseLinuxHttpConn(manager, conn); break;
+		default: break;
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                           io_uring                           |
+// +--------------------------------------------------------------+
+u64 GetLinuxHttpUringUserData(LinuxHttpConn* conn, LinuxHttpUringOp op)
+{
+	DebugAssert(((u64)(uxx)conn & LINUX_HTTP_URING_OP_MASK) == 0);
+	return (u64)(uxx)conn | (u64)op;
+}
+
+void ArmLinuxHttpUringRecv(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	if (conn->uringRecvArmed) { return; }
+	QueueLinuxHttpUringOp(&manager->uring, IORING_OP_RECV, conn->fd, (u64)(uxx)conn->uringRecvBuffer, LINUX_HTTP_URING_RECV_SIZE, 0, GetLinuxHttpUringUserData(conn, LinuxHttpUringOp_Recv));
+	conn->numUringOps++;
+	conn->uringRecvArmed = true;
+}
+
+// Sends whatever is left of the request. Short sends just queue another one for the rest
+//NOTE: The upload body goes out of the file mapping directly, a piece at a time, after requestBytes is done
+void QueueLinuxHttpUringSend(LinuxHttpManager* manager, LinuxHttpConn* conn)
+{
+	LinuxHttpRequest* request = conn->request;
+	NotNull(request);
+	Assert(request->numBytesSent < GetLinuxHttpRequestSendLength(request));
+	u64 address = 0;
+	uxx length = 0;
+	if (request->numBytesSent < request->requestBytes.length)
+	{
+		address = (u64)(uxx)&request->requestBytes.chars[request->numBytesSent];
+		length = request->requestBytes.length - request->numBytesSent;
+	}
+	else
+	{
+		uxx bodyOffset = request->numBytesSent - request->requestBytes.length;
+		address = (u64)(uxx)&request->uploadMapping[bodyOffset];
+		length = request->uploadSize - bodyOffset;
+		if (length > LINUX_HTTP_UPLOAD_SEND_SIZE) { length = LINUX_HTTP_UPLOAD_SEND_SIZE; }
+	}
+	struct io_uring_sqe* sqe = QueueLinuxHttpUringOp(&manager->uring, IORING_OP_SEND, conn->fd, address, (u32)length, 0, GetLinuxHttpUringUserData(conn, LinuxHttpUringOp_Send));
+	sqe->msg_flags = MSG_NOSIGNAL;
+	conn->numUringOps++;
+	Assert(conn->uringSendRequest == nullptr);
+	conn->uringSendRequest = request;
+	request->numUringSends++;
+}
+
+// result is the cqe's res: bytes moved for Send/Recv, 0 for Connect, or -errno
+void HandleLinuxHttpUringCompletion(LinuxHttpManager* manager, LinuxHttpConn* conn, LinuxHttpUringOp op, i32 result)
+{
+	Assert(conn->numUringOps > 0);
+	conn->numUringOps--;
+	if (op == LinuxHttpUringOp_Recv) { conn->uringRecvArmed = false; }
+	if (op == LinuxHttpUringOp_Send)
+	{
+		//NOTE: Whatever happened to the request or conn in the meantime, the kernel is done reading its bytes now
+		NotNull(conn->uringSendRequest);
+		Assert(conn->uringSendRequest->numUringSends > 0);
+		conn->uringSendRequest->numUringSends--;
+		conn->uringSendRequest = nullptr;
+	}
+	if (conn->fd < 0) { return; } //closed while this was in flight, we were only waiting for it to come back
+	
+	switch (op)
+	{
+		case LinuxHttpUringOp_Connect:
+		{
+			if (result < 0)
+			{
+				LinuxHttpHost* host = VarArrayGet(LinuxHttpHost, &manager->hosts, conn->hostIndex);
+				PrintLine_W("Failed to connect to %.*s: %s", StrPrint(host->name), strerror(-result));
+				FailLinuxHttpConn(manager, conn, Result_Failure);
+			}
+			else { OnLinuxHttpConnected(manager, conn); }
+		} break;
+		
+		case LinuxHttpUringOp_Send:
+		{
+			if (conn->state != LinuxHttpConnState_Sending || conn->request == nullptr) { break; }
+			if (result < 0) { FailLinuxHttpConn(manager, conn, Result_Failure); break; }
+			LinuxHttpRequest* request = conn->request;
+			request->numBytesSent += (uxx)result;
+			if (request->numBytesSent < GetLinuxHttpRequestSendLength(request)) { QueueLinuxHttpUringSend(manager, conn); break; }
+			if (request->timings != nullptr) { request->timings->requestSentUs = SysGetTimeUs(); }
+			conn->state = LinuxHttpConnState_Receiving;
+		} break;
+		
+		case LinuxHttpUringOp_Recv:
+		{
+			if (result == -EINTR || result == -EAGAIN) { ArmLinuxHttpUringRecv(manager, conn); break; }
+			if (result < 0)
+			{
+				if (conn->request != nullptr) { FailLinuxHttpConn(manager, conn, Result_Failure); }
+				else { CloseLinuxHttpConn(manager, conn); }
+				break;
+			}
+			if (result == 0) { HandleLinuxHttpConnEof(manager, conn); break; }
+			//NOTE: An idle connection has no business sending us anything, don't trust it for the next request
+			if (conn->request == nullptr) { CloseLinuxHttpConn(manager, conn); break; }
+			HandleLinuxHttpReceivedBytes(manager, conn, MakeStr8((uxx)result, conn->uringRecvBuffer));
+			//NOTE: The recv stays armed for the life of the connection, including while it sits idle, so we notice the server closing it
+			if (conn->fd >= 0) { ArmLinuxHttpUringRecv(manager, conn); }
+		} break;
+		
+		default: Assert(false); break;
+	}
+}
+
+void ProcessLinuxHttpUringCompletions(LinuxHttpManager* manager)
+{
+	LinuxHttpUring* uring = &manager->uring;
+	while (true)
+	{
+		uxx numReaped = ReapLinuxHttpUring(uring);
+		for (uxx cIndex = 0; cIndex < numReaped; cIndex++)
+		{
+			struct io_uring_cqe* cqe = &uring->reaped[cIndex];
+			if (cqe->user_data == LINUX_HTTP_URING_TIMEOUT_USER_DATA) { uring->timeoutArmed = false; }
+			else if (cqe->user_data == LINUX_HTTP_URING_EPOLL_USER_DATA)
+			{
+				//NOTE: Something in the epoll set (the wakeFd or a TLS connection) is ready, pick the events up without blocking and let the normal loop handle them
+				uring->epollPollArmed = false;
+				if (manager->numReadyEvents == 0)
+				{
+					int numEvents = epoll_wait(manager->epollFd, &manager->readyEvents[0], LINUX_HTTP_MAX_EPOLL_EVENTS, 0);
+					manager->numReadyEvents = (numEvents > 0) ? (uxx)numEvents : 0;
+				}
+			}
+			else
+			{
+				LinuxHttpConn* conn = (LinuxHttpConn*)(uxx)(cqe->user_data & ~LINUX_HTTP_URING_OP_MASK);
+				LinuxHttpUringOp op = (LinuxHttpUringOp)(cqe->user_data & LINUX_HTTP_URING_OP_MASK);
+				HandleLinuxHttpUringCompletion(manager, conn, op, cqe->res);
+			}
+		}
+		if (numReaped < LINUX_HTTP_URING_MAX_REAP) { break; }
+	}
+}
+
+// +--------------------------------------------------------------+
+// |                          Manager                             |
+// +--------------------------------------------------------------+
+//NOTE: Every connection is a file descriptor and the default soft limit (usually 1024) is way below what a load run wants
+void RaiseLinuxFileDescriptorLimit()
+{
+	struct rlimit limit = ZEROED;
+	if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max)
+	{
+		limit.rlim_cur = limit.rlim_max;
+		if (setrlimit(RLIMIT_NOFILE, &limit) == 0) { PrintLine_D("Raised open file limit to %llu", (u64)limit.rlim_cur); }
+	}
+}
+
+void InitLinuxHttpManager(Arena* arena, LinuxHttpManager* manager, LinuxHttpDataCallback_f* dataCallback, bool preferIoUring)
+{
+	NotNull(arena);
+	NotNull(manager);
+	ClearPointer(manager);
+	manager->arena = arena;
+	manager->dataCallback = dataCallback;
+	manager->nextRequestId = 1;
+	InitVarArray(LinuxHttpConn*, &manager->conns, arena);
+	InitVarArray(LinuxHttpHost, &manager->hosts, arena);
+	InitVarArray(LinuxHttpRequest*, &manager->finishedRequests, arena);
+	InitVarArray(LinuxHttpConn*, &manager->closedConns, arena);
+	InitVarArray(LinuxHttpRequest*, &manager->releasedRequests, arena);
+	manager->readBuffer = AllocArray(char, arena, LINUX_HTTP_READ_BUFFER_SIZE);
+	NotNull(manager->readBuffer);
+	RaiseLinuxFileDescriptorLimit();
+	//NOTE: sendfile (uploads) has no MSG_NOSIGNAL equivalent, a peer that resets mid-upload would otherwise kill the whole process
+	signal(SIGPIPE, SIG_IGN);
+	
+	manager->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	Assert(manager->epollFd >= 0);
+	manager->wakeFd = eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC);
+	Assert(manager->wakeFd >= 0);
+	struct epoll_event wakeEvent = ZEROED;
+	wakeEvent.events = EPOLLIN;
+	wakeEvent.data.ptr = nullptr; //the only entry without a conn
+	int ctlResult = epoll_ctl(manager->epollFd, EPOLL_CTL_ADD, manager->wakeFd, &wakeEvent);
+	Assert(ctlResult == 0);
+	manager->uring.fd = -1;
+	if (preferIoUring)
+	{
+		if (InitLinuxHttpUring(&manager->uring, LINUX_HTTP_URING_ENTRIES)) { WriteLine_D("HTTP is using io_uring"); }
+		else { WriteLine_W("io_uring isn't usable on this kernel, HTTP is falling back to epoll"); }
+	}
+	
+	#if LINUX_HTTP_USE_OPENSSL
+	if (LoadLinuxHttpOpenSsl(&manager->openSsl))
+	{
+		manager->sslContext = manager->openSsl.SSL_CTX_new(manager->openSsl.TLS_client_method());
+		NotNull(manager->sslContext);
+		manager->openSsl.SSL_CTX_set_default_verify_paths(manager->sslContext);
+		manager->openSsl.SSL_CTX_set_verify(manager->sslContext, LINUX_SSL_VERIFY_PEER, nullptr);
+	}
+	else { WriteLine_W("Couldn't load libssl (OpenSSL 1.1 or newer), https requests will fail"); }
+	#endif
+	
+	InitMutex(&manager->dnsMutex);
+	InitVarArray(LinuxHttpDnsQuery*, &manager->dnsQueries, arena);
+	InitVarArray(LinuxHttpDnsQuery*, &manager->dnsResults, arena);
+	manager->dnsWorkFd = eventfd(0, EFD_CLOEXEC);
+	Assert(manager->dnsWorkFd >= 0);
+	bool startedThread = SysStartThread(&manager->dnsThread, LinuxHttpDnsThreadMain, (void*)manager);
+	Assert(startedThread);
+}
+
+//NOTE: Requests that haven't finished are dropped without their callback being called
+void FreeLinuxHttpManager(LinuxHttpManager* manager)
+{
+	NotNull(manager);
+	if (manager->arena == nullptr) { return; }
+	
+	LockMutex(&manager->dnsMutex, TIMEOUT_FOREVER);
+	manager->dnsStopRequested = true;
+	UnlockMutex(&manager->dnsMutex);
+	u64 increment = 1;
+	ssize_t writeResult = write(manager->dnsWorkFd, &increment, sizeof(increment));
+	UNUSED(writeResult);
+	SysJoinThread(&manager->dnsThread);
+	
+	while (manager->conns.length > 0)
+	{
+		LinuxHttpConn* conn = *VarArrayGet(LinuxHttpConn*, &manager->conns, manager->conns.length-1);
+		LinuxHttpRequest* request = conn->request;
+		conn->request = nullptr;
+		CloseLinuxHttpConn(manager, conn);
+		//NOTE: A send may still be reading the request's bytes, it gets freed with finishedRequests after the drain below
+		if (request != nullptr) { CompleteLinuxHttpRequest(manager, request, Result_Failure); }
+	}
+	if (manager->uring.enabled)
+	{
+		//NOTE: Let the ops we just shut down come back so nothing is left pointing into conn memory when we free it
+		u64 drainStartUs = SysGetTimeUs();
+		SubmitLinuxHttpUring(&manager->uring, 0);
+		while (true)
+		{
+			ProcessLinuxHttpUringCompletions(manager);
+			bool anyInFlight = false;
+			VarArrayLoop(&manager->closedConns, cIndex) { if ((*VarArrayGet(LinuxHttpConn*, &manager->closedConns, cIndex))->numUringOps > 0) { anyInFlight = true; break; } }
+			if (!anyInFlight || SysGetTimeUs() - drainStartUs >= 1000000) { break; }
+			SysSleepMs(1);
+		}
+		FreeLinuxHttpUring(&manager->uring);
+		VarArrayLoop(&manager->closedConns, cIndex)
+		{
+			LinuxHttpConn* conn = *VarArrayGet(LinuxHttpConn*, &manager->closedConns, cIndex);
+			if (conn->uringSendRequest != nullptr) { conn->uringSendRequest->numUringSends = 0; conn->uringSendRequest = nullptr; }
+			conn->numUringOps = 0;
+		}
+	}
+	VarArrayLoop(&manager->closedConns, cIndex) { FreeLinuxHttpConn(manager, *VarArrayGet(LinuxHttpConn*, &manager->closedConns, cIndex)); }
+	VarArrayLoop(&manager->finishedRequests, rIndex) { FreeLinuxHttpRequest(manager, *VarArrayGet(LinuxHttpRequest*, &manager->finishedRequests, rIndex)); }
+	VarArrayLoop(&manager->releasedRequests, rIndex) { FreeLinuxHttpRequest(manager, *VarArrayGet(LinuxHttpRequest*, &manager->releasedRequests, rIndex)); }
+	VarArrayLoop(&manager->hosts, hIndex)
+	{
+		VarArrayLoopGet(LinuxHttpHost, host, &manager->hosts, hIndex);
+		VarArrayLoop(&host->waitingRequests, wIndex) { FreeLinuxHttpRequest(manager, *VarArrayGet(LinuxHttpRequest*, &host->waitingRequests, wIndex)); }
+		FreeVarArray(&host->waitingRequests);
+		FreeVarArray(&host->idleConns);
+		FreeStr8(manager->arena, &host->name);
+	}
+	for (uxx qIndex = manager->dnsQueriesReadIndex; qIndex < manager->dnsQueries.length; qIndex++) { FreeType(LinuxHttpDnsQuery, manager->arena, *VarArrayGet(LinuxHttpDnsQuery*, &manager->dnsQueries, qIndex)); }
+	VarArrayLoop(&manager->dnsResults, rIndex) { FreeType(LinuxHttpDnsQuery, manager->arena, *VarArrayGet(LinuxHttpDnsQuery*, &manager->dnsResults, rIndex)); }
+	
+	FreeVarArray(&manager->conns);
+	FreeVarArray(&manager->closedConns);
+	FreeVarArray(&manager->finishedRequests);
+	FreeVarArray(&manager->releasedRequests);
+	FreeVarArray(&manager->hosts);
+	FreeVarArray(&manager->dnsQueries);
+	FreeVarArray(&manager->dnsResults);
+	FreeArray(char, manager->arena, LINUX_HTTP_READ_BUFFER_SIZE, manager->readBuffer);
+	#if LINUX_HTTP_USE_OPENSSL
+	if (manager->sslContext != nullptr) { manager->openSsl.SSL_CTX_free(manager->sslContext); }
+	if (manager->openSsl.libraryHandle != nullptr) { dlclose(manager->openSsl.libraryHandle); }
+	#endif
+	close(manager->dnsWorkFd);
+	close(manager->wakeFd);
+	close(manager->epollFd);
+	DestroyMutex(&manager->dnsMutex);
+	ClearPointer(manager);
+}
+
+// Same contract as OsMakeHttpRequest except args is only shallow copied (see LinuxHttpRequest) and completion is always
+// reported from a later UpdateLinuxHttpManager, even if the request fails right away. A non-empty uploadPath replaces the contentItems as the body
+u64 LinuxMakeHttpRequest(LinuxHttpManager* manager, const HttpRequestArgs* args, Str8 uploadPath, HttpTimings* timings, void* userPntr)
+{
+	NotNull(manager);
+	NotNull(args);
+	LinuxHttpRequest* request = AllocType(LinuxHttpRequest, manager->arena);
+	NotNull(request);
+	ClearPointer(request);
+	request->id = manager->nextRequestId;
+	manager->nextRequestId++;
+	MyMemCopy(&request->args, args, sizeof(HttpRequestArgs));
+	request->timings = timings;
+	request->userPntr = userPntr;
+	request->isHeadRequest = StrAnyCaseEquals(MakeStr8Nt(GetHttpVerbStr(args->verb)), StrLit("HEAD"));
+	InitVarArray(Str8Pair, &request->responseHeaders, manager->arena);
+	u64 result = request->id;
+	
+	HttpUrlParts urlParts = ZEROED;
+	if (!TryParseHttpUrl(args->urlStr, &urlParts))
+	{
+		PrintLine_W("Invalid URL \"%.*s\"", StrPrint(args->urlStr));
+		CompleteLinuxHttpRequest(manager, request, Result_InvalidSyntax);
+		return result;
+	}
+	#if LINUX_HTTP_USE_OPENSSL
+	bool canDoHttps = manager->openSsl.isLoaded;
+	#else
+	bool canDoHttps = false;
+	#endif
+	if (urlParts.isHttps && !canDoHttps)
+	{
+		PrintLine_W("Can't request \"%.*s\", https isn't supported without libssl (OpenSSL 1.1 or newer)", StrPrint(args->urlStr));
+		CompleteLinuxHttpRequest(manager, request, Result_NotImplemented);
+		return result;
+	}
+	if (!IsEmptyStr(uploadPath) && !TryOpenLinuxHttpUpload(request, uploadPath))
+	{
+		CompleteLinuxHttpRequest(manager, request, Result_FailedToReadFile);
+		return result;
+	}
+	request->hostIndex = FindOrAddLinuxHttpHost(manager, &urlParts);
+	BuildLinuxHttpRequestBytes(manager, request, &urlParts);
+	StartLinuxHttpRequest(manager, request);
+	return result;
+}
+
+// Closes the request's connection (or drops it from its host's DNS wait list) and completes it with error. The callback
+// comes at the end of the next UpdateLinuxHttpManager like any other. Returns false if the request isn't running (already finished)
+//NOTE: The connection is never reused, whatever it was in the middle of sending or receiving would confuse the next request
+bool LinuxAbortHttpRequest(LinuxHttpManager* manager, u64 requestId, Result error)
+{
+	NotNull(manager);
+	VarArrayLoop(&manager->conns, cIndex)
+	{
+		LinuxHttpConn* conn = *VarArrayGet(LinuxHttpConn*, &manager->conns, cIndex);
+		if (conn->request != nullptr && conn->request->id == requestId)
+		{
+			LinuxHttpRequest* request = conn->request;
+			conn->request = nullptr;
+			CloseLinuxHttpConn(manager, conn);
+			CompleteLinuxHttpRequest(manager, request, error);
+			return true;
+		}
+	}
+	VarArrayLoop(&manager->hosts, hIndex)
+	{
+		VarArrayLoopGet(LinuxHttpHost, host, &manager->hosts, hIndex);
+		VarArrayLoop(&host->waitingRequests, wIndex)
+		{
+			LinuxHttpRequest* request = *VarArrayGet(LinuxHttpRequest*, &host->waitingRequests, wIndex);
+			if (request->id == requestId)
+			{
+				VarArrayRemoveAt(LinuxHttpRequest*, &host->waitingRequests, wIndex);
+				CompleteLinuxHttpRequest(manager, request, error);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+// Blocks until a socket is ready, a DNS lookup finishes, LinuxWakeHttpManager is called, or timeoutMs passes.
+// The ready sockets are handled by the next UpdateLinuxHttpManager
+//NOTE: This only touches readyEvents and the uring, which nothing but the service thread looks at, so it's called without the service mutex held
+void WaitLinuxHttpManager(LinuxHttpManager* manager, int timeoutMs)
+{
+	NotNull(manager);
+	if (manager->numReadyEvents > 0) { return; }
+	if (manager->uring.enabled)
+	{
+		LinuxHttpUring* uring = &manager->uring;
+		if (!uring->epollPollArmed)
+		{
+			struct io_uring_sqe* sqe = QueueLinuxHttpUringOp(uring, IORING_OP_POLL_ADD, manager->epollFd, 0, 0, 0, LINUX_HTTP_URING_EPOLL_USER_DATA);
+			sqe->poll32_events = POLLIN;
+			uring->epollPollArmed = true;
+		}
+		if (!uring->timeoutArmed)
+		{
+			//NOTE: A count of 1 means the timeout also completes as soon as anything else does, so it never piles up
+			uring->timeout.tv_sec = timeoutMs / 1000;
+			uring->timeout.tv_nsec = (long long)(timeoutMs % 1000) * 1000000LL;
+			QueueLinuxHttpUringOp(uring, IORING_OP_TIMEOUT, -1, (u64)(uxx)&uring->timeout, 1, 1, LINUX_HTTP_URING_TIMEOUT_USER_DATA);
+			uring->timeoutArmed = true;
+		}
+		//NOTE: This is also where everything queued during the last update actually goes to the kernel, all in one syscall
+		SubmitLinuxHttpUring(uring, 1);
+		return;
+	}
+	int numEvents = epoll_wait(manager->epollFd, &manager->readyEvents[0], LINUX_HTTP_MAX_EPOLL_EVENTS, timeoutMs);
+	manager->numReadyEvents = (numEvents > 0) ? (uxx)numEvents : 0;
+}
+
+// Safe to call from any thread
+void LinuxWakeHttpManager(LinuxHttpManager* manager)
+{
+	u64 increment = 1;
+	ssize_t writeResult = write(manager->wakeFd, &increment, sizeof(increment));
+	UNUSED(writeResult);
+}
+
+void CloseExpiredLinuxHttpIdleConns(LinuxHttpManager* manager, u64 nowUs)
+{
+	VarArrayLoop(&manager->hosts, hIndex)
+	{
+		VarArrayLoopGet(LinuxHttpHost, host, &manager->hosts, hIndex);
+		//NOTE: idleConns is in the order they went idle, so we only ever have to look at the front
+		while (host->idleConns.length > 0)
+		{
+			LinuxHttpConn* oldestConn = *VarArrayGet(LinuxHttpConn*, &host->idleConns, 0);
+			if (nowUs - oldestConn->idleSinceUs < LINUX_HTTP_IDLE_TIMEOUT) { break; }
+			CloseLinuxHttpConn(manager, oldestConn);
+		}
+	}
+}
+
+void UpdateLinuxHttpManager(LinuxHttpManager* manager)
+{
+	NotNull(manager);
+	TracyCZoneN(Zone_Func, "UpdateLinuxHttpManager", true);
+	if (manager->uring.enabled) { ProcessLinuxHttpUringCompletions(manager); }
+	ProcessLinuxHttpDnsResults(manager);
+	
+	for (uxx eIndex = 0; eIndex < manager->numReadyEvents; eIndex++)
+	{
+		struct epoll_event* event = &manager->readyEvents[eIndex];
+		if (event->data.ptr == nullptr)
+		{
+			u64 counter = 0;
+			ssize_t readResult = read(manager->wakeFd, &counter, sizeof(counter));
+			UNUSED(readResult);
+			continue;
+		}
+		LinuxHttpConn* conn = (LinuxHttpConn*)event->data.ptr;
+		if (conn->fd < 0) { continue; } //closed earlier in this batch
+		HandleLinuxHttpConnEvent(manager, conn, event->events);
+	}
+	manager->numReadyEvents = 0;
+	CloseExpiredLinuxHttpIdleConns(manager, SysGetTimeUs());
+	
+	VarArrayLoop(&manager->finishedRequests, rIndex)
+	{
+		LinuxHttpRequest* request = *VarArrayGet(LinuxHttpRequest*, &manager->finishedRequests, rIndex);
+		HttpRequest report = ZEROED;
+		report.id = request->id;
+		MyMemCopy(&report.args, &request->args, sizeof(HttpRequestArgs));
+		report.state = (request->error == Result_Success) ? HttpRequestState_Success : HttpRequestState_Failure;
+		report.error = request->error;
+		report.statusCode = request->statusCode;
+		report.numResponseHeaders = request->responseHeaders.length;
+		report.responseHeaders = (Str8Pair*)request->responseHeaders.items;
+		//NOTE: report.responseBytes stays empty, the body already went out through dataCallback
+		if (request->args.callback != nullptr) { request->args.callback(&report); }
+		if (request->numUringSends > 0)
+		{
+			//NOTE: Aborted (or answered) mid-send, the kernel may still be reading requestBytes or uploadMapping
+			LinuxHttpRequest** releasedSpace = VarArrayAdd(LinuxHttpRequest*, &manager->releasedRequests);
+			NotNull(releasedSpace);
+			*releasedSpace = request;
+		}
+		else { FreeLinuxHttpRequest(manager, request); }
+	}
+	VarArrayClear(&manager->finishedRequests);
+	for (uxx rIndex = manager->releasedRequests.length; rIndex > 0; rIndex--)
+	{
+		LinuxHttpRequest* request = *VarArrayGet(LinuxHttpRequest*, &manager->releasedRequests, rIndex-1);
+		if (request->numUringSends > 0) { continue; } //freed once its last send comes back
+		FreeLinuxHttpRequest(manager, request);
+		VarArrayRemoveAt(LinuxHttpRequest*, &manager->releasedRequests, rIndex-1);
+	}
+	
+	for (uxx cIndex = manager->closedConns.length; cIndex > 0; cIndex--)
+	{
+		LinuxHttpConn* conn = *VarArrayGet(LinuxHttpConn*, &manager->closedConns, cIndex-1);
+		if (conn->numUringOps > 0) { continue; } //freed once its last op comes back
+		FreeLinuxHttpConn(manager, conn);
+		VarArrayRemoveAt(LinuxHttpConn*, &manager->closedConns, cIndex-1);
+	}
+	TracyCZoneEnd(Zone_Func);
+}
+
+#endif //HTTP_USE_LINUX_BACKEND
@@ -0,0 +1,330 @@
+/*
+File:   platform_http_linux.h
+Date:   10\16\2026
+*/
+
+#ifndef _PLATFORM_HTTP_LINUX_H
+#define _PLATFORM_HTTP_LINUX_H
+
+// PigCore's HttpRequestManager is built on WinHTTP, so on Linux the HttpService drives our own sockets instead (see platform_http_linux.c)
+#define HTTP_USE_LINUX_BACKEND (BUILD_WITH_HTTP && TARGET_IS_LINUX)
+// https goes through OpenSSL's libssl, which is loaded when the LinuxHttpManager starts rather than linked (see LoadLinuxHttpOpenSsl).
+// Where it isn't installed (or this is set to 0) the Linux backend only speaks plain http:// and https requests fail with Result_NotImplemented
+#ifndef LINUX_HTTP_USE_OPENSSL
+#define LINUX_HTTP_USE_OPENSSL 1
+#endif
+
+#if HTTP_USE_LINUX_BACKEND
+
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <linux/io_uring.h>
+#if LINUX_HTTP_USE_OPENSSL
+#include <dlfcn.h>
+#endif
+
+#if LINUX_HTTP_USE_OPENSSL
+// The handful of libssl (and libcrypto) functions we use, with OpenSSL's own names. We never include its headers, the
+// types are opaque and the constants below have been stable since 1.1.0, which is also the oldest version with TLS_client_method
+typedef plex ssl_st LinuxSsl;
+typedef plex ssl_ctx_st LinuxSslContext;
+typedef plex ssl_method_st LinuxSslMethod;
+#define LINUX_SSL_ERROR_WANT_READ           2
+#define LINUX_SSL_ERROR_WANT_WRITE          3
+#define LINUX_SSL_ERROR_ZERO_RETURN         6
+#define LINUX_SSL_VERIFY_PEER               1
+#define LINUX_SSL_CTRL_SET_TLSEXT_HOSTNAME  55 //SSL_set_tlsext_host_name is a macro over SSL_ctrl
+#define LINUX_SSL_TLSEXT_NAMETYPE_HOST_NAME 0
+
+typedef plex LinuxHttpOpenSsl LinuxHttpOpenSsl;
+plex LinuxHttpOpenSsl
+{
+	bool isLoaded;
+	void* libraryHandle;
+	const LinuxSslMethod* (*TLS_client_method)(void);
+	LinuxSslContext* (*SSL_CTX_new)(const LinuxSslMethod* method);
+	void (*SSL_CTX_free)(LinuxSslContext* context);
+	int (*SSL_CTX_set_default_verify_paths)(LinuxSslContext* context);
+	void (*SSL_CTX_set_verify)(LinuxSslContext* context, int mode, void* callback);
+	LinuxSsl* (*SSL_new)(LinuxSslContext* context);
+	void (*SSL_free)(LinuxSsl* ssl);
+	int (*SSL_set_fd)(LinuxSsl* ssl, int fd);
+	long (*SSL_ctrl)(LinuxSsl* ssl, int command, long larg, void* parg);
+	int (*SSL_set1_host)(LinuxSsl* ssl, const char* hostName);
+	int (*SSL_connect)(LinuxSsl* ssl);
+	int (*SSL_read)(LinuxSsl* ssl, void* buffer, int bufferSize);
+	int (*SSL_write)(LinuxSsl* ssl, const void* bytes, int numBytes);
+	int (*SSL_get_error)(const LinuxSsl* ssl, int returnCode);
+	int (*SSL_pending)(const LinuxSsl* ssl);
+	unsigned long (*ERR_get_error)(void);
+	const char* (*ERR_reason_error_string)(unsigned long error);
+};
+#endif //LINUX_HTTP_USE_OPENSSL
+
+// void LinuxHttpDataCallback(void* userPntr, uxx numResponseHeaders, const Str8Pair* responseHeaders, Str8 bytes)
+#define LINUX_HTTP_DATA_CALLBACK_DEF(functionName) void functionName(void* userPntr, uxx numResponseHeaders, const Str8Pair* responseHeaders, Str8 bytes)
+typedef LINUX_HTTP_DATA_CALLBACK_DEF(LinuxHttpDataCallback_f);
+
+typedef enum LinuxHttpDnsState LinuxHttpDnsState;
+enum LinuxHttpDnsState
+{
+	LinuxHttpDnsState_None = 0,
+	LinuxHttpDnsState_Resolving,
+	LinuxHttpDnsState_Resolved,
+	LinuxHttpDnsState_Failed,
+	LinuxHttpDnsState_Count,
+};
+const char* GetLinuxHttpDnsStateStr(LinuxHttpDnsState enumValue)
+{
+	switch (enumValue)
+	{
+		case LinuxHttpDnsState_None:      return "None";
+		case LinuxHttpDnsState_Resolving: return "Resolving";
+		case LinuxHttpDnsState_Resolved:  return "Resolved";
+		case LinuxHttpDnsState_Failed:    return "Failed";
+		default: return UNKNOWN_STR;
+	}
+}
+
+typedef enum LinuxHttpConnState LinuxHttpConnState;
+enum LinuxHttpConnState
+{
+	LinuxHttpConnState_None = 0,
+	LinuxHttpConnState_Connecting,
+	LinuxHttpConnState_TlsHandshake,
+	LinuxHttpConnState_Sending,
+	LinuxHttpConnState_Receiving,
+	LinuxHttpConnState_Idle, //open keep-alive connection sitting in its host's pool
+	LinuxHttpConnState_Count,
+};
+const char* GetLinuxHttpConnStateStr(LinuxHttpConnState enumValue)
+{
+	switch (enumValue)
+	{
+		case LinuxHttpConnState_None:         return "None";
+		case LinuxHttpConnState_Connecting:   return "Connecting";
+		case LinuxHttpConnState_TlsHandshake: return "TlsHandshake";
+		case LinuxHttpConnState_Sending:      return "Sending";
+		case LinuxHttpConnState_Receiving:    return "Receiving";
+		case LinuxHttpConnState_Idle:         return "Idle";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Stored in the low bits of each submission's user_data, the rest is the LinuxHttpConn pointer
+typedef enum LinuxHttpUringOp LinuxHttpUringOp;
+enum LinuxHttpUringOp
+{
+	LinuxHttpUringOp_None = 0,
+	LinuxHttpUringOp_Connect,
+	LinuxHttpUringOp_Send,
+	LinuxHttpUringOp_Recv,
+	LinuxHttpUringOp_Count,
+};
+const char* GetLinuxHttpUringOpStr(LinuxHttpUringOp enumValue)
+{
+	switch (enumValue)
+	{
+		case LinuxHttpUringOp_None:    return "None";
+		case LinuxHttpUringOp_Connect: return "Connect";
+		case LinuxHttpUringOp_Send:    return "Send";
+		case LinuxHttpUringOp_Recv:    return "Recv";
+		default: return UNKNOWN_STR;
+	}
+}
+#define LINUX_HTTP_URING_OP_MASK           0x07ULL
+#define LINUX_HTTP_URING_TIMEOUT_USER_DATA 0ULL //no conn pointer is ever this small
+#define LINUX_HTTP_URING_EPOLL_USER_DATA   8ULL
+
+typedef enum LinuxHttpBodyMode LinuxHttpBodyMode;
+enum LinuxHttpBodyMode
+{
+	LinuxHttpBodyMode_None = 0, //HEAD, 1xx, 204 and 304 responses
+	LinuxHttpBodyMode_ContentLength,
+	LinuxHttpBodyMode_Chunked,
+	LinuxHttpBodyMode_UntilClose,
+	LinuxHttpBodyMode_Count,
+};
+const char* GetLinuxHttpBodyModeStr(LinuxHttpBodyMode enumValue)
+{
+	switch (enumValue)
+	{
+		case LinuxHttpBodyMode_None:          return "None";
+		case LinuxHttpBodyMode_ContentLength: return "ContentLength";
+		case LinuxHttpBodyMode_Chunked:       return "Chunked";
+		case LinuxHttpBodyMode_UntilClose:    return "UntilClose";
+		default: return UNKNOWN_STR;
+	}
+}
+
+typedef enum LinuxHttpChunkState LinuxHttpChunkState;
+enum LinuxHttpChunkState
+{
+	LinuxHttpChunkState_Size = 0,
+	LinuxHttpChunkState_Data,
+	LinuxHttpChunkState_DataEnd, //the \r\n after each chunk's data
+	LinuxHttpChunkState_Trailers,
+	LinuxHttpChunkState_Done,
+	LinuxHttpChunkState_Count,
+};
+
+// A growable byte buffer, memory comes from the LinuxHttpManager's arena
+typedef plex LinuxHttpBuffer LinuxHttpBuffer;
+plex LinuxHttpBuffer
+{
+	uxx length;
+	uxx capacity;
+	char* chars;
+};
+
+typedef plex LinuxHttpRequest LinuxHttpRequest;
+plex LinuxHttpRequest
+{
+	u64 id;
+	//NOTE: This is a shallow copy, the strings must live until args.callback is called (the HttpService's HttpJob owns them)
+	HttpRequestArgs args;
+	HttpTimings* timings; //optional, filled in as each phase finishes
+	void* userPntr; //passed to the manager's dataCallback
+	uxx hostIndex;
+	bool isHeadRequest;
+	bool retriedStaleConnection;
+	Result error; //filled in when the request completes
+	LinuxHttpBuffer requestBytes;
+	uxx numBytesSent; //counts requestBytes and then the upload body
+	u32 numUringSends; //in flight and pointing into requestBytes or uploadMapping, the request can't be freed until these complete
+	
+	//NOTE: Only used for uploads. The file is mmapped once and sent straight out of the page cache (sendfile, or
+	// send/SSL_write from the mapping) so a multi-GB body never gets copied into requestBytes
+	bool hasUpload;
+	int uploadFd;
+	u8* uploadMapping; //nullptr for an empty file. Not unmapped until numUringSends is 0, a uring send reads straight out of it
+	uxx uploadSize;
+	
+	LinuxHttpBuffer headerBytes; //everything up to and including the blank line
+	bool headersDone;
+	u16 statusCode;
+	VarArray responseHeaders; //Str8Pair, slices of headerBytes
+	bool connectionClose;
+	LinuxHttpBodyMode bodyMode;
+	u64 bodyRemaining; //ContentLength: bytes left in the body, Chunked: bytes left in the current chunk
+	LinuxHttpChunkState chunkState;
+	LinuxHttpBuffer chunkLine;
+	uxx numBodyBytes;
+};
+
+typedef plex LinuxHttpConn LinuxHttpConn;
+plex LinuxHttpConn
+{
+	int fd;
+	uxx connIndex; //index in manager->conns, kept up to date so removal can swap with the last entry
+	LinuxHttpConnState state;
+	uxx hostIndex;
+	u32 epollEvents; //what we are currently registered for
+	bool isReused;
+	u64 idleSinceUs;
+	uxx numRequestsServed;
+	LinuxHttpRequest* request; //nullptr while Idle
+	
+	//NOTE: These are only used when usesUring. A uring conn always has a recv in flight once it's connected (even while Idle, that's how we notice the server closing it)
+	bool usesUring;
+	u32 numUringOps; //in flight, the conn can't be freed until these all complete
+	bool uringRecvArmed;
+	LinuxHttpRequest* uringSendRequest; //whose bytes the in-flight send points into, this can outlive conn->request
+	char* uringRecvBuffer; //LINUX_HTTP_URING_RECV_SIZE, each conn needs its own since many recvs are in flight at once
+	struct sockaddr_storage address; //the kernel reads this when the connect is submitted, which may be after the hosts array moves
+	socklen_t addressLength;
+	#if LINUX_HTTP_USE_OPENSSL
+	LinuxSsl* ssl;
+	#endif
+};
+
+// Only ever touched on the service thread. The resolver thread works off of LinuxHttpDnsQuery copies
+typedef plex LinuxHttpHost LinuxHttpHost;
+plex LinuxHttpHost
+{
+	Str8 name; //without port or brackets, this is what goes to getaddrinfo and the Host header
+	u16 port;
+	bool isHttps;
+	LinuxHttpDnsState dnsState;
+	u64 resolvedTimeUs;
+	struct sockaddr_storage address;
+	socklen_t addressLength;
+	VarArray idleConns; //LinuxHttpConn*, most recently used last
+	VarArray waitingRequests; //LinuxHttpRequest*, waiting on DNS
+};
+
+typedef plex LinuxHttpDnsQuery LinuxHttpDnsQuery;
+plex LinuxHttpDnsQuery
+{
+	uxx hostIndex;
+	char nameNt[256];
+	u16 port;
+	bool succeeded;
+	struct sockaddr_storage address;
+	socklen_t addressLength;
+};
+
+// The rings shared with the kernel (mapped in InitLinuxHttpUring) plus the bookkeeping we need to fill and drain them
+typedef plex LinuxHttpUring LinuxHttpUring;
+plex LinuxHttpUring
+{
+	bool enabled;
+	int fd;
+	u32 numSqEntries;
+	u8* sqRingPntr;
+	uxx sqRingSize;
+	u8* cqRingPntr; //same as sqRingPntr when the kernel has IORING_FEAT_SINGLE_MMAP
+	uxx cqRingSize;
+	struct io_uring_sqe* sqes;
+	uxx sqesSize;
+	u32* sqHead;
+	u32* sqTail;
+	u32* sqMask;
+	u32* sqArray;
+	u32* cqHead;
+	u32* cqTail;
+	u32* cqMask;
+	struct io_uring_cqe* cqes;
+	
+	u32 numUnsubmitted;
+	bool timeoutArmed;
+	bool epollPollArmed; //TLS connections and the wakeFd still live in the epoll set, we poll the epoll fd itself through the ring
+	struct __kernel_timespec timeout;
+	struct io_uring_cqe reaped[LINUX_HTTP_URING_MAX_REAP];
+};
+
+typedef plex LinuxHttpManager LinuxHttpManager;
+plex LinuxHttpManager
+{
+	Arena* arena;
+	int epollFd;
+	int wakeFd; //eventfd in the epoll set, written to from other threads to cut a wait short
+	u64 nextRequestId;
+	LinuxHttpDataCallback_f* dataCallback;
+	VarArray conns; //LinuxHttpConn*
+	VarArray hosts; //LinuxHttpHost
+	VarArray finishedRequests; //LinuxHttpRequest*, callbacks are deferred to the end of UpdateLinuxHttpManager so they never run inside LinuxMakeHttpRequest
+	VarArray closedConns; //LinuxHttpConn*, freed at the end of UpdateLinuxHttpManager since readyEvents may still point at them
+	VarArray releasedRequests; //LinuxHttpRequest*, already reported but a uring send still points into them, freed once numUringSends hits 0
+	char* readBuffer; //shared by every connection, bytes are consumed before the next read
+	uxx numReadyEvents;
+	struct epoll_event readyEvents[LINUX_HTTP_MAX_EPOLL_EVENTS];
+	LinuxHttpUring uring; //only used when uring.enabled (--httpIo=uring)
+	#if LINUX_HTTP_USE_OPENSSL
+	LinuxHttpOpenSsl openSsl; //openSsl.isLoaded is false when libssl couldn't be found
+	LinuxSslContext* sslContext;
+	#endif
+	
+	//NOTE: getaddrinfo blocks, so lookups happen on their own thread. Everything below is protected by dnsMutex
+	Mutex dnsMutex;
+	SysThread dnsThread;
+	int dnsWorkFd; //eventfd the resolver thread blocks on
+	bool dnsStopRequested;
+	VarArray dnsQueries; //LinuxHttpDnsQuery*
+	uxx dnsQueriesReadIndex;
+	VarArray dnsResults; //LinuxHttpDnsQuery*
+};
+
+#endif //HTTP_USE_LINUX_BACKEND
+
+#endif //  _PLATFORM_HTTP_LINUX_H
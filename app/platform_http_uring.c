@@ -0,0 +1,164 @@
+/*
+File:   platform_http_uring.c
+Date:   10\16\2026
+Description:
+	** Holds the raw io_uring plumbing for the LinuxHttpManager: setting up and mapping
+	** the rings, queueing submissions and reaping completions. We talk to the kernel
+	** through the io_uring_setup/enter/register syscalls directly rather than pulling
+	** in liburing. Everything queued during an update goes to the kernel in a single
+	** io_uring_enter when the service thread goes to wait, and completions are copied
+	** out in bulk at the top of the next update (see platform_http_linux.c)
+*/
+
+#if HTTP_USE_LINUX_BACKEND
+
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <errno.h>
+#include <string.h>
+
+int LinuxUringSetup(u32 numEntries, struct io_uring_params* params) { return (int)syscall(__NR_io_uring_setup, numEntries, params); }
+int LinuxUringEnter(int fd, u32 numToSubmit, u32 minComplete, u32 flags) { return (int)syscall(__NR_io_uring_enter, fd, numToSubmit, minComplete, flags, nullptr, 0); }
+int LinuxUringRegister(int fd, u32 opcode, void* arg, u32 numArgs) { return (int)syscall(__NR_io_uring_register, fd, opcode, arg, numArgs); }
+
+void FreeLinuxHttpUring(LinuxHttpUring* uring)
+{
+	NotNull(uring);
+	if (uring->sqes != nullptr) { munmap(uring->sqes, uring->sqesSize); }
+	if (uring->cqRingPntr != nullptr && uring->cqRingPntr != uring->sqRingPntr) { munmap(uring->cqRingPntr, uring->cqRingSize); }
+	if (uring->sqRingPntr != nullptr) { munmap(uring->sqRingPntr, uring->sqRingSize); }
+	if (uring->fd >= 0) { close(uring->fd); }
+	ClearPointer(uring);
+	uring->fd = -1;
+}
+
+void* MapLinuxHttpUring(int fd, uxx size, u64 offset)
+{
+	void* result = mmap(nullptr, size, PROT_READ|PROT_WRITE, MAP_SHARED|MAP_POPULATE, fd, (off_t)offset);
+	return (result != MAP_FAILED) ? result : nullptr;
+}
+
+// Returns false (leaving the uring disabled) when the kernel doesn't have io_uring or is missing one of the ops we use
+bool InitLinuxHttpUring(LinuxHttpUring* uring, u32 numEntries)
+{
+	NotNull(uring);
+	ClearPointer(uring);
+	uring->fd = -1;
+	
+	struct io_uring_params params = ZEROED;
+	int fd = LinuxUringSetup(numEntries, &params);
+	if (fd < 0) { PrintLine_W("io_uring_setup failed: %s", strerror(errno)); return false; }
+	uring->fd = fd;
+	
+	//NOTE: Sockets (CONNECT/SEND/RECV) only showed up in 5.6, plenty of kernels have io_uring but can't do any of this with it
+	u8 probeSpace[sizeof(struct io_uring_probe) + 256*sizeof(struct io_uring_probe_op)] __attribute__((aligned(8)));
+	MyMemSet(&probeSpace[0], 0x00, sizeof(probeSpace));
+	struct io_uring_probe* probe = (struct io_uring_probe*)&probeSpace[0];
+	if (LinuxUringRegister(fd, IORING_REGISTER_PROBE, probe, 256) < 0)
+	{
+		PrintLine_W("io_uring probe failed: %s", strerror(errno));
+		FreeLinuxHttpUring(uring);
+		return false;
+	}
+	u8 requiredOps[] = { IORING_OP_CONNECT, IORING_OP_SEND, IORING_OP_RECV, IORING_OP_POLL_ADD, IORING_OP_TIMEOUT };
+	for (uxx oIndex = 0; oIndex < ArrayCount(requiredOps); oIndex++)
+	{
+		u8 opcode = requiredOps[oIndex];
+		if (opcode > probe->last_op || !IsFlagSet(probe->ops[opcode].flags, IO_URING_OP_SUPPORTED))
+		{
+			PrintLine_W("io_uring doesn't support opcode %u", (unsigned int)opcode);
+			FreeLinuxHttpUring(uring);
+			return false;
+		}
+	}
+	
+	uring->numSqEntries = params.sq_entries;
+	uring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(u32);
+	uring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	uring->sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	bool isSingleMmap = IsFlagSet(params.features, IORING_FEAT_SINGLE_MMAP);
+	if (isSingleMmap)
+	{
+		if (uring->cqRingSize > uring->sqRingSize) { uring->sqRingSize = uring->cqRingSize; }
+		uring->cqRingSize = uring->sqRingSize;
+	}
+	uring->sqRingPntr = (u8*)MapLinuxHttpUring(fd, uring->sqRingSize, IORING_OFF_SQ_RING);
+	uring->cqRingPntr = isSingleMmap ? uring->sqRingPntr : (u8*)MapLinuxHttpUring(fd, uring->cqRingSize, IORING_OFF_CQ_RING);
+	uring->sqes = (struct io_uring_sqe*)MapLinuxHttpUring(fd, uring->sqesSize, IORING_OFF_SQES);
+	if (uring->sqRingPntr == nullptr || uring->cqRingPntr == nullptr || uring->sqes == nullptr)
+	{
+		PrintLine_W("Failed to map io_uring rings: %s", strerror(errno));
+		FreeLinuxHttpUring(uring);
+		return false;
+	}
+	
+	uring->sqHead = (u32*)(uring->sqRingPntr + params.sq_off.head);
+	uring->sqTail = (u32*)(uring->sqRingPntr + params.sq_off.tail);
+	uring->sqMask = (u32*)(uring->sqRingPntr + params.sq_off.ring_mask);
+	uring->sqArray = (u32*)(uring->sqRingPntr + params.sq_off.array);
+	uring->cqHead = (u32*)(uring->cqRingPntr + params.cq_off.head);
+	uring->cqTail = (u32*)(uring->cqRingPntr + params.cq_off.tail);
+	uring->cqMask = (u32*)(uring->cqRingPntr + params.cq_off.ring_mask);
+	uring->cqes = (struct io_uring_cqe*)(uring->cqRingPntr + params.cq_off.cqes);
+	uring->enabled = true;
+	return true;
+}
+
+// Hands everything queued so far to the kernel. With minComplete > 0 this also blocks until that many completions are ready
+void SubmitLinuxHttpUring(LinuxHttpUring* uring, u32 minComplete)
+{
+	NotNull(uring);
+	if (uring->numUnsubmitted == 0 && minComplete == 0) { return; }
+	u32 flags = (minComplete > 0) ? IORING_ENTER_GETEVENTS : 0;
+	int enterResult = LinuxUringEnter(uring->fd, uring->numUnsubmitted, minComplete, flags);
+	if (enterResult >= 0) { uring->numUnsubmitted -= ((u32)enterResult < uring->numUnsubmitted) ? (u32)enterResult : uring->numUnsubmitted; }
+	else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) { PrintLine_W("io_uring_enter failed: %s", strerror(errno)); }
+}
+
+// The returned sqe can still be tweaked (flags, poll events, etc.) until the next SubmitLinuxHttpUring
+struct io_uring_sqe* QueueLinuxHttpUringOp(LinuxHttpUring* uring, u8 opcode, int fd, u64 address, u32 length, u64 offset, u64 userData)
+{
+	NotNull(uring);
+	Assert(uring->enabled);
+	u32 tail = *uring->sqTail;
+	u32 head = __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+	if (tail - head >= uring->numSqEntries)
+	{
+		//NOTE: The submission queue is full, flush it now rather than waiting for the end of the update
+		SubmitLinuxHttpUring(uring, 0);
+		head = __atomic_load_n(uring->sqHead, __ATOMIC_ACQUIRE);
+		Assert(tail - head < uring->numSqEntries);
+	}
+	u32 index = tail & *uring->sqMask;
+	struct io_uring_sqe* sqe = &uring->sqes[index];
+	MyMemSet(sqe, 0x00, sizeof(struct io_uring_sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->addr = address;
+	sqe->len = length;
+	sqe->off = offset;
+	sqe->user_data = userData;
+	uring->sqArray[index] = index;
+	__atomic_store_n(uring->sqTail, tail+1, __ATOMIC_RELEASE);
+	uring->numUnsubmitted++;
+	return sqe;
+}
+
+// Copies completions out of the ring (up to LINUX_HTTP_URING_MAX_REAP) into uring->reaped so handling them is free to queue more work
+uxx ReapLinuxHttpUring(LinuxHttpUring* uring)
+{
+	NotNull(uring);
+	u32 head = *uring->cqHead;
+	u32 tail = __atomic_load_n(uring->cqTail, __ATOMIC_ACQUIRE);
+	uxx numReaped = 0;
+	while (head != tail && numReaped < LINUX_HTTP_URING_MAX_REAP)
+	{
+		MyMemCopy(&uring->reaped[numReaped], &uring->cqes[head & *uring->cqMask], sizeof(struct io_uring_cqe));
+		numReaped++;
+		head++;
+	}
+	__atomic_store_n(uring->cqHead, head, __ATOMIC_RELEASE);
+	return numReaped;
+}
+
+#endif //HTTP_USE_LINUX_BACKEND
@@ -12,10 +12,217 @@ struct PlatformInfo
 {
 	Arena* platformStdHeap;
 	Arena* platformStdHeapAllowFreeWithoutSize;
-	#if BUILD_WITH_HTTP
-	HttpRequestManager* http;
-	#endif
+	uxx historyMemoryBudget; //bytes, --historyMemory=MB
+};
+
+//NOTE: The timing types live outside BUILD_WITH_HTTP since HistoryItems save and load them either way
+//
+// SysGetTimeUs() timestamps for the points between each phase of a request, 0 means that point wasn't observed.
+// The HttpService always fills queued, start, firstByte and finish. The rest depend on what the backend can see.
+// WinHTTP does report them through its status callback (RESOLVING_NAME, CONNECTING_TO_SERVER, SENDING_REQUEST, etc.) but
+// PigCore's HttpRequestManager doesn't pass those on, and only hands us the body when it finishes, so on Windows only
+// queued, start and finish are real and firstByte is stamped at finish. A backend that reuses a connection should set
+// dnsEnd/connectEnd/tlsEnd to start, not leave them 0
+typedef plex HttpTimings HttpTimings;
+plex HttpTimings
+{
+	u64 queuedUs; //MakeHttpRequest was called
+	u64 startUs; //left the host queue and was handed to the backend
+	u64 dnsEndUs;
+	u64 connectEndUs;
+	u64 tlsEndUs;
+	u64 requestSentUs;
+	u64 firstByteUs;
+	u64 finishUs;
+};
+
+typedef enum HttpPhase HttpPhase;
+enum HttpPhase
+{
+	HttpPhase_Queue = 0,
+	HttpPhase_Dns,
+	HttpPhase_Connect,
+	HttpPhase_Tls,
+	HttpPhase_Send,
+	HttpPhase_Wait, //request sent until the first response byte, i.e. server think time
+	HttpPhase_Download,
+	HttpPhase_Count,
+};
+SYS_HELPER_DEF const char* GetHttpPhaseStr(HttpPhase enumValue)
+{
+	switch (enumValue)
+	{
+		case HttpPhase_Queue:    return "Queue";
+		case HttpPhase_Dns:      return "DNS";
+		case HttpPhase_Connect:  return "Connect";
+		case HttpPhase_Tls:      return "TLS";
+		case HttpPhase_Send:     return "Send";
+		case HttpPhase_Wait:     return "Wait";
+		case HttpPhase_Download: return "Download";
+		default: return UNKNOWN_STR;
+	}
+}
+
+#define HTTP_PHASE_UNKNOWN UINT64_MAX
+
+// Phase i runs from the last observed point before it up to point i+1, so time spent in a phase we couldn't
+// observe gets folded into the next phase we could, rather than being lost. Unobserved phases get HTTP_PHASE_UNKNOWN
+SYS_HELPER_DEF void GetHttpPhaseDurations(const HttpTimings* timings, u64* durationsOut)
+{
+	NotNull(timings);
+	NotNull(durationsOut);
+	u64 points[HttpPhase_Count+1] = {
+		timings->queuedUs, timings->startUs,
+		timings->dnsEndUs, timings->connectEndUs, timings->tlsEndUs,
+		timings->requestSentUs, timings->firstByteUs, timings->finishUs,
+	};
+	u64 prevPointUs = points[0];
+	for (uxx pIndex = 0; pIndex < HttpPhase_Count; pIndex++)
+	{
+		u64 pointUs = points[pIndex+1];
+		if (pointUs == 0 || prevPointUs == 0) { durationsOut[pIndex] = HTTP_PHASE_UNKNOWN; }
+		else { durationsOut[pIndex] = (pointUs > prevPointUs) ? (pointUs - prevPointUs) : 0; }
+		if (pointUs != 0) { prevPointUs = pointUs; }
+	}
+}
+
+#if BUILD_WITH_HTTP
+// All measured from when the request leaves its host queue (HttpTimings.startUs), 0 means no limit
+// PigCore's HttpRequestManager reports nothing between starting a request and finishing it, so on Windows only totalUs is enforced
+typedef plex HttpTimeouts HttpTimeouts;
+plex HttpTimeouts
+{
+	u64 connectUs; //until the connection is ready to send on (DNS, TCP and TLS)
+	u64 firstByteUs; //until the first response byte
+	u64 idleUs; //longest gap between response bytes once they've started
+	u64 totalUs; //until the whole response is in
+};
+
+// Why the HttpService gave up on a request itself, rather than the request failing on its own
+typedef enum HttpAbortReason HttpAbortReason;
+enum HttpAbortReason
+{
+	HttpAbortReason_None = 0,
+	HttpAbortReason_Canceled, //CancelHttpRequest
+	HttpAbortReason_ConnectTimeout,
+	HttpAbortReason_FirstByteTimeout,
+	HttpAbortReason_IdleTimeout,
+	HttpAbortReason_TotalTimeout,
+	HttpAbortReason_Count,
 };
+SYS_HELPER_DEF const char* GetHttpAbortReasonStr(HttpAbortReason enumValue)
+{
+	switch (enumValue)
+	{
+		case HttpAbortReason_None:             return "None";
+		case HttpAbortReason_Canceled:         return "Canceled";
+		case HttpAbortReason_ConnectTimeout:   return "ConnectTimeout";
+		case HttpAbortReason_FirstByteTimeout: return "FirstByteTimeout";
+		case HttpAbortReason_IdleTimeout:      return "IdleTimeout";
+		case HttpAbortReason_TotalTimeout:     return "TotalTimeout";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Extra per-request knobs that don't belong in PigCore's HttpRequestArgs
+typedef plex HttpRequestOptions HttpRequestOptions;
+plex HttpRequestOptions
+{
+	bool discardResponseBytes; //no Data events are sent and the Finished event has empty bytes, only totalBytes is filled out
+	u64 notBeforeUs; //SysGetTimeUs() timestamp, the request waits in its host queue until this time (0 means as soon as possible)
+	//NOTE: When set, the body is written into this file on the HttpService thread as it arrives rather than being sent to the app.
+	// Data events carry no bytes (only totalBytes, at most every HTTP_DOWNLOAD_PROGRESS_INTERVAL) and the Finished event has downloadHash
+	// The HttpService makes its own copy, so the string only needs to live for the MakeHttpRequest call
+	Str8 downloadPath;
+	//NOTE: When set, this file is sent as the request body (instead of the contentItems) straight from disk, it's never read into memory
+	// on our side. Only the Linux backend can do this, on Windows the request fails with Result_NotImplemented
+	Str8 uploadPath;
+	HttpTimeouts timeouts;
+};
+
+// 64-bit FNV-1a, continued across calls so a body can be hashed piece by piece as it streams in
+#define HTTP_CONTENT_HASH_START 0xCBF29CE484222325ULL
+SYS_HELPER_DEF u64 UpdateHttpContentHash(u64 hash, Str8 bytes)
+{
+	for (uxx bIndex = 0; bIndex < bytes.length; bIndex++)
+	{
+		hash ^= (u64)(u8)bytes.chars[bIndex];
+		hash *= 0x00000100000001B3ULL;
+	}
+	return hash;
+}
+
+// The response's Content-Encoding. Gzip and Deflate bodies are decoded on the HttpService's decode thread
+// before the app ever sees them. We don't have a brotli decoder so we never ask for "br", but a server
+// that sends it anyways (or anything else) gets passed through untouched
+typedef enum HttpContentEncoding HttpContentEncoding;
+enum HttpContentEncoding
+{
+	HttpContentEncoding_None = 0,
+	HttpContentEncoding_Gzip,
+	HttpContentEncoding_Deflate,
+	HttpContentEncoding_Brotli,
+	HttpContentEncoding_Other,
+	HttpContentEncoding_Count,
+};
+SYS_HELPER_DEF const char* GetHttpContentEncodingStr(HttpContentEncoding enumValue)
+{
+	switch (enumValue)
+	{
+		case HttpContentEncoding_None:    return "None";
+		case HttpContentEncoding_Gzip:    return "Gzip";
+		case HttpContentEncoding_Deflate: return "Deflate";
+		case HttpContentEncoding_Brotli:  return "Brotli";
+		case HttpContentEncoding_Other:   return "Other";
+		default: return UNKNOWN_STR;
+	}
+}
+
+typedef enum HttpEventType HttpEventType;
+enum HttpEventType
+{
+	HttpEventType_None = 0,
+	HttpEventType_Data, //more response bytes arrived, the request is still running
+	HttpEventType_Finished,
+	HttpEventType_Count,
+};
+SYS_HELPER_DEF const char* GetHttpEventTypeStr(HttpEventType enumValue)
+{
+	switch (enumValue)
+	{
+		case HttpEventType_None:     return "None";
+		case HttpEventType_Data:     return "Data";
+		case HttpEventType_Finished: return "Finished";
+		default: return UNKNOWN_STR;
+	}
+}
+
+// Filled out on the HttpService thread, then handed to the app through PopHttpEvent. Each request
+// produces zero or more Data events followed by exactly one Finished event. Every event's bytes
+// are only the part of the response that arrived since the previous event for that request
+typedef plex HttpEvent HttpEvent;
+plex HttpEvent
+{
+	HttpEventType type;
+	u64 contextId; //the HttpRequestArgs.contextId that was passed to MakeHttpRequest
+	u64 httpId;
+	u64 timeUs; //SysGetTimeUs() when the service thread saw this, so it can be compared against timestamps taken on the app thread
+	uxx totalBytes; //response bytes received so far (counted even when discardResponseBytes is set). For a decoded body this counts decoded bytes
+	Str8 bytes;
+	
+	//NOTE: These are only filled out for Finished events
+	HttpRequestState state;
+	Result error;
+	u16 statusCode;
+	HttpTimings timings;
+	uxx numResponseHeaders;
+	Str8Pair* responseHeaders;
+	u64 downloadHash; //UpdateHttpContentHash of the whole body, only for requests with a downloadPath
+	HttpContentEncoding contentEncoding;
+	uxx encodedBytes; //body bytes as they came over the wire, the same as totalBytes unless the body was decoded
+	HttpAbortReason abortReason; //when set, error is Result_Failure and whatever body came before the abort was still delivered
+};
+#endif //BUILD_WITH_HTTP
 
 typedef struct AppInput AppInput;
 struct AppInput
@@ -41,12 +248,32 @@ struct AppInput
 	// v2i windowSize; //TODO: Can we somehow ask sokol_sapp for the window size (include title bar and border)?
 };
 
+// A read-only view of part of a file, see MapFile. The OS only maps from page (allocation granularity on Windows)
+// boundaries so mappedPntr/mappedSize can start a little before contents
+typedef plex FileMapping FileMapping;
+plex FileMapping
+{
+	bool isMapped;
+	Str8 contents;
+	u64 fileSize; //of the whole file, filled in even when nothing was mapped
+	void* mappedPntr;
+	uxx mappedSize;
+};
+
 // +--------------------------------------------------------------+
 // |                         Platform API                         |
 // +--------------------------------------------------------------+
 #define GET_NATIVE_WINDOW_HANDLE_DEF(functionName) OsWindowHandle functionName()
 typedef GET_NATIVE_WINDOW_HANDLE_DEF(GetNativeWindowHandle_f);
 
+// Maps size bytes starting at offset (size 0 maps through the end of the file). Pages are only read as they're touched.
+// Mapping an empty range succeeds with isMapped false, so this doubles as a cheap way to get a file's size
+#define MAP_FILE_DEF(functionName) bool functionName(FilePath path, u64 offset, uxx size, FileMapping* mappingOut)
+typedef MAP_FILE_DEF(MapFile_f);
+
+#define UNMAP_FILE_DEF(functionName) void functionName(FileMapping* mapping)
+typedef UNMAP_FILE_DEF(UnmapFile_f);
+
 #if BUILD_WITH_SOKOL_APP
 #define GET_SOKOL_SWAPCHAIN_DEF(functionName) sg_swapchain functionName()
 typedef GET_SOKOL_SWAPCHAIN_DEF(GetSokolSwapchain_f);
@@ -67,10 +294,28 @@ typedef SET_WINDOW_ICON_DEF(SetWindowIcon_f);
 typedef SET_CURSOR_SHAPE_DEF(SetCursorShape_f);
 #endif //BUILD_WITH_SOKOL_APP
 
+#if BUILD_WITH_HTTP
+#define MAKE_HTTP_REQUEST_DEF(functionName) u64 functionName(const HttpRequestArgs* args, const HttpRequestOptions* options)
+typedef MAKE_HTTP_REQUEST_DEF(MakeHttpRequest_f);
+
+#define POP_HTTP_EVENT_DEF(functionName) bool functionName(HttpEvent* eventOut)
+typedef POP_HTTP_EVENT_DEF(PopHttpEvent_f);
+
+#define FREE_HTTP_EVENT_DEF(functionName) void functionName(HttpEvent* event)
+typedef FREE_HTTP_EVENT_DEF(FreeHttpEvent_f);
+
+// Tears down the request's connection (or pulls it out of its queue) and frees its buffers. A Finished event with
+// HttpAbortReason_Canceled still comes through as usual. Does nothing if the request already finished
+#define CANCEL_HTTP_REQUEST_DEF(functionName) void functionName(u64 httpId)
+typedef CANCEL_HTTP_REQUEST_DEF(CancelHttpRequest_f);
+#endif //BUILD_WITH_HTTP
+
 typedef struct PlatformApi PlatformApi;
 struct PlatformApi
 {
 	GetNativeWindowHandle_f* GetNativeWindowHandle;
+	MapFile_f* MapFile;
+	UnmapFile_f* UnmapFile;
 	#if BUILD_WITH_SOKOL_APP
 	GetSokolSwapchain_f* GetSokolSwapchain;
 	SetMouseLocked_f* SetMouseLocked;
@@ -79,6 +324,12 @@ struct PlatformApi
 	SetWindowIcon_f* SetWindowIcon;
 	SetCursorShape_f* SetCursorShape;
 	#endif
+	#if BUILD_WITH_HTTP
+	MakeHttpRequest_f* MakeHttpRequest;
+	PopHttpEvent_f* PopHttpEvent;
+	FreeHttpEvent_f* FreeHttpEvent;
+	CancelHttpRequest_f* CancelHttpRequest;
+	#endif
 };
 
 // +--------------------------------------------------------------+
@@ -45,7 +45,13 @@ Description:
 // +--------------------------------------------------------------+
 // |                         Header Files                         |
 // +--------------------------------------------------------------+
+#include "sys_helpers.h"
+#include "latency_histogram.h"
 #include "platform_interface.h"
+#include "platform_http_linux.h"
+#include "platform_http_decode.h"
+#include "platform_http.h"
+#include "platform_headless.h"
 #include "platform_main.h"
 // TODO: Add header files here
 
@@ -66,6 +72,11 @@ ProgramArgs programArgs = ZEROED;
 // +--------------------------------------------------------------+
 // |                    Platform Source Files                     |
 // +--------------------------------------------------------------+
+#include "platform_http_uring.c"
+#include "platform_http_linux.c"
+#include "platform_http_decode.c"
+#include "platform_http.c"
+#include "platform_headless.c"
 #include "platform_api.c"
 // TODO: Add source files here
 
@@ -123,10 +134,6 @@ bool PlatDoUpdate(void)
 	bool renderedFrame = true;
 	//TODO: Check for dll changes, reload it!
 	
-	#if BUILD_WITH_HTTP
-	OsUpdateHttpRequestManager(&platformData->http, platformData->currentAppInput->programTime);
-	#endif
-	
 	//Swap which appInput is being written to and pass the static version to the application
 	AppInput* oldAppInput = platformData->currentAppInput;
 	AppInput* newAppInput = (platformData->currentAppInput == &platformData->appInputs[0]) ? &platformData->appInputs[1] : &platformData->appInputs[0];
@@ -164,10 +171,6 @@ bool PlatDoUpdate(void)
 	
 	renderedFrame = platformData->appApi.AppUpdate(platformInfo, platform, platformData->appMemoryPntr, oldAppInput);
 	
-	#if BUILD_WITH_HTTP
-	OsUpdateHttpRequestManager(&platformData->http, platformData->currentAppInput->programTime);
-	#endif
-	
 	TracyCZoneEnd(Zone_Func);
 	return renderedFrame;
 }
@@ -207,16 +210,18 @@ int main()
 	ClearPointer(platformInfo);
 	platformInfo->platformStdHeap = stdHeap;
 	platformInfo->platformStdHeapAllowFreeWithoutSize = &platformData->stdHeapAllowFreeWithoutSize;
+	platformInfo->historyMemoryBudget = platformData->historyMemoryBudget;
 	
 	#if BUILD_WITH_HTTP
-	OsInitHttpRequestManager(stdHeap, &platformData->http);
-	platformInfo->http = &platformData->http;
+	InitHttpService(&platformData->httpService, platformData->httpMaxRunning, platformData->httpMaxRunningPerHost, platformData->httpPreferIoUring);
 	#endif
 	
 	platform = AllocType(PlatformApi, stdHeap);
 	NotNull(platform);
 	ClearPointer(platform);
 	platform->GetNativeWindowHandle = Plat_GetNativeWindowHandle;
+	platform->MapFile = Plat_MapFile;
+	platform->UnmapFile = Plat_UnmapFile;
 	#if BUILD_WITH_SOKOL_APP
 	platform->GetSokolSwapchain = Plat_GetSokolSwapchain;
 	platform->SetMouseLocked = Plat_SetMouseLocked;
@@ -225,6 +230,12 @@ int main()
 	platform->SetWindowIcon = Plat_SetWindowIcon;
 	platform->SetCursorShape = Plat_SetCursorShape;
 	#endif
+	#if BUILD_WITH_HTTP
+	platform->MakeHttpRequest = Plat_MakeHttpRequest;
+	platform->PopHttpEvent = Plat_PopHttpEvent;
+	platform->FreeHttpEvent = Plat_FreeHttpEvent;
+	platform->CancelHttpRequest = Plat_CancelHttpRequest;
+	#endif
 	
 	#if BUILD_INTO_SINGLE_UNIT
 	{
@@ -327,7 +338,7 @@ void PlatSappCleanup(void)
 	platformData->appApi.AppClosing(platformInfo, platform, platformData->appMemoryPntr);
 	ShutdownSokolGraphics();
 	#if BUILD_WITH_HTTP
-	OsFreeHttpRequestManager(&platformData->http);
+	FreeHttpService(&platformData->httpService);
 	#endif
 }
 
@@ -455,6 +466,36 @@ sapp_desc sokol_main(int argc, char* argv[])
 	if (windowSize.width < MIN_WINDOW_SIZE.width) { windowSize.width = MIN_WINDOW_SIZE.width; }
 	if (windowSize.height < MIN_WINDOW_SIZE.height) { windowSize.height = MIN_WINDOW_SIZE.height; }
 	
+	platformData->historyMemoryBudget = HISTORY_DEFAULT_MEMORY_BUDGET;
+	Str8 historyMemoryStr = FindNamedProgramArgStr(&programArgs, StrLit("historyMemory"), Str8_Empty, Str8_Empty);
+	if (!IsEmptyStr(historyMemoryStr))
+	{
+		uxx budgetMegabytes = 0;
+		if (TryParseUXX(historyMemoryStr, &budgetMegabytes, nullptr)) { platformData->historyMemoryBudget = Megabytes(budgetMegabytes); }
+		else { PrintLine_W("Invalid historyMemory \"%.*s\"", StrPrint(historyMemoryStr)); }
+	}
+	
+	#if BUILD_WITH_HTTP
+	platformData->httpMaxRunning = HTTP_DEFAULT_MAX_RUNNING;
+	platformData->httpMaxRunningPerHost = HTTP_DEFAULT_MAX_RUNNING_PER_HOST;
+	Str8 maxRunningStr = FindNamedProgramArgStr(&programArgs, StrLit("maxRequests"), Str8_Empty, Str8_Empty);
+	if (!IsEmptyStr(maxRunningStr) && !TryParseUXX(maxRunningStr, &platformData->httpMaxRunning, nullptr)) { PrintLine_W("Invalid maxRequests \"%.*s\"", StrPrint(maxRunningStr)); }
+	Str8 maxPerHostStr = FindNamedProgramArgStr(&programArgs, StrLit("maxPerHost"), Str8_Empty, Str8_Empty);
+	if (!IsEmptyStr(maxPerHostStr) && !TryParseUXX(maxPerHostStr, &platformData->httpMaxRunningPerHost, nullptr)) { PrintLine_W("Invalid maxPerHost \"%.*s\"", StrPrint(maxPerHostStr)); }
+	if (platformData->httpMaxRunning == 0) { platformData->httpMaxRunning = 1; }
+	if (platformData->httpMaxRunningPerHost == 0) { platformData->httpMaxRunningPerHost = 1; }
+	Str8 httpIoStr = FindNamedProgramArgStr(&programArgs, StrLit("httpIo"), Str8_Empty, Str8_Empty);
+	if (StrAnyCaseEquals(httpIoStr, StrLit("uring"))) { platformData->httpPreferIoUring = true; }
+	else if (!IsEmptyStr(httpIoStr) && !StrAnyCaseEquals(httpIoStr, StrLit("epoll"))) { PrintLine_W("Invalid httpIo \"%.*s\", expected \"epoll\" or \"uring\"", StrPrint(httpIoStr)); }
+	
+	Str8 headlessStr = FindNamedProgramArgStr(&programArgs, StrLit("headless"), Str8_Empty, StrLit("false"));
+	if (!StrAnyCaseEquals(headlessStr, StrLit("false")))
+	{
+		//NOTE: No window, graphics, fonts or app dll. We run the requests and exit before sokol ever sees a sapp_desc
+		exit(RunHeadless());
+	}
+	#endif
+	
 	return NEW_STRUCT(sapp_desc){
 		.init_cb = PlatSappInit,
 		.frame_cb = PlatDoUpdate,
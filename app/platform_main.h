@@ -18,13 +18,17 @@ struct PlatformData
 	OsDll appDll;
 	#endif
 	void* appMemoryPntr;
+	uxx historyMemoryBudget;
 	
 	AppInput appInputs[2];
 	AppInput* oldAppInput;
 	AppInput* currentAppInput;
 	
 	#if BUILD_WITH_HTTP
-	HttpRequestManager http;
+	uxx httpMaxRunning;
+	uxx httpMaxRunningPerHost;
+	bool httpPreferIoUring; //--httpIo=uring, only means anything on Linux
+	HttpService httpService;
 	#endif
 };
 
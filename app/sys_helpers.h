@@ -0,0 +1,426 @@
+/*
+File:   sys_helpers.h
+Date:   10\16\2026
+Description:
+	** Holds a handful of thin OS wrappers (threads, high resolution time, etc.)
+	** that both the platform layer and the app need but PigCore doesn't expose yet.
+	** Everything lives in this header so it can be #included from both
+	** platform_main.c and app_main.c (the include guard keeps BUILD_INTO_SINGLE_UNIT happy)
+	** Functions defined in headers that both of those include are declared with SYS_HELPER_DEF
+	** so the platform executable and the app DLL each get their own private copy
+*/
+
+#ifndef _SYS_HELPERS_H
+#define _SYS_HELPERS_H
+
+#include <stdio.h>
+#if TARGET_IS_WINDOWS
+#include <io.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#define SYS_HELPER_DEF static inline
+
+// +--------------------------------------------------------------+
+// |                           Threads                            |
+// +--------------------------------------------------------------+
+#define SYS_THREAD_FUNC_DEF(functionName) void functionName(void* contextPntr)
+typedef SYS_THREAD_FUNC_DEF(SysThreadFunc_f);
+
+//NOTE: The SysThread must stay at a stable address while the thread is running
+typedef plex SysThread SysThread;
+plex SysThread
+{
+	bool isRunning;
+	SysThreadFunc_f* function;
+	void* contextPntr;
+	#if TARGET_IS_WINDOWS
+	HANDLE handle;
+	#else
+	pthread_t handle;
+	#endif
+};
+
+#if TARGET_IS_WINDOWS
+SYS_HELPER_DEF DWORD WINAPI SysThreadEntry(LPVOID parameter)
+{
+	SysThread* thread = (SysThread*)parameter;
+	thread->function(thread->contextPntr);
+	return 0;
+}
+#else
+SYS_HELPER_DEF void* SysThreadEntry(void* parameter)
+{
+	SysThread* thread = (SysThread*)parameter;
+	thread->function(thread->contextPntr);
+	return nullptr;
+}
+#endif
+
+SYS_HELPER_DEF bool SysStartThread(SysThread* thread, SysThreadFunc_f* function, void* contextPntr)
+{
+	NotNull(thread);
+	NotNull(function);
+	Assert(!thread->isRunning);
+	thread->function = function;
+	thread->contextPntr = contextPntr;
+	#if TARGET_IS_WINDOWS
+	thread->handle = CreateThread(nullptr, 0, SysThreadEntry, (LPVOID)thread, 0, nullptr);
+	thread->isRunning = (thread->handle != NULL);
+	#else
+	thread->isRunning = (pthread_create(&thread->handle, nullptr, SysThreadEntry, (void*)thread) == 0);
+	#endif
+	return thread->isRunning;
+}
+
+//NOTE: The caller is responsible for telling the thread to exit before calling this
+SYS_HELPER_DEF void SysJoinThread(SysThread* thread)
+{
+	NotNull(thread);
+	if (!thread->isRunning) { return; }
+	#if TARGET_IS_WINDOWS
+	WaitForSingleObject(thread->handle, INFINITE);
+	CloseHandle(thread->handle);
+	#else
+	pthread_join(thread->handle, nullptr);
+	#endif
+	thread->isRunning = false;
+}
+
+SYS_HELPER_DEF void SysSleepMs(u64 milliseconds)
+{
+	#if TARGET_IS_WINDOWS
+	Sleep((DWORD)milliseconds);
+	#else
+	usleep((useconds_t)(milliseconds * 1000));
+	#endif
+}
+
+// Logical cores, including hyperthreads. Always at least 1
+SYS_HELPER_DEF uxx SysGetNumCores()
+{
+	#if TARGET_IS_WINDOWS
+	SYSTEM_INFO systemInfo = ZEROED;
+	GetSystemInfo(&systemInfo);
+	return (systemInfo.dwNumberOfProcessors > 0) ? (uxx)systemInfo.dwNumberOfProcessors : 1;
+	#else
+	long numCores = sysconf(_SC_NPROCESSORS_ONLN);
+	return (numCores > 0) ? (uxx)numCores : 1;
+	#endif
+}
+
+// Returns the value from before the add
+SYS_HELPER_DEF u32 SysAtomicAddU32(volatile u32* value, u32 amount)
+{
+	#if defined(_MSC_VER)
+	return (u32)InterlockedExchangeAdd((volatile LONG*)value, (LONG)amount);
+	#else
+	return __atomic_fetch_add(value, amount, __ATOMIC_ACQ_REL);
+	#endif
+}
+
+SYS_HELPER_DEF u32 SysAtomicLoadU32(volatile u32* value)
+{
+	#if defined(_MSC_VER)
+	return (u32)InterlockedCompareExchange((volatile LONG*)value, 0, 0);
+	#else
+	return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+	#endif
+}
+
+// +--------------------------------------------------------------+
+// |                            Events                            |
+// +--------------------------------------------------------------+
+#define SYS_WAIT_FOREVER UINT64_MAX
+
+// An auto-reset event for waking a sleeping thread. Signals don't stack, any number of SysSignalEvent calls
+// before a wait just mean the next SysWaitEvent returns right away (and clears it)
+typedef plex SysEvent SysEvent;
+plex SysEvent
+{
+	bool initialized;
+	#if TARGET_IS_WINDOWS
+	HANDLE handle;
+	#else
+	pthread_mutex_t mutex;
+	pthread_cond_t condition;
+	bool isSignaled;
+	#endif
+};
+
+SYS_HELPER_DEF void SysInitEvent(SysEvent* event)
+{
+	NotNull(event);
+	ClearPointer(event);
+	#if TARGET_IS_WINDOWS
+	event->handle = CreateEventA(nullptr, FALSE, FALSE, nullptr);
+	NotNull(event->handle);
+	#else
+	pthread_mutex_init(&event->mutex, nullptr);
+	pthread_condattr_t conditionAttr;
+	pthread_condattr_init(&conditionAttr);
+	#if TARGET_IS_LINUX
+	pthread_condattr_setclock(&conditionAttr, CLOCK_MONOTONIC);
+	#endif
+	pthread_cond_init(&event->condition, &conditionAttr);
+	pthread_condattr_destroy(&conditionAttr);
+	#endif
+	event->initialized = true;
+}
+
+SYS_HELPER_DEF void SysFreeEvent(SysEvent* event)
+{
+	NotNull(event);
+	if (!event->initialized) { return; }
+	#if TARGET_IS_WINDOWS
+	CloseHandle(event->handle);
+	#else
+	pthread_cond_destroy(&event->condition);
+	pthread_mutex_destroy(&event->mutex);
+	#endif
+	ClearPointer(event);
+}
+
+// Safe to call from any thread
+SYS_HELPER_DEF void SysSignalEvent(SysEvent* event)
+{
+	NotNull(event);
+	#if TARGET_IS_WINDOWS
+	SetEvent(event->handle);
+	#else
+	pthread_mutex_lock(&event->mutex);
+	event->isSignaled = true;
+	pthread_cond_signal(&event->condition);
+	pthread_mutex_unlock(&event->mutex);
+	#endif
+}
+
+// Returns false if timeoutMs passed without the event being signaled
+SYS_HELPER_DEF bool SysWaitEvent(SysEvent* event, u64 timeoutMs)
+{
+	NotNull(event);
+	#if TARGET_IS_WINDOWS
+	DWORD waitMs = (timeoutMs == SYS_WAIT_FOREVER) ? INFINITE : ((timeoutMs < INFINITE) ? (DWORD)timeoutMs : INFINITE-1);
+	return (WaitForSingleObject(event->handle, waitMs) == WAIT_OBJECT_0);
+	#else
+	struct timespec deadline = ZEROED;
+	if (timeoutMs != SYS_WAIT_FOREVER)
+	{
+		#if TARGET_IS_LINUX
+		clock_gettime(CLOCK_MONOTONIC, &deadline);
+		#else
+		clock_gettime(CLOCK_REALTIME, &deadline);
+		#endif
+		u64 deadlineNs = (u64)deadline.tv_nsec + ((timeoutMs % 1000) * 1000000ULL);
+		deadline.tv_sec += (time_t)(timeoutMs / 1000) + (time_t)(deadlineNs / 1000000000ULL);
+		deadline.tv_nsec = (long)(deadlineNs % 1000000000ULL);
+	}
+	pthread_mutex_lock(&event->mutex);
+	while (!event->isSignaled)
+	{
+		if (timeoutMs == SYS_WAIT_FOREVER) { pthread_cond_wait(&event->condition, &event->mutex); }
+		else if (pthread_cond_timedwait(&event->condition, &event->mutex, &deadline) != 0) { break; }
+	}
+	bool result = event->isSignaled;
+	event->isSignaled = false;
+	pthread_mutex_unlock(&event->mutex);
+	return result;
+	#endif
+}
+
+// +--------------------------------------------------------------+
+// |                           Workers                            |
+// +--------------------------------------------------------------+
+// A long-lived thread that sleeps on wakeEvent whenever it runs out of work. The owner keeps the work itself (under
+// its own mutex) and calls SysWakeWorker after handing some over. The thread's loop is always the same shape:
+//   while (!SysIsWorkerStopping(worker)) { take work under the owner's mutex; if there was none, SysWorkerWait and continue; do it }
+//NOTE: The SysWorker must stay at a stable address while the thread is running
+typedef plex SysWorker SysWorker;
+plex SysWorker
+{
+	SysThread thread;
+	SysEvent wakeEvent;
+	volatile u32 stopRequested;
+};
+
+SYS_HELPER_DEF bool SysStartWorker(SysWorker* worker, SysThreadFunc_f* function, void* contextPntr)
+{
+	NotNull(worker);
+	ClearPointer(worker);
+	SysInitEvent(&worker->wakeEvent);
+	return SysStartThread(&worker->thread, function, contextPntr);
+}
+
+SYS_HELPER_DEF bool SysIsWorkerStopping(SysWorker* worker)
+{
+	NotNull(worker);
+	return (SysAtomicLoadU32(&worker->stopRequested) != 0);
+}
+
+// Safe to call from any thread. A wake that comes before the worker goes to sleep isn't lost, its next SysWorkerWait returns right away
+SYS_HELPER_DEF void SysWakeWorker(SysWorker* worker)
+{
+	NotNull(worker);
+	SysSignalEvent(&worker->wakeEvent);
+}
+
+// Only called from the worker's own thread. timeoutMs is for workers that also have something to poll (use SYS_WAIT_FOREVER otherwise)
+SYS_HELPER_DEF void SysWorkerWait(SysWorker* worker, u64 timeoutMs)
+{
+	NotNull(worker);
+	if (SysIsWorkerStopping(worker)) { return; }
+	SysWaitEvent(&worker->wakeEvent, timeoutMs);
+}
+
+// For workers that sleep on something other than wakeEvent (see HttpServiceThreadMain), so they can be woken their own way before SysStopWorker
+SYS_HELPER_DEF void SysRequestWorkerStop(SysWorker* worker)
+{
+	NotNull(worker);
+	SysAtomicAddU32(&worker->stopRequested, 1);
+	SysWakeWorker(worker);
+}
+
+// Blocks until the worker's thread exits. Anything it still had queued is left for the caller to free
+SYS_HELPER_DEF void SysStopWorker(SysWorker* worker)
+{
+	NotNull(worker);
+	SysRequestWorkerStop(worker);
+	SysJoinThread(&worker->thread);
+	SysFreeEvent(&worker->wakeEvent);
+}
+
+// +--------------------------------------------------------------+
+// |                         Parallel For                         |
+// +--------------------------------------------------------------+
+#define SYS_PARALLEL_MAX_WORKERS 32
+
+// workerIndex is the same for every job a given thread runs, so it can be used to index per-worker state (like arenas)
+#define SYS_PARALLEL_JOB_DEF(functionName) void functionName(void* contextPntr, uxx workerIndex, uxx jobIndex)
+typedef SYS_PARALLEL_JOB_DEF(SysParallelJob_f);
+
+typedef plex SysParallelRun SysParallelRun;
+plex SysParallelRun
+{
+	SysParallelJob_f* job;
+	void* contextPntr;
+	u32 numJobs;
+	volatile u32 nextJobIndex;
+};
+
+typedef plex SysParallelWorker SysParallelWorker;
+plex SysParallelWorker
+{
+	SysParallelRun* run;
+	uxx workerIndex;
+	SysThread thread;
+};
+
+SYS_HELPER_DEF void SysDoParallelJobs(SysParallelRun* run, uxx workerIndex)
+{
+	while (true)
+	{
+		u32 jobIndex = SysAtomicAddU32(&run->nextJobIndex, 1);
+		if (jobIndex >= run->numJobs) { break; }
+		run->job(run->contextPntr, workerIndex, (uxx)jobIndex);
+	}
+}
+
+// void SysParallelWorkerMain(void* contextPntr)
+SYS_HELPER_DEF SYS_THREAD_FUNC_DEF(SysParallelWorkerMain)
+{
+	SysParallelWorker* worker = (SysParallelWorker*)contextPntr;
+	//NOTE: These threads only live for one SysParallelFor, so they get a much smaller scratch space than our long running ones
+	InitScratchArenasVirtual(Megabytes(64));
+	SysDoParallelJobs(worker->run, worker->workerIndex);
+}
+
+// Runs job for every jobIndex in [0, numJobs) across numWorkers threads and returns once they've all finished. The calling
+// thread is worker 0 and the rest are started just for this call. Jobs are handed out in order as each worker frees up.
+// If a thread fails to start the others just pick up its share
+SYS_HELPER_DEF void SysParallelFor(uxx numWorkers, uxx numJobs, SysParallelJob_f* job, void* contextPntr)
+{
+	NotNull(job);
+	Assert(numJobs <= 0xFFFFFFFF);
+	SysParallelRun run = ZEROED;
+	run.job = job;
+	run.contextPntr = contextPntr;
+	run.numJobs = (u32)numJobs;
+	numWorkers = MaxUXX(1, MinUXX(MinUXX(numWorkers, numJobs), SYS_PARALLEL_MAX_WORKERS));
+	
+	SysParallelWorker workers[SYS_PARALLEL_MAX_WORKERS] = ZEROED;
+	for (uxx wIndex = 1; wIndex < numWorkers; wIndex++)
+	{
+		workers[wIndex].run = &run;
+		workers[wIndex].workerIndex = wIndex;
+		SysStartThread(&workers[wIndex].thread, SysParallelWorkerMain, (void*)&workers[wIndex]);
+	}
+	SysDoParallelJobs(&run, 0);
+	for (uxx wIndex = 1; wIndex < numWorkers; wIndex++) { SysJoinThread(&workers[wIndex].thread); }
+}
+
+// +--------------------------------------------------------------+
+// |                             Time                             |
+// +--------------------------------------------------------------+
+// Monotonic time in microseconds. Only differences between two values are meaningful
+SYS_HELPER_DEF u64 SysGetTimeUs()
+{
+	#if TARGET_IS_WINDOWS
+	static LARGE_INTEGER frequency = ZEROED;
+	if (frequency.QuadPart == 0) { QueryPerformanceFrequency(&frequency); }
+	LARGE_INTEGER counter = ZEROED;
+	QueryPerformanceCounter(&counter);
+	u64 wholeSeconds = (u64)(counter.QuadPart / frequency.QuadPart);
+	u64 remainder = (u64)(counter.QuadPart % frequency.QuadPart);
+	return (wholeSeconds * 1000000ULL) + ((remainder * 1000000ULL) / (u64)frequency.QuadPart);
+	#else
+	struct timespec timeSpec = ZEROED;
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return ((u64)timeSpec.tv_sec * 1000000ULL) + ((u64)timeSpec.tv_nsec / 1000ULL);
+	#endif
+}
+
+// +--------------------------------------------------------------+
+// |                            Files                             |
+// +--------------------------------------------------------------+
+#define SYS_MAX_PATH_LENGTH 4096
+
+// Writes contents to "<path>.tmp", flushes it all the way to disk and then renames it over path. Anyone reading path
+// (or a crash at any point) sees either the old file or the new one, never part of each. Newlines are written as-is
+SYS_HELPER_DEF bool SysWriteFileAtomic(Str8 path, Str8 contents)
+{
+	char pathNt[SYS_MAX_PATH_LENGTH];
+	char tempPathNt[SYS_MAX_PATH_LENGTH];
+	const char tempSuffix[] = ".tmp";
+	if (path.length + sizeof(tempSuffix) > SYS_MAX_PATH_LENGTH) { return false; }
+	memcpy(pathNt, path.chars, path.length);
+	pathNt[path.length] = '\0';
+	memcpy(tempPathNt, path.chars, path.length);
+	memcpy(&tempPathNt[path.length], tempSuffix, sizeof(tempSuffix));
+	
+	FILE* file = fopen(tempPathNt, "wb");
+	if (file == nullptr) { return false; }
+	bool result = (contents.length == 0 || fwrite(contents.chars, 1, contents.length, file) == contents.length);
+	if (result) { result = (fflush(file) == 0); }
+	#if TARGET_IS_WINDOWS
+	if (result) { result = (_commit(_fileno(file)) == 0); }
+	#else
+	if (result) { result = (fsync(fileno(file)) == 0); }
+	#endif
+	if (fclose(file) != 0) { result = false; }
+	
+	if (result)
+	{
+		#if TARGET_IS_WINDOWS
+		result = (MoveFileExA(tempPathNt, pathNt, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0);
+		#else
+		result = (rename(tempPathNt, pathNt) == 0);
+		#endif
+	}
+	if (!result) { remove(tempPathNt); }
+	return result;
+}
+
+#endif //  _SYS_HELPERS_H